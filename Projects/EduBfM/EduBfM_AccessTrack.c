@@ -0,0 +1,342 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_AccessTrack.c
+ *
+ * Description : 
+ *  Sampled page access tracking for pool sizing (see edubfm_AccessTrack.c):
+ *  predicted hit ratios of hypothetical pool sizes, the working set size
+ *  for a target hit ratio, and CSV dumps of the access heatmap and of the
+ *  miss ratio curve.
+ *
+ * Exports:
+ *  Four EduBfM_SetAccessSampling(double)
+ *  Four EduBfM_PredictHitRatio(VolNo, Four, double *)
+ *  Four EduBfM_GetMissRatioCurve(VolNo, BfMMrcPoint *, Four, Four)
+ *  Four EduBfM_GetWorkingSetSize(VolNo, double, Four *)
+ *  Four EduBfM_DumpHeatmap(char *)
+ *  Four EduBfM_DumpMissRatioCurve(char *, Four, Four)
+ */
+
+
+#include <stdio.h>
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * EduBfM_SetAccessSampling()
+ *================================*/
+/*
+ * Function: Four EduBfM_SetAccessSampling(double)
+ *
+ * Description : 
+ *  Start tracking page accesses with the sampling rate 'rate', i.e. the
+ *  fraction of the pages whose accesses are tracked; 0 stops tracking.
+ *  Accesses tracked so far are forgotten.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - bad sampling rate
+ */
+Four EduBfM_SetAccessSampling(
+    double		rate)			/* IN sampling rate in [0, 1] */
+{
+
+    if (rate < 0.0 || rate > 1.0) ERR(eBADPARAMETER_EDUBFM);
+
+    edubfm_ResetTrackers();
+
+    edubfm_mrcThreshold = (UFour)(rate * MRC_MODULUS + 0.5);
+    if (rate > 0.0 && edubfm_mrcThreshold == 0) edubfm_mrcThreshold = 1;
+
+    return( eNOERROR );
+
+}  /* EduBfM_SetAccessSampling() */
+
+
+
+/*@================================
+ * EduBfM_PredictHitRatio()
+ *================================*/
+/*
+ * Function: Four EduBfM_PredictHitRatio(VolNo, Four, double*)
+ *
+ * Description : 
+ *  Predict the hit ratio of the accesses to the volume 'volNo' for an LRU
+ *  pool of 'nBufs' buffers.
+ *
+ * Returns:
+ *  error code
+ *    eNOTTRACKED_EDUBFM - the accesses to the volume are not tracked
+ *    eBADPARAMETER_EDUBFM - bad parameter
+ *
+ * Side effects:
+ *  1) parameter hitRatio
+ *     the predicted hit ratio
+ */
+Four EduBfM_PredictHitRatio(
+    VolNo		volNo,			/* IN volume */
+    Four		nBufs,			/* IN pool size in buffers */
+    double		*hitRatio)		/* OUT predicted hit ratio */
+{
+    BfMAccessTracker	*t;		/* tracking state of the volume */
+
+
+    if (hitRatio == NULL || nBufs < 0) ERR(eBADPARAMETER_EDUBFM);
+
+    t = edubfm_LookUpTracker(volNo);
+    if (t == NULL) ERR(eNOTTRACKED_EDUBFM);
+
+    *hitRatio = edubfm_MrcHitRatio(t, nBufs);
+
+    return( eNOERROR );
+
+}  /* EduBfM_PredictHitRatio() */
+
+
+
+/*@================================
+ * EduBfM_GetMissRatioCurve()
+ *================================*/
+/*
+ * Function: Four EduBfM_GetMissRatioCurve(VolNo, BfMMrcPoint*, Four, Four)
+ *
+ * Description : 
+ *  Return 'nPoints' points of the predicted hit ratio curve of the volume
+ *  'volNo' for the pool sizes step, 2*step, ..., nPoints*step.
+ *
+ * Returns:
+ *  error code
+ *    eNOTTRACKED_EDUBFM - the accesses to the volume are not tracked
+ *    eBADPARAMETER_EDUBFM - bad parameter
+ *
+ * Side effects:
+ *  1) parameter points
+ *     the points of the curve
+ */
+Four EduBfM_GetMissRatioCurve(
+    VolNo		volNo,			/* IN volume */
+    BfMMrcPoint		*points,	/* OUT points of the curve */
+    Four		nPoints,		/* IN # of points */
+    Four		step)			/* IN distance of the points in buffers */
+{
+    Four		i;
+    BfMAccessTracker	*t;		/* tracking state of the volume */
+
+
+    if (points == NULL || nPoints < 0 || step < 1) ERR(eBADPARAMETER_EDUBFM);
+
+    t = edubfm_LookUpTracker(volNo);
+    if (t == NULL) ERR(eNOTTRACKED_EDUBFM);
+
+    for (i = 0; i < nPoints; i++) {
+        points[i].nBufs = (i + 1) * step;
+        points[i].hitRatio = edubfm_MrcHitRatio(t, points[i].nBufs);
+    }
+
+    return( eNOERROR );
+
+}  /* EduBfM_GetMissRatioCurve() */
+
+
+
+/*@================================
+ * EduBfM_GetWorkingSetSize()
+ *================================*/
+/*
+ * Function: Four EduBfM_GetWorkingSetSize(VolNo, double, Four*)
+ *
+ * Description : 
+ *  Return the smallest pool size predicted to reach the hit ratio
+ *  'target' for the accesses to the volume 'volNo'.
+ *
+ * Returns:
+ *  error code
+ *    eNOTTRACKED_EDUBFM - the accesses to the volume are not tracked
+ *    eBADPARAMETER_EDUBFM - bad parameter
+ *
+ * Side effects:
+ *  1) parameter nBufs
+ *     the pool size in buffers; NIL if the target is not reached within
+ *     the distances tracked
+ */
+Four EduBfM_GetWorkingSetSize(
+    VolNo		volNo,			/* IN volume */
+    double		target,			/* IN target hit ratio */
+    Four		*nBufs)			/* OUT pool size in buffers */
+{
+    Four		lo, hi, mid;	/* range of the binary search */
+    BfMAccessTracker	*t;		/* tracking state of the volume */
+
+
+    if (nBufs == NULL || target < 0.0 || target > 1.0) ERR(eBADPARAMETER_EDUBFM);
+
+    t = edubfm_LookUpTracker(volNo);
+    if (t == NULL) ERR(eNOTTRACKED_EDUBFM);
+
+    /* the predicted hit ratio does not decrease with the pool size */
+    lo = 1;
+    hi = MRC_NUM_BINS * MRC_BIN_WIDTH;
+    if (edubfm_MrcHitRatio(t, hi) < target) {
+        *nBufs = NIL;
+        return( eNOERROR );
+    }
+
+    while (lo < hi) {
+        mid = (lo + hi) / 2;
+        if (edubfm_MrcHitRatio(t, mid) >= target) hi = mid;
+        else lo = mid + 1;
+    }
+    *nBufs = lo;
+
+    return( eNOERROR );
+
+}  /* EduBfM_GetWorkingSetSize() */
+
+
+
+/*@================================
+ * EduBfM_DumpHeatmap()
+ *================================*/
+/*
+ * Function: Four EduBfM_DumpHeatmap(char*)
+ *
+ * Description : 
+ *  Write the sampled pages of every tracked volume to the CSV file
+ *  'fileName', the most recently used first, with their access count and
+ *  the # of accesses to the volume since their last access.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - bad parameter
+ *    eFILEOPENERR_EDUBFM - the file cannot be written
+ */
+Four EduBfM_DumpHeatmap(
+    char		*fileName)		/* IN name of the CSV file */
+{
+    FILE		*fp;
+    Four		v;				/* index of a tracked volume */
+    Four		i;				/* index of an entry */
+    BfMAccessTracker	*t;		/* tracking state of a volume */
+
+
+    if (fileName == NULL) ERR(eBADPARAMETER_EDUBFM);
+
+    fp = fopen(fileName, "w");
+    if (fp == NULL) ERR(eFILEOPENERR_EDUBFM);
+
+    fprintf(fp, "volNo,pageNo,accesses,refsSinceLastAccess\n");
+    for (v = 0; v < MRC_MAX_VOLUMES; v++) {
+        t = &edubfm_trackers[v];
+        if (t->volNo == NIL) continue;
+
+        for (i = t->head; i != NIL; i = t->entries[i].next)
+            fprintf(fp, "%ld,%ld,%ld,%ld\n", (long)t->volNo, (long)t->entries[i].key.pageNo,
+                    (long)t->entries[i].nAccesses, (long)(t->nRefs - t->entries[i].lastAccess));
+    }
+
+    if (fclose(fp) != 0) ERR(eFILEOPENERR_EDUBFM);
+
+    return( eNOERROR );
+
+}  /* EduBfM_DumpHeatmap() */
+
+
+
+/*@================================
+ * EduBfM_DumpMissRatioCurve()
+ *================================*/
+/*
+ * Function: Four EduBfM_DumpMissRatioCurve(char*, Four, Four)
+ *
+ * Description : 
+ *  Write the predicted hit and miss ratios of every tracked volume for the
+ *  pool sizes step, 2*step, ..., up to 'maxBufs' to the CSV file 'fileName'.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - bad parameter
+ *    eFILEOPENERR_EDUBFM - the file cannot be written
+ */
+Four EduBfM_DumpMissRatioCurve(
+    char		*fileName,		/* IN name of the CSV file */
+    Four		maxBufs,		/* IN largest pool size */
+    Four		step)			/* IN distance of the pool sizes */
+{
+    FILE		*fp;
+    Four		v;				/* index of a tracked volume */
+    Four		n;				/* pool size */
+    double		hitRatio;		/* predicted hit ratio */
+    BfMAccessTracker	*t;		/* tracking state of a volume */
+
+
+    if (fileName == NULL || maxBufs < 1 || step < 1) ERR(eBADPARAMETER_EDUBFM);
+
+    fp = fopen(fileName, "w");
+    if (fp == NULL) ERR(eFILEOPENERR_EDUBFM);
+
+    fprintf(fp, "volNo,nBufs,hitRatio,missRatio,accesses,sampledAccesses\n");
+    for (v = 0; v < MRC_MAX_VOLUMES; v++) {
+        t = &edubfm_trackers[v];
+        if (t->volNo == NIL) continue;
+
+        for (n = step; n <= maxBufs; n += step) {
+            hitRatio = edubfm_MrcHitRatio(t, n);
+            fprintf(fp, "%ld,%ld,%.6f,%.6f,%ld,%ld\n", (long)t->volNo, (long)n,
+                    hitRatio, 1.0 - hitRatio, (long)t->nRefs, (long)t->nSampled);
+        }
+    }
+
+    if (fclose(fp) != 0) ERR(eFILEOPENERR_EDUBFM);
+
+    return( eNOERROR );
+
+}  /* EduBfM_DumpMissRatioCurve() */
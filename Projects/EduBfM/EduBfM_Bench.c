@@ -0,0 +1,523 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_Bench.c
+ *
+ * Description : 
+ *  Microbenchmark of EduBfM.
+ *  A pool of 1 page trains is registered as a size class and sized to a
+ *  fraction of a dataset of consecutive pages; the pool is then driven by
+ *  EduBfM_GetTrain()/EduBfM_SetDirty()/EduBfM_FreeTrain() with the access
+ *  patterns below, for several pool to dataset ratios and client counts.
+ *
+ *   uniform    every page equally likely
+ *   zipf       Zipfian with skew theta, hot pages scattered over the dataset
+ *   hotset     90% of the accesses to 10% of the pages
+ *   sequential one scan over the dataset, wrapping around
+ *   loop       repeated scans of the first half of the dataset
+ *
+ *  EduBfM has no latches, so clients are not threads: each client is a
+ *  task of EduBfM_RunTasks() and the clients overlap on the I/Os of the
+ *  emulated device. A single client calls EduBfM_GetTrain() directly.
+ *  The latency of an access is the host time of the calls plus the
+ *  emulated device time the access waited; the throughput counts both.
+ *  Finally the flush of a pool full of dirty pages is timed written in
+ *  place, through the double-write buffer a page at a time, and through
+ *  the double-write buffer in batches.
+ *
+ *  Usage: EduBfM_Bench [# of accesses] [# of dataset pages] [device profile] [zipf theta]
+ *         device profile: none, hdd, satassd or nvme
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include "EduBfM_common.h"
+#include "EduBfM.h"
+#include "EduBfM_TestModule.h"
+
+
+#define BENCH_DEFAULT_NACCESSES	20000
+#define BENCH_DEFAULT_NPAGES	2000
+#define BENCH_DEFAULT_THETA		0.99
+#define BENCH_FIRST_PAGE		100		/* first page of the dataset */
+#define BENCH_WRITE_PERCENT		10		/* % of the accesses which dirty the page */
+#define BENCH_MAX_CLIENTS		16
+#define BENCH_FLUSH_NPAGES		512		/* # of dirty pages flushed */
+#define BENCH_DWB_FILE			"bench.dwb"
+
+#define BENCH_UNIFORM			0
+#define BENCH_ZIPF				1
+#define BENCH_HOTSET			2
+#define BENCH_SEQUENTIAL		3
+#define BENCH_LOOP				4
+#define BENCH_NUM_WORKLOADS		5
+
+static char *benchWorkloadNames[BENCH_NUM_WORKLOADS] = { "uniform", "zipf", "hotset", "sequential", "loop" };
+static double benchRatios[] = { 0.05, 0.1, 0.25, 0.5 };
+static Four benchClients[] = { 1, 4, 16 };
+
+/* state of a run shared by the clients */
+typedef struct {
+	Four		workload;		/* BENCH_xxx */
+	Four		volNo;			/* volume of the dataset */
+	Four		nPages;			/* # of pages of the dataset */
+	Four		type;			/* buffer type of the pool */
+	Four		cursor;			/* position of the sequential and loop scans */
+	double		*zipfCdf;		/* cumulative distribution of the Zipfian ranks */
+	double		*latency;		/* latency of each access (usec) */
+	Four		nDone;			/* # of accesses done */
+} BenchRun;
+
+/* a client */
+typedef struct {
+	BenchRun	*run;
+	UFour		seed;			/* random source of the client */
+	Four		i;				/* # of accesses done by the client */
+	Four		n;				/* # of accesses to be done by the client */
+	TrainID		trainId;		/* train being accessed */
+	char		*buf;			/* buffer of the train */
+	double		wallStart;		/* host time at the issue of the access */
+	double		ioStart;		/* emulated time at the issue of the access */
+} BenchClient;
+
+
+/* time in seconds */
+static double benchNow(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+/* emulated device time in usec */
+static double benchIOClock(void)
+{
+	BfMIOStat	stat;
+
+	EduBfM_GetIOStat(&stat);
+	return stat.clock;
+}
+
+
+/* random number in [0, 1) */
+static double benchRandom(UFour *seed)
+{
+	*seed = *seed * 1103515245 + 12345;
+	return ((*seed >> 8) & 0xffffff) / (double)0x1000000;
+}
+
+
+/* cumulative distribution of the Zipfian ranks 1..n with skew theta */
+static double *benchZipfCdf(Four n, double theta)
+{
+	Four		i;
+	double		sum;
+	double		*cdf;
+
+	cdf = (double *)malloc(sizeof(double) * n);
+	if (cdf == NULL) return NULL;
+
+	for (sum = 0.0, i = 0; i < n; i++) cdf[i] = (sum += 1.0 / pow(i + 1, theta));
+	for (i = 0; i < n; i++) cdf[i] /= sum;
+
+	return cdf;
+}
+
+
+/* next page to be accessed */
+static PageNo benchNextPage(BenchRun *run, UFour *seed)
+{
+	Four		lo, hi, mid;
+	Four		rank;
+	double		u;
+
+	switch (run->workload) {
+	  case BENCH_ZIPF:
+		u = benchRandom(seed);
+		for (lo = 0, hi = run->nPages - 1; lo < hi; ) {
+			mid = (lo + hi) / 2;
+			if (run->zipfCdf[mid] < u) lo = mid + 1;
+			else hi = mid;
+		}
+		/* scatter the ranks over the dataset (7919 is prime to any dataset size used) */
+		rank = (Four)(((long)lo * 7919) % run->nPages);
+		return BENCH_FIRST_PAGE + rank;
+
+	  case BENCH_HOTSET:
+		if (benchRandom(seed) < 0.9)
+			return BENCH_FIRST_PAGE + (Four)(benchRandom(seed) * (run->nPages / 10));
+		return BENCH_FIRST_PAGE + (Four)(benchRandom(seed) * run->nPages);
+
+	  case BENCH_SEQUENTIAL:
+		return BENCH_FIRST_PAGE + (run->cursor++ % run->nPages);
+
+	  case BENCH_LOOP:
+		return BENCH_FIRST_PAGE + (run->cursor++ % (run->nPages / 2));
+
+	  default:
+		return BENCH_FIRST_PAGE + (Four)(benchRandom(seed) * run->nPages);
+	}
+}
+
+
+/* finish the access of a client whose train is fixed */
+static Four benchFinishAccess(BenchClient *c)
+{
+	Four		e;
+	BenchRun	*run = c->run;
+
+	if (benchRandom(&c->seed) * 100 < BENCH_WRITE_PERCENT) {
+		e = EduBfM_SetDirty(&c->trainId, run->type);
+		if (e < eNOERROR) ERR(e);
+	}
+
+	e = EduBfM_FreeTrain(&c->trainId, run->type);
+	if (e < eNOERROR) ERR(e);
+
+	run->latency[run->nDone++] =
+		(benchNow() - c->wallStart) * 1e6 + (benchIOClock() - c->ioStart);
+
+	return(eNOERROR);
+}
+
+
+/* body of a client task */
+static Four benchClientTask(BfMTask *t)
+{
+	Four		e;
+	BenchClient	*c = (BenchClient *)t->arg;
+
+	BFMTASK_BEGIN(t);
+
+	for (c->i = 0; c->i < c->n; c->i++) {
+		c->trainId.volNo = c->run->volNo;
+		c->trainId.pageNo = benchNextPage(c->run, &c->seed);
+		c->wallStart = benchNow();
+		c->ioStart = benchIOClock();
+
+		BFMTASK_GETTRAIN(t, &c->trainId, c->buf, c->run->type);
+
+		e = benchFinishAccess(c);
+		if (e < eNOERROR) return(e);
+	}
+
+	BFMTASK_END(t);
+}
+
+
+/* run 'nAccesses' accesses by 'nClients' clients */
+static Four benchRunClients(BenchRun *run, Four nAccesses, Four nClients)
+{
+	Four		e;
+	Four		i;
+	BenchClient	clients[BENCH_MAX_CLIENTS];
+	BfMTask		tasks[BENCH_MAX_CLIENTS];
+	BfMTask		*taskp[BENCH_MAX_CLIENTS];
+
+	for (i = 0; i < nClients; i++) {
+		clients[i].run = run;
+		clients[i].seed = 4711 + 31 * i + run->nDone;
+		clients[i].n = nAccesses / nClients + (i < nAccesses % nClients ? 1 : 0);
+
+		if (nClients == 1) {
+			for (clients[i].i = 0; clients[i].i < clients[i].n; clients[i].i++) {
+				clients[i].trainId.volNo = run->volNo;
+				clients[i].trainId.pageNo = benchNextPage(run, &clients[i].seed);
+				clients[i].wallStart = benchNow();
+				clients[i].ioStart = benchIOClock();
+
+				e = EduBfM_GetTrain(&clients[i].trainId, &clients[i].buf, run->type);
+				if (e < eNOERROR) ERR(e);
+
+				e = benchFinishAccess(&clients[i]);
+				if (e < eNOERROR) ERR(e);
+			}
+			return(eNOERROR);
+		}
+
+		tasks[i].body = benchClientTask;
+		tasks[i].arg = &clients[i];
+		tasks[i].state = BFMTASK_READY;
+		tasks[i].resumePoint = 0;
+		taskp[i] = &tasks[i];
+	}
+
+	return EduBfM_RunTasks(taskp, nClients);
+}
+
+
+static int benchCompare(const void *a, const void *b)
+{
+	double x = *(const double *)a, y = *(const double *)b;
+
+	return (x < y) ? -1 : (x > y);
+}
+
+
+/* one configuration: warm the pool up, then measure 'nAccesses' accesses */
+static Four benchRun(BenchRun *run, Four nAccesses, Four nClients, double ratio)
+{
+	Four		e;
+	Four		nBufs;			/* pool size */
+	double		start, elapsed;	/* host time */
+	double		ioStart, ioElapsed;	/* emulated device time */
+	BfMIOStat	io;				/* I/O statistics */
+	BfMSizeClassStat	before, after;	/* pool statistics */
+
+	nBufs = (Four)(run->nPages * ratio);
+	if (nBufs < nClients) nBufs = nClients;
+
+	/* empty the pool */
+	e = EduBfM_ResizeSizeClass(run->type, nBufs);
+	if (e < eNOERROR) ERR(e);
+
+	run->cursor = 0;
+	run->nDone = 0;
+	e = benchRunClients(run, nAccesses / 5, nClients);
+	if (e < eNOERROR) ERR(e);
+
+	e = EduBfM_ResetIOStat();
+	if (e < eNOERROR) ERR(e);
+	e = EduBfM_GetSizeClassStat(run->type, &before);
+	if (e < eNOERROR) ERR(e);
+
+	run->nDone = 0;
+	ioStart = benchIOClock();
+	start = benchNow();
+
+	e = benchRunClients(run, nAccesses, nClients);
+	if (e < eNOERROR) ERR(e);
+
+	elapsed = benchNow() - start;
+	ioElapsed = (benchIOClock() - ioStart) / 1e6;
+
+	EduBfM_GetIOStat(&io);
+	EduBfM_GetSizeClassStat(run->type, &after);
+	qsort(run->latency, run->nDone, sizeof(double), benchCompare);
+
+	printf("%-10s %5.2f %5ld %7ld %12.0f %9.2f %9.2f %7.2f%% %8ld %8ld\n",
+		   benchWorkloadNames[run->workload], ratio, (long)nClients, (long)nBufs,
+		   nAccesses / (elapsed + ioElapsed),
+		   run->latency[run->nDone / 2], run->latency[(Four)(run->nDone * 0.99)],
+		   100.0 * (after.nHits - before.nHits) / (after.nFixes - before.nFixes),
+		   (long)io.nReads, (long)io.nWrites);
+
+	return(eNOERROR);
+}
+
+
+/* flush a pool full of dirty pages: 0 in place, 1 double-write a page at a time, 2 double-write batched */
+static Four benchFlush(BenchRun *run, Four mode)
+{
+	Four		e;
+	Four		i;
+	char		*buf;
+	TrainID		trainId;
+	double		start, elapsed;	/* host time */
+	double		ioStart;		/* emulated device time */
+	BfMDwbStat	dwb;			/* double-write statistics */
+	static char	*modeNames[] = { "in place", "double-write, page at a time", "double-write, batched" };
+
+	e = EduBfM_ResizeSizeClass(run->type, BENCH_FLUSH_NPAGES);
+	if (e < eNOERROR) ERR(e);
+
+	e = EduBfM_EnableDoubleWrite(mode == 0 ? NULL : BENCH_DWB_FILE);
+	if (e < eNOERROR) ERR(e);
+
+	trainId.volNo = run->volNo;
+	for (i = 0; i < BENCH_FLUSH_NPAGES; i++) {
+		trainId.pageNo = BENCH_FIRST_PAGE + i;
+		e = EduBfM_GetTrain(&trainId, &buf, run->type);
+		if (e < eNOERROR) ERR(e);
+		buf[i % PAGESIZE]++;
+		e = EduBfM_SetDirty(&trainId, run->type);
+		if (e < eNOERROR) ERR(e);
+		e = EduBfM_FreeTrain(&trainId, run->type);
+		if (e < eNOERROR) ERR(e);
+	}
+
+	ioStart = benchIOClock();
+	start = benchNow();
+
+	if (mode == 1) {
+		/* a train flushed by itself is a batch by itself */
+		for (i = 0; i < BENCH_FLUSH_NPAGES; i++) {
+			trainId.pageNo = BENCH_FIRST_PAGE + i;
+			e = edubfm_FlushTrain(&trainId, run->type);
+			if (e < eNOERROR) ERR(e);
+		}
+	}
+	else {
+		e = EduBfM_FlushAll();
+		if (e < eNOERROR) ERR(e);
+	}
+
+	elapsed = benchNow() - start;
+	EduBfM_GetDoubleWriteStat(&dwb);
+
+	printf("%-30s %10.2f %14.2f %8ld %8ld\n", modeNames[mode], elapsed * 1e3,
+		   (benchIOClock() - ioStart) / 1e3, (long)dwb.nBatches, (long)dwb.nSyncs);
+
+	return EduBfM_EnableDoubleWrite(NULL);
+}
+
+
+static Four EduBfM_Bench(Four volId, Four nAccesses, Four nPages, Four profile, double theta)
+{
+	Four		e;
+	Four		w, r, c;		/* loop indexes */
+	BenchRun	run;
+
+	e = EduBfM_SetIOProfile(profile, NULL);
+	if (e < eNOERROR) ERR(e);
+
+	run.volNo = volId;
+	run.nPages = nPages;
+	run.zipfCdf = benchZipfCdf(nPages, theta);
+	run.latency = (double *)malloc(sizeof(double) * nAccesses);
+	if (run.zipfCdf == NULL || run.latency == NULL) ERR(eMEMORYALLOCERR_EDUBFM);
+
+	run.type = EduBfM_RegisterSizeClass(1, 1);
+	if (run.type < eNOERROR) ERR(run.type);
+
+	printf("%ld accesses over %ld pages per run, %d%% writes, device %s, zipf theta %.2f\n\n",
+		   (long)nAccesses, (long)nPages, BENCH_WRITE_PERCENT, edubfm_ioProfile.name, theta);
+	printf("%-10s %5s %5s %7s %12s %9s %9s %8s %8s %8s\n",
+		   "workload", "ratio", "cli", "nBufs", "accesses/s", "p50(us)", "p99(us)", "hit", "reads", "writes");
+
+	for (w = 0; w < BENCH_NUM_WORKLOADS; w++) {
+		run.workload = w;
+		for (r = 0; r < sizeof(benchRatios) / sizeof(benchRatios[0]); r++)
+			for (c = 0; c < sizeof(benchClients) / sizeof(benchClients[0]); c++) {
+				e = benchRun(&run, nAccesses, benchClients[c], benchRatios[r]);
+				if (e < eNOERROR) ERR(e);
+			}
+	}
+
+	printf("\nflush of %d dirty pages\n", BENCH_FLUSH_NPAGES);
+	printf("%-30s %10s %14s %8s %8s\n", "mode", "host(ms)", "emulated(ms)", "batches", "syncs");
+	for (w = 0; w < 3; w++) {
+		e = benchFlush(&run, w);
+		if (e < eNOERROR) ERR(e);
+	}
+	unlink(BENCH_DWB_FILE);
+
+	free(run.zipfCdf);
+	free(run.latency);
+
+	return(eNOERROR);
+}
+
+
+Four main(int argc, char *argv[])
+{
+	Four	e;									/* for errors */
+	Four	i;									/* loop index */
+	Four	handle;								/* system handle */
+	char 	*devNames[MAX_DEVICES_IN_VOLUME];	/* device name */
+	Four 	volId;								/* volume identifier */
+	Four 	numPagesInDevices[MAX_DEVICES_IN_VOLUME];/* # of pages in the each devices */
+	XactID 	xactId;								/* transaction identifier */
+	Four	nAccesses = BENCH_DEFAULT_NACCESSES;/* # of accesses per run */
+	Four	nPages = BENCH_DEFAULT_NPAGES;		/* # of pages of the dataset */
+	Four	profile = IOEMUL_PROFILE_NVME;		/* emulated device */
+	double	theta = BENCH_DEFAULT_THETA;		/* skew of the Zipfian workload */
+
+	if (argc > 1) nAccesses = atol(argv[1]);
+	if (argc > 2) nPages = atol(argv[2]);
+	if (argc > 3) {
+		for (i = 0; i < IOEMUL_NUM_PROFILES; i++)
+			if (strcmp(argv[3], edubfm_ioProfiles[i].name) == 0) break;
+		if (i == IOEMUL_NUM_PROFILES) { printf("unknown device profile %s\n", argv[3]); exit(1); }
+		profile = i;
+	}
+	if (argc > 4) theta = atof(argv[4]);
+
+	e = LRDS_Init();
+	if (e < eNOERROR) { printf("LRDS_Init failed!!!\n"); exit(1); }
+
+	e = LRDS_AllocHandle(&handle);
+	if (e < eNOERROR) { printf("LRDS_AllocHandle failed!!!\n"); LRDS_Final(); exit(1); }
+
+	devNames[0] = "bench.vol";
+	volId = 1000;
+	numPagesInDevices[0] = BENCH_FIRST_PAGE + nPages + 16;
+
+	e = LRDS_FormatDataVolume(1, devNames, "bench", volId, 16, numPagesInDevices, 16);
+	if (e < eNOERROR) { printf("LRDS_FormatDataVolume failed!!!\n"); LRDS_FreeHandle(handle); LRDS_Final(); exit(1); }
+
+	e = LRDS_Mount(1, devNames, &volId);
+	if (e < eNOERROR) { printf("LRDS_Mount failed!!!\n"); LRDS_FreeHandle(handle); LRDS_Final(); exit(1); }
+
+	e = LRDS_BeginTransaction(&xactId, X_RR_RR);
+	if (e < eNOERROR) { LRDS_Dismount(volId); LRDS_FreeHandle(handle); LRDS_Final(); exit(1); }
+
+	e = EduBfM_Bench(volId, nAccesses, nPages, profile, theta);
+	if (e < eNOERROR) {
+		printf("EduBfM_Bench failed!!!\n");
+		LRDS_AbortTransaction(&xactId);
+		LRDS_Dismount(volId);
+		LRDS_FreeHandle(handle);
+		LRDS_Final();
+		exit(1);
+	}
+
+	LRDS_CommitTransaction(&xactId);
+	LRDS_Dismount(volId);
+	LRDS_FreeHandle(handle);
+	LRDS_Final();
+
+	return 0;
+}
@@ -0,0 +1,189 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_Checkpoint.c
+ *
+ * Description :
+ *  Control the incremental checkpointer and report the dirty page table.
+ *
+ * Exports:
+ *  Four EduBfM_SetCheckpointPolicy(Four, Four)
+ *  Four EduBfM_Checkpoint(Four)
+ *  Four EduBfM_GetDirtyPageTable(BfMDirtyPageEntry *, Four, Four *, Lsn_T *)
+ */
+
+
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * EduBfM_SetCheckpointPolicy()
+ *================================*/
+/*
+ * Function: Four EduBfM_SetCheckpointPolicy(Four, Four)
+ *
+ * Description :
+ *  Set the incremental checkpointer to write the 'nPagesPerStep' dirty pages
+ *  with the oldest recLSN every 'interval' calls of EduBfM_GetTrain().
+ *  An 'interval' of 0 turns the incremental checkpointer off.
+ *
+ * Returns:
+ *  error code
+ *    eBADCHECKPOINTPOLICY_EDUBFM - bad interval or # of pages per step
+ */
+Four EduBfM_SetCheckpointPolicy(
+    Four		interval,		/* IN # of accesses between checkpoint steps */
+    Four		nPagesPerStep)		/* IN # of pages written per checkpoint step */
+{
+
+    if (interval < 0 || nPagesPerStep < 1) ERR(eBADCHECKPOINTPOLICY_EDUBFM);
+
+    edubfm_checkpointPolicy.interval = interval;
+    edubfm_checkpointPolicy.nPagesPerStep = nPagesPerStep;
+
+    return( eNOERROR );
+
+}  /* EduBfM_SetCheckpointPolicy() */
+
+
+
+/*@================================
+ * EduBfM_Checkpoint()
+ *================================*/
+/*
+ * Function: Four EduBfM_Checkpoint(Four)
+ *
+ * Description :
+ *  Take one checkpoint step explicitly: write at most 'n' unfixed dirty
+ *  pages in the order of their recLSN, the oldest first.
+ *  Unlike EduBfM_FlushAll(), the caller is never blocked on the writes.
+ *
+ * Returns:
+ *  1) # of trains written
+ *  2) Error codes: Negative value means error code.
+ *     some errors caused by function calls
+ */
+Four EduBfM_Checkpoint(
+    Four		n)			/* IN maximum # of trains to be written */
+{
+    Four		e;			/* error code */
+
+
+    e = edubfm_CheckpointStep(n);
+    if (e < 0) ERR(e);
+
+    return( e );
+
+}  /* EduBfM_Checkpoint() */
+
+
+
+/*@================================
+ * EduBfM_GetDirtyPageTable()
+ *================================*/
+/*
+ * Function: Four EduBfM_GetDirtyPageTable(BfMDirtyPageEntry*, Four, Four*, Lsn_T*)
+ *
+ * Description :
+ *  Return the dirty page table, i.e. the dirty pages/trains with their
+ *  recLSN, as recorded in a fuzzy checkpoint. At most 'maxEntries' entries
+ *  are copied into 'entries' (which may be NULL); 'nEntries' is set to the
+ *  total # of dirty buffers. 'minRecLsn', if not NULL, is set to the
+ *  minimum recLSN, from where the redo would start; it is the zero LSN if
+ *  there is no dirty buffer.
+ *
+ * Returns:
+ *  error code
+ *    eBADBUFFER_BFM - 'nEntries' is NULL
+ *    some errors caused by function calls
+ */
+Four EduBfM_GetDirtyPageTable(
+    BfMDirtyPageEntry	*entries,		/* OUT dirty page table entries */
+    Four		maxEntries,		/* IN size of the array 'entries' */
+    Four		*nEntries,		/* OUT # of dirty buffers */
+    Lsn_T		*minRecLsn)		/* OUT minimum recLSN */
+{
+    Four		e;			/* error code */
+    Four		type;			/* buffer type */
+    Four		i;			/* index of a buffer element */
+    Lsn_T		minLsn;			/* minimum recLSN so far */
+
+
+    if (nEntries == NULL) ERR(eBADBUFFER_BFM);
+
+    e = edubfm_InitDirtyPageTable();
+    if (e < 0) ERR(e);
+
+    *nEntries = 0;
+    minLsn.offset = minLsn.wrapCount = 0;
+
+    for (type = PAGE_BUF; type < NUM_BUF_TYPES; type++) {
+        for (i = 0; i < BI_NBUFS(type); i++) {
+            if (!(BI_BITS(type, i) & DIRTY)) continue;
+
+            if (entries != NULL && *nEntries < maxEntries) {
+                entries[*nEntries].key = BI_KEY(type, i);
+                entries[*nEntries].type = type;
+                entries[*nEntries].recLsn = BI_RECLSN(type, i);
+            }
+
+            if (*nEntries == 0 || LSN_CMP(BI_RECLSN(type, i), minLsn) < 0)
+                minLsn = BI_RECLSN(type, i);
+
+            (*nEntries)++;
+        }
+    }
+
+    if (minRecLsn != NULL) *minRecLsn = minLsn;
+
+    return( eNOERROR );
+
+}  /* EduBfM_GetDirtyPageTable() */
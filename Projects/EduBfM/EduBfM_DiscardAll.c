@@ -84,13 +84,14 @@ Four EduBfM_DiscardAll(void)
     Two 	i;			/* index */
     Four 	type;			/* buffer type */
 
-    for (type=PAGE_BUF;type<=LOT_LEAF_BUF;type++){
+    for (type=PAGE_BUF;type<NUM_BUF_TYPES;type++){
         for (i=0;i<BI_NBUFS(type);i++){
             SET_NILBFMHASHKEY(BI_KEY(type,i));
             BI_BITS(type,i)=ALL_0;
         }
     }
     edubfm_DeleteAll();
+    edubfm_ClearWriteQueue();
 
     return(eNOERROR);
 
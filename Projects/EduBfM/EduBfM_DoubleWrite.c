@@ -0,0 +1,303 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_DoubleWrite.c
+ *
+ * Description :
+ *  Enable the double-write buffer protecting pages against torn writes
+ *  (see edubfm_DoubleWrite.c) and repair torn pages after a crash.
+ *
+ * Exports:
+ *  Four EduBfM_EnableDoubleWrite(char *)
+ *  Four EduBfM_RecoverDoubleWrite(char *)
+ *  Four EduBfM_GetDoubleWriteStat(BfMDwbStat *)
+ */
+
+
+#define _GNU_SOURCE				/* for syncfs() */
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "EduBfM_common.h"
+#include "RDsM.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@ Internal Function Prototypes */
+static Boolean edubfm_DwbReadBatch(Four, char *);
+
+
+
+/*@================================
+ * EduBfM_EnableDoubleWrite()
+ *================================*/
+/*
+ * Function: Four EduBfM_EnableDoubleWrite(char*)
+ *
+ * Description :
+ *  Write pages through the double-write file 'path' from now on; NULL
+ *  disables the double-write buffer. The file is created if it does not
+ *  exist and must reside on the file system of the volumes. A double-write
+ *  file left by a crash must be recovered by EduBfM_RecoverDoubleWrite()
+ *  before it is enabled, since the first batch overwrites it.
+ *  The statistics are reset.
+ *
+ * Returns:
+ *  error code
+ *    eFILEOPENERR_EDUBFM - the file cannot be opened
+ *    eMEMORYALLOCERR_EDUBFM - no memory for the batch
+ *    some errors caused by function calls
+ */
+Four EduBfM_EnableDoubleWrite(
+    char		*path)			/* IN double-write file, NULL to disable */
+{
+    Four		e;				/* error code */
+    Four		fd;				/* double-write file */
+    char		*area;			/* memory of the batch */
+
+
+    if (edubfm_dwb.fd != NIL) {
+        e = edubfm_DwbFlush();
+        if (e < 0) ERR(e);
+
+        if (edubfm_dwb.unsynced) {
+            if (syncfs(edubfm_dwb.fd) < 0) ERR(eDWBIOERR_EDUBFM);
+            edubfm_dwbStat.nSyncs++;
+        }
+
+        close(edubfm_dwb.fd);
+        free(edubfm_dwb.area);
+        edubfm_dwb.fd = NIL;
+        edubfm_dwb.area = NULL;
+    }
+
+    memset(&edubfm_dwbStat, 0, sizeof(BfMDwbStat));
+
+    if (path == NULL) return( eNOERROR );
+
+    fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) ERR(eFILEOPENERR_EDUBFM);
+
+    area = (char *)calloc(1 + DWB_MAX_PAGES, PAGESIZE);
+    if (area == NULL) {
+        close(fd);
+        ERR(eMEMORYALLOCERR_EDUBFM);
+    }
+
+    edubfm_dwb.fd = fd;
+    edubfm_dwb.area = area;
+    edubfm_dwb.nPages = 0;
+    edubfm_dwb.nEntries = 0;
+    edubfm_dwb.sync = FALSE;
+    edubfm_dwb.unsynced = FALSE;
+
+    return( eNOERROR );
+
+}  /* EduBfM_EnableDoubleWrite() */
+
+
+
+/*@================================
+ * EduBfM_RecoverDoubleWrite()
+ *================================*/
+/*
+ * Function: Four EduBfM_RecoverDoubleWrite(char*)
+ *
+ * Description :
+ *  Repair the pages torn by a crash from the double-write file 'path'.
+ *  If the file holds a complete batch, i.e. its header and all its page
+ *  images pass their checksums, every page of the batch whose image on
+ *  the volume differs from the one in the file is written again from the
+ *  file. An incomplete batch means that the crash hit the write into the
+ *  double-write file, before any page of the batch was written in place,
+ *  so there is nothing to repair.
+ *  Must be called after the volumes are mounted and before their pages
+ *  are fixed.
+ *
+ * Returns:
+ *  1) # of pages repaired
+ *  2) Error codes: Negative value means error code.
+ *     eFILEOPENERR_EDUBFM - the file cannot be opened
+ *     eMEMORYALLOCERR_EDUBFM - no memory for the batch
+ *     some errors caused by function calls
+ */
+Four EduBfM_RecoverDoubleWrite(
+    char		*path)			/* IN double-write file */
+{
+    Four		e;				/* error code */
+    Four		i;				/* loop index */
+    Four		fd;				/* double-write file */
+    Four		nRepaired;		/* # of pages repaired */
+    char		*area;			/* header page followed by the page images */
+    char		*page;			/* image of a page on the volume */
+    BfMDwbHeader *header;		/* header of the batch */
+    TrainID		pid;			/* page to be checked */
+
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        if (errno == ENOENT) return( 0 );
+        ERR(eFILEOPENERR_EDUBFM);
+    }
+
+    area = (char *)malloc((size_t)PAGESIZE * (2 + DWB_MAX_PAGES));
+    if (area == NULL) {
+        close(fd);
+        ERR(eMEMORYALLOCERR_EDUBFM);
+    }
+    header = (BfMDwbHeader *)area;
+    page = area + (size_t)PAGESIZE * (1 + DWB_MAX_PAGES);
+
+    /*@ write again the pages which differ from their images in the batch */
+    nRepaired = 0;
+    e = eNOERROR;
+    if (edubfm_DwbReadBatch(fd, area)) {
+        for (i = 0; i < header->nPages; i++) {
+            pid.volNo = header->slots[i].volNo;
+            pid.pageNo = header->slots[i].pageNo;
+
+            e = RDsM_ReadTrain(&pid, page, 1);
+            if (e < 0) break;
+
+            if (edubfm_DwbChecksum(page, PAGESIZE) == header->slots[i].checksum) continue;
+
+            e = RDsM_WriteTrain(area + (size_t)PAGESIZE * (1 + i), &pid, 1);
+            if (e < 0) break;
+
+            nRepaired++;
+        }
+    }
+
+    free(area);
+    close(fd);
+    if (e < 0) ERR(e);
+
+    edubfm_dwbStat.nRepaired = nRepaired;
+
+    return( nRepaired );
+
+}  /* EduBfM_RecoverDoubleWrite() */
+
+
+
+/*@================================
+ * edubfm_DwbReadBatch()
+ *================================*/
+/*
+ * Function: Boolean edubfm_DwbReadBatch(Four, char*)
+ *
+ * Description :
+ *  Read the header and the page images of the batch in the double-write
+ *  file 'fd' into 'area' and check that the batch is complete, i.e. that
+ *  the header and every page image pass their checksums.
+ *
+ * Returns:
+ *  TRUE if the batch is complete
+ */
+static Boolean edubfm_DwbReadBatch(
+    Four		fd,				/* IN double-write file */
+    char		*area)			/* OUT header page followed by the page images */
+{
+    Four		i;				/* loop index */
+    UFour		checksum;		/* checksum of the header */
+    size_t		len;			/* # of bytes of the page images */
+    BfMDwbHeader *header = (BfMDwbHeader *)area;
+
+
+    if (pread(fd, area, PAGESIZE, 0) != PAGESIZE) return( FALSE );
+
+    checksum = header->checksum;
+    header->checksum = 0;
+    if (header->magic != DWB_MAGIC || header->nPages < 1 || header->nPages > DWB_MAX_PAGES ||
+        edubfm_DwbChecksum((char *)header, sizeof(BfMDwbHeader)) != checksum) return( FALSE );
+
+    len = (size_t)PAGESIZE * header->nPages;
+    if (pread(fd, area + PAGESIZE, len, PAGESIZE) != len) return( FALSE );
+
+    for (i = 0; i < header->nPages; i++)
+        if (edubfm_DwbChecksum(area + (size_t)PAGESIZE * (1 + i), PAGESIZE) != header->slots[i].checksum)
+            return( FALSE );
+
+    return( TRUE );
+
+}  /* edubfm_DwbReadBatch */
+
+
+
+/*@================================
+ * EduBfM_GetDoubleWriteStat()
+ *================================*/
+/*
+ * Function: Four EduBfM_GetDoubleWriteStat(BfMDwbStat*)
+ *
+ * Description :
+ *  Return the statistics of the double-write buffer.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - NULL output parameter
+ *
+ * Side effects:
+ *  1) parameter stat
+ *     statistics since the double-write buffer was last enabled
+ */
+Four EduBfM_GetDoubleWriteStat(
+    BfMDwbStat	*stat)			/* OUT statistics */
+{
+
+    if (stat == NULL) ERR(eBADPARAMETER_EDUBFM);
+
+    *stat = edubfm_dwbStat;
+
+    return( eNOERROR );
+
+}  /* EduBfM_GetDoubleWriteStat() */
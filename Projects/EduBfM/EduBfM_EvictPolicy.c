@@ -0,0 +1,166 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_EvictPolicy.c
+ *
+ * Description :
+ *  Select the eviction policy of the buffer manager and report
+ *  the eviction statistics.
+ *
+ * Exports:
+ *  Four EduBfM_SetEvictPolicy(Four, Four, Four)
+ *  Four EduBfM_GetEvictStat(BfMEvictStat *)
+ *  Four EduBfM_DrainWriteQueue(Four)
+ */
+
+
+#include <string.h>
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * EduBfM_SetEvictPolicy()
+ *================================*/
+/*
+ * Function: Four EduBfM_SetEvictPolicy(Four, Four, Four)
+ *
+ * Description :
+ *  Set the eviction policy used by edubfm_AllocTrain().
+ *  In EVICT_MODE_CLOCK, the first unreferenced unfixed buffer is selected
+ *  as the victim and is flushed synchronously if it is dirty.
+ *  In EVICT_MODE_CLEANFIRST, dirty candidates are skipped in favour of a
+ *  clean one and up to 'window' of them per allocation are put into the
+ *  write queue. The queue is drained off the allocation path: 'writeBehind'
+ *  queued trains are written by each step of the incremental checkpointer
+ *  (see EduBfM_SetCheckpointPolicy()), and the whole queue by
+ *  EduBfM_FlushAll() or EduBfM_DrainWriteQueue().
+ *  Switching the mode clears the eviction statistics.
+ *
+ * Returns:
+ *  error code
+ *    eBADEVICTPOLICY_EDUBFM - bad mode, window or write-behind count
+ */
+Four EduBfM_SetEvictPolicy(
+    Four		mode,			/* IN eviction mode */
+    Four		window,			/* IN # of dirty candidates queued per allocation */
+    Four		writeBehind)		/* IN # of queued writes issued per checkpoint step */
+{
+
+    if (mode != EVICT_MODE_CLOCK && mode != EVICT_MODE_CLEANFIRST) ERR(eBADEVICTPOLICY_EDUBFM);
+    if (window < 0 || writeBehind < 0) ERR(eBADEVICTPOLICY_EDUBFM);
+
+    if (edubfm_evictPolicy.mode != mode)
+        memset(&edubfm_evictStat, 0, sizeof(BfMEvictStat));
+
+    edubfm_evictPolicy.mode = mode;
+    edubfm_evictPolicy.window = window;
+    edubfm_evictPolicy.writeBehind = writeBehind;
+
+    return( eNOERROR );
+
+}  /* EduBfM_SetEvictPolicy() */
+
+
+
+/*@================================
+ * EduBfM_GetEvictStat()
+ *================================*/
+/*
+ * Function: Four EduBfM_GetEvictStat(BfMEvictStat*)
+ *
+ * Description :
+ *  Return the eviction statistics.
+ *
+ * Returns:
+ *  error code
+ *    eBADBUFFER_BFM - 'stat' is NULL
+ */
+Four EduBfM_GetEvictStat(
+    BfMEvictStat	*stat)			/* OUT eviction statistics */
+{
+
+    if (stat == NULL) ERR(eBADBUFFER_BFM);
+
+    *stat = edubfm_evictStat;
+
+    return( eNOERROR );
+
+}  /* EduBfM_GetEvictStat() */
+
+
+
+/*@================================
+ * EduBfM_DrainWriteQueue()
+ *================================*/
+/*
+ * Function: Four EduBfM_DrainWriteQueue(Four)
+ *
+ * Description :
+ *  Write at most 'n' trains queued by the clean-first eviction;
+ *  if 'n' is not positive, the whole write queue is drained.
+ *
+ * Returns:
+ *  1) # of trains written
+ *  2) Error codes: Negative value means error code.
+ *     some errors caused by function calls
+ */
+Four EduBfM_DrainWriteQueue(
+    Four		n)			/* IN maximum # of trains to be written */
+{
+    Four		e;			/* error code */
+
+
+    e = edubfm_DrainWriteQueue(n);
+    if (e < 0) ERR(e);
+
+    return( e );
+
+}  /* EduBfM_DrainWriteQueue() */
@@ -74,6 +74,9 @@
  *
  *  Flush dirty buffers holding trains.
  *  A dirty buffer is one with the dirty bit set.
+ *  The write queue of the clean-first eviction is drained first.
+ *  The buffers are written through the double-write buffer as one batch.
+ *  In the pin debugging mode the outstanding pins are printed.
  *
  * Returns:
  *  error code
@@ -86,7 +89,14 @@ Four EduBfM_FlushAll(void)
     Four        type;                   /* buffer type */
     TrainID     trainId;
 
-    for (type=PAGE_BUF;type<=LOT_LEAF_BUF;type++){
+    PIN_DEBUG_DUMP("EduBfM_FlushAll");
+
+    e = edubfm_DrainWriteQueue(0);
+    if(e < 0) ERR(e);
+
+    edubfm_DwbBegin();
+
+    for (type=PAGE_BUF;type<NUM_BUF_TYPES;type++){
         for (i=0;i<BI_NBUFS(type);i++){
             if(BI_BITS(type,i)&DIRTY){
                 trainId.pageNo=BI_KEY(type,i).pageNo;
@@ -96,6 +106,9 @@ Four EduBfM_FlushAll(void)
         }
     }
 
+    e = edubfm_DwbEnd();
+    if(e < 0) ERR(e);
+
     return( eNOERROR );
     
 }  /* EduBfM_FlushAll() */
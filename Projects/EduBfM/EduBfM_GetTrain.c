@@ -57,8 +57,9 @@
  */
 
 
+#define EDUBFM_PIN_NOWRAP
 #include "EduBfM_common.h"
-#include "EduBfM_Internal.h"
+#include "EduBfM.h"
 
 
 
@@ -80,6 +81,8 @@
  *  pool, allocate a buffer (a buffer selected as victim may be forced out
  *  by the buffer replacement algorithm), read a disk train into the 
  *  selected buffer train, and return it.
+ *  The work is done by EduBfM_GetTrainAsync(); this function waits for the
+ *  read it may have issued.
  *
  * Returns:
  *  error code
@@ -96,15 +99,8 @@ Four EduBfM_GetTrain(
     char                **retBuf,               /* OUT pointer to the returned buffer */
     Four                type )                  /* IN buffer type */
 {
-	/* These local variables are used in the solution code. However, you don��t have to use all these variables in your code, and you may also declare and use additional local variables if needed. */
     Four                e;                      /* for error */
-    Four                index;                  /* index of the buffer pool */
-    
-    Four  		hashval;
-    Four		arrayidx;
-    Four 		newindex;
-    BfMHashKey		hashkey;
-    //char 		*bufelem;
+    BfMGetTrainReq      req;                    /* request for the train */
 
     /*@ Check the validity of given parameters */
     /* Some restrictions may be added         */
@@ -113,27 +109,14 @@ Four EduBfM_GetTrain(
     /* Is the buffer type valid? */
     if(IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);	
 
-    hashkey.volNo=trainId->volNo;
-    hashkey.pageNo=trainId->pageNo;
+    /* Issue the request and wait for the train to arrive */
+    e = EduBfM_GetTrainAsync(&req, trainId, type);
+    if(e < 0) ERR(e);
 
-    arrayidx=edubfm_LookUp(&hashkey,type);
+    e = EduBfM_WaitTrain(&req);
+    if(e < 0) ERR(e);
 
-   if(arrayidx!=-1){
-	    BI_FIXED(type,arrayidx)++;
-        BI_BITS(type,arrayidx)|=REFER;
-        *retBuf=BI_BUFFER(type,arrayidx);
-        return(eNOERROR);
-    }
-
-    char * newbuf;
-	newindex = edubfm_AllocTrain(type);
-	edubfm_ReadTrain(trainId,BI_BUFFER(type,newindex),type);
-	BI_KEY(type,newindex)=hashkey;
-	BI_FIXED(type,newindex)=1;
-	BI_BITS(type,newindex)|=REFER;
-
-	edubfm_Insert(&hashkey,newindex,type);
-    *retBuf=BI_BUFFER(type,newindex);
+    *retBuf = req.buf;
 
     return(eNOERROR);   /* No error */
 
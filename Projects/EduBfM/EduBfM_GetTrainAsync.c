@@ -0,0 +1,214 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_GetTrainAsync.c
+ *
+ * Description : 
+ *  Request a train without waiting for its disk read.
+ *  The buffer is allocated and fixed at once, but the read completes at a
+ *  later time of the virtual clock of the I/O emulation; in the meantime the
+ *  caller may issue other requests so that their reads overlap on the
+ *  emulated device.
+ *
+ * Exports:
+ *  Four EduBfM_GetTrainAsync(BfMGetTrainReq *, TrainID *, Four)
+ *  Boolean EduBfM_PollTrain(BfMGetTrainReq *)
+ *  Four EduBfM_WaitTrain(BfMGetTrainReq *)
+ */
+
+
+#define EDUBFM_PIN_NOWRAP
+#include "EduBfM_common.h"
+#include "EduBfM.h"
+
+
+
+/*@================================
+ * EduBfM_GetTrainAsync()
+ *================================*/
+/*
+ * Function: Four EduBfM_GetTrainAsync(BfMGetTrainReq*, TrainID*, Four)
+ *
+ * Description : 
+ *  Start fixing the train 'trainId' in the buffer pool 'type'.
+ *  The train is looked up in the buffer pool; on a miss a buffer is
+ *  allocated and the read is issued without waiting for it. Either way the
+ *  buffer is fixed and the request remembers when its contents are valid.
+ *  A hit on a buffer whose read is still pending gets the pending
+ *  completion time.
+ *  The buffer must be freed by EduBfM_FreeTrain() as with EduBfM_GetTrain().
+ *
+ * Returns:
+ *  error code
+ *    eBADBUFFER_BFM - Invalid Buffer
+ *    eBADBUFFERTYPE_BFM - Invalid Buffer type
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  1) parameter req
+ *     the request describing the fixed buffer
+ */
+Four EduBfM_GetTrainAsync(
+    BfMGetTrainReq      *req,                   /* OUT request to be filled */
+    TrainID             *trainId,               /* IN train to be used */
+    Four                type )                  /* IN buffer type */
+{
+    Four                e;                      /* for error */
+    Four                index;                  /* index of the buffer pool */
+    BfMHashKey          hashkey;                /* hash key of the train */
+
+
+    /*@ Check the validity of given parameters */
+    if(req == NULL) ERR(eBADBUFFER_BFM);
+
+    /* Is the buffer type valid? */
+    if(IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);
+
+    e = edubfm_InitReadyTime();
+    if(e < 0) ERR(e);
+
+    /* Let the incremental checkpointer trickle out the oldest dirty pages */
+    e = edubfm_CheckpointTick();
+    if(e < 0) ERR(e);
+
+    hashkey.volNo = trainId->volNo;
+    hashkey.pageNo = trainId->pageNo;
+
+    /* sampled access tracking for the working set estimation */
+    edubfm_TrackAccess(&hashkey);
+
+    index = edubfm_LookUp(&hashkey, type);
+
+    edubfm_classStat[type].nFixes++;
+
+    if(index == NOTFOUND_IN_HTABLE) {
+        edubfm_classStat[type].nMisses++;
+
+        if(edubfm_numaTopology.nNodes > 1)
+            index = edubfm_NumaAllocTrain(type, edubfm_NumaPlacementNode(&hashkey));
+        else
+            index = edubfm_AllocTrain(type);
+        if(index < 0) ERR(index);
+
+        e = edubfm_ReadTrainAsync(trainId, BI_BUFFER(type, index), type, &BI_READYTIME(type, index));
+        if(e < 0) ERR(e);
+
+        BI_KEY(type, index) = hashkey;
+        BI_FIXED(type, index) = 1;
+        BI_BITS(type, index) |= REFER;
+
+        e = edubfm_Insert(&hashkey, index, type);
+        if(e < 0) ERR(e);
+    }
+    else {
+        edubfm_classStat[type].nHits++;
+        BI_FIXED(type, index)++;
+        BI_BITS(type, index) |= REFER;
+    }
+
+    edubfm_NumaCountAccess(type, index);
+
+    req->trainId = *trainId;
+    req->type = type;
+    req->index = index;
+    req->buf = BI_BUFFER(type, index);
+    req->readyTime = BI_READYTIME(type, index);
+
+    return(eNOERROR);
+
+}  /* EduBfM_GetTrainAsync() */
+
+
+
+/*@================================
+ * EduBfM_PollTrain()
+ *================================*/
+/*
+ * Function: Boolean EduBfM_PollTrain(BfMGetTrainReq*)
+ *
+ * Description : 
+ *  Check whether the train of the request is in the buffer.
+ *
+ * Returns:
+ *  TRUE if the read of the train has completed, FALSE otherwise
+ */
+Boolean EduBfM_PollTrain(
+    BfMGetTrainReq      *req)                   /* IN request to be checked */
+{
+
+    return( req->readyTime <= edubfm_ioStat.clock );
+
+}  /* EduBfM_PollTrain() */
+
+
+
+/*@================================
+ * EduBfM_WaitTrain()
+ *================================*/
+/*
+ * Function: Four EduBfM_WaitTrain(BfMGetTrainReq*)
+ *
+ * Description : 
+ *  Block until the train of the request is in the buffer.
+ *
+ * Returns:
+ *  error code
+ *    eBADBUFFER_BFM - Invalid Buffer
+ */
+Four EduBfM_WaitTrain(
+    BfMGetTrainReq      *req)                   /* IN request to be waited for */
+{
+
+    if(req == NULL) ERR(eBADBUFFER_BFM);
+
+    edubfm_IOEmulWait(req->readyTime);
+
+    return(eNOERROR);
+
+}  /* EduBfM_WaitTrain() */
@@ -0,0 +1,160 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_IOProfile.c
+ *
+ * Description :
+ *  Select the storage device emulated underneath the buffer manager and
+ *  report the I/O statistics charged to it.
+ *
+ * Exports:
+ *  Four EduBfM_SetIOProfile(Four, BfMIOProfile *)
+ *  Four EduBfM_GetIOStat(BfMIOStat *)
+ *  Four EduBfM_ResetIOStat(void)
+ */
+
+
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * EduBfM_SetIOProfile()
+ *================================*/
+/*
+ * Function: Four EduBfM_SetIOProfile(Four, BfMIOProfile*)
+ *
+ * Description :
+ *  Select the device emulated underneath RDsM_ReadTrain()/RDsM_WriteTrain().
+ *  If 'params' is NULL, the predefined profile 'profile' (one of
+ *  IOEMUL_PROFILE_NONE, IOEMUL_PROFILE_HDD, IOEMUL_PROFILE_SATASSD and
+ *  IOEMUL_PROFILE_NVME) is used; otherwise the profile described by 'params'
+ *  is used and 'profile' is ignored.
+ *  Selecting a profile resets the virtual clock and the I/O statistics.
+ *
+ * Returns:
+ *  error code
+ *    eBADIOPROFILE_EDUBFM - bad profile number or bad profile parameters
+ */
+Four EduBfM_SetIOProfile(
+    Four			profile,		/* IN predefined profile number */
+    BfMIOProfile	*params)		/* IN user defined profile (or NULL) */
+{
+
+    if (params == NULL) {
+        if (profile < 0 || profile >= IOEMUL_NUM_PROFILES) ERR(eBADIOPROFILE_EDUBFM);
+        params = &edubfm_ioProfiles[profile];
+    }
+
+    if (params->readLatency < 0 || params->writeLatency < 0 || params->jitter < 0 ||
+        params->bandwidth < 0 || params->queueDepth < 1 ||
+        params->queueDepth > IOEMUL_MAX_QUEUEDEPTH)
+        ERR(eBADIOPROFILE_EDUBFM);
+
+    edubfm_ioProfile = *params;
+    edubfm_IOEmulReset();
+
+    return( eNOERROR );
+
+}  /* EduBfM_SetIOProfile() */
+
+
+
+/*@================================
+ * EduBfM_GetIOStat()
+ *================================*/
+/*
+ * Function: Four EduBfM_GetIOStat(BfMIOStat*)
+ *
+ * Description :
+ *  Return the I/O statistics charged to the emulated device since the last
+ *  reset. 'waitTime' is the time the callers would have been blocked on the
+ *  emulated device, so adding it to the measured elapsed time gives the
+ *  elapsed time "as if on" that device.
+ *
+ * Returns:
+ *  error code
+ *    eBADBUFFER_BFM - 'stat' is NULL
+ */
+Four EduBfM_GetIOStat(
+    BfMIOStat		*stat)			/* OUT I/O statistics */
+{
+
+    if (stat == NULL) ERR(eBADBUFFER_BFM);
+
+    *stat = edubfm_ioStat;
+
+    return( eNOERROR );
+
+}  /* EduBfM_GetIOStat() */
+
+
+
+/*@================================
+ * EduBfM_ResetIOStat()
+ *================================*/
+/*
+ * Function: Four EduBfM_ResetIOStat(void)
+ *
+ * Description :
+ *  Reset the virtual clock, the device queue and the I/O statistics
+ *  keeping the current profile.
+ *
+ * Returns:
+ *  error code
+ */
+Four EduBfM_ResetIOStat(void)
+{
+
+    edubfm_IOEmulReset();
+
+    return( eNOERROR );
+
+}  /* EduBfM_ResetIOStat() */
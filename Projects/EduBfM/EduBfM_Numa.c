@@ -0,0 +1,205 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_Numa.c
+ *
+ * Description :
+ *  Configure the simulated NUMA topology of the buffer pools and report
+ *  the local/remote access statistics.
+ *
+ * Exports:
+ *  Four EduBfM_SetNumaTopology(Four, Four, Four)
+ *  Four EduBfM_SetCurrentNode(Four)
+ *  Four EduBfM_GetHomeNode(TrainID *)
+ *  Four EduBfM_GetNumaStat(BfMNumaStat *)
+ */
+
+
+#include <string.h>
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * EduBfM_SetNumaTopology()
+ *================================*/
+/*
+ * Function: Four EduBfM_SetNumaTopology(Four, Four, Four)
+ *
+ * Description :
+ *  Split every buffer pool into 'nNodes' partitions, one per simulated
+ *  NUMA node, and place missed pages/trains according to 'placement':
+ *  NUMA_PLACE_LOCAL, the default, puts them into the partition of the
+ *  accessing node; NUMA_PLACE_HOME into that of the home node of the page.
+ *  'remoteLatency' is the extra cost (nsec) accounted for a remote access.
+ *  The partitions are logical: the buffers are not bound to node local
+ *  memory. Setting the topology resets the NUMA statistics.
+ *
+ * Returns:
+ *  error code
+ *    eBADNUMATOPOLOGY_EDUBFM - bad # of nodes, placement or latency
+ */
+Four EduBfM_SetNumaTopology(
+    Four		nNodes,			/* IN # of nodes */
+    Four		placement,		/* IN placement policy */
+    Four		remoteLatency)		/* IN extra cost of a remote access (nsec) */
+{
+    Four		type;			/* buffer type */
+    Four		node;			/* NUMA node */
+
+
+    if (nNodes < 1 || nNodes > NUMA_MAX_NODES) ERR(eBADNUMATOPOLOGY_EDUBFM);
+    if (placement != NUMA_PLACE_HOME && placement != NUMA_PLACE_LOCAL) ERR(eBADNUMATOPOLOGY_EDUBFM);
+    if (remoteLatency < 0) ERR(eBADNUMATOPOLOGY_EDUBFM);
+
+    /* every partition needs at least one buffer */
+    for (type = PAGE_BUF; type < NUM_BUF_TYPES; type++)
+        if (BI_NBUFS(type) < nNodes) ERR(eBADNUMATOPOLOGY_EDUBFM);
+
+    edubfm_numaTopology.nNodes = nNodes;
+    edubfm_numaTopology.placement = placement;
+    edubfm_numaTopology.remoteLatency = remoteLatency;
+
+    for (type = PAGE_BUF; type < NUM_BUF_TYPES; type++)
+        for (node = 0; node < nNodes; node++)
+            NUMA_PART_HAND(type, node) = NUMA_PART_LO(type, node);
+
+    memset(&edubfm_numaStat, 0, sizeof(BfMNumaStat));
+
+    return( eNOERROR );
+
+}  /* EduBfM_SetNumaTopology() */
+
+
+
+/*@================================
+ * EduBfM_SetCurrentNode()
+ *================================*/
+/*
+ * Function: Four EduBfM_SetCurrentNode(Four)
+ *
+ * Description :
+ *  Bind the calling thread to the simulated node 'node'.
+ *
+ * Returns:
+ *  error code
+ *    eBADNUMANODE_EDUBFM - bad node
+ */
+Four EduBfM_SetCurrentNode(
+    Four		node)			/* IN NUMA node */
+{
+
+    if (node < 0 || node >= edubfm_numaTopology.nNodes) ERR(eBADNUMANODE_EDUBFM);
+
+    edubfm_currentNode = node;
+
+    return( eNOERROR );
+
+}  /* EduBfM_SetCurrentNode() */
+
+
+
+/*@================================
+ * EduBfM_GetHomeNode()
+ *================================*/
+/*
+ * Function: Four EduBfM_GetHomeNode(TrainID*)
+ *
+ * Description :
+ *  Return the node where the page/train 'trainId' is placed when it is read
+ *  into the buffer pool, so that a caller can route the work on the
+ *  page/train to a thread running on that node.
+ *
+ * Returns:
+ *  1) NUMA node
+ *  2) Error codes: Negative value means error code.
+ *     eBADBUFFER_BFM - 'trainId' is NULL
+ */
+Four EduBfM_GetHomeNode(
+    TrainID		*trainId)		/* IN page/train */
+{
+    BfMHashKey		key;			/* hash key of the page/train */
+
+
+    if (trainId == NULL) ERR(eBADBUFFER_BFM);
+
+    key.pageNo = trainId->pageNo;
+    key.volNo = trainId->volNo;
+
+    return( edubfm_NumaPlacementNode(&key) );
+
+}  /* EduBfM_GetHomeNode() */
+
+
+
+/*@================================
+ * EduBfM_GetNumaStat()
+ *================================*/
+/*
+ * Function: Four EduBfM_GetNumaStat(BfMNumaStat*)
+ *
+ * Description :
+ *  Return the NUMA access statistics.
+ *
+ * Returns:
+ *  error code
+ *    eBADBUFFER_BFM - 'stat' is NULL
+ */
+Four EduBfM_GetNumaStat(
+    BfMNumaStat		*stat)			/* OUT NUMA statistics */
+{
+
+    if (stat == NULL) ERR(eBADBUFFER_BFM);
+
+    *stat = edubfm_numaStat;
+
+    return( eNOERROR );
+
+}  /* EduBfM_GetNumaStat() */
@@ -0,0 +1,114 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_PinDebug.c
+ *
+ * Description : 
+ *  Control of the pin leak and long pin detection (compiled only with
+ *  EDUBFM_PIN_DEBUG, see edubfm_PinDebug.c).
+ *
+ * Exports:
+ *  Four EduBfM_SetPinThreshold(Four)
+ *  Four EduBfM_ReportLongPins(void)
+ */
+
+
+#include "EduBfM_common.h"
+#include "EduBfM.h"
+
+
+#ifdef EDUBFM_PIN_DEBUG
+
+/*@================================
+ * EduBfM_SetPinThreshold()
+ *================================*/
+/*
+ * Function: Four EduBfM_SetPinThreshold(Four)
+ *
+ * Description : 
+ *  Set the time a pin may be held before it is reported as a long pin.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - bad threshold
+ */
+Four EduBfM_SetPinThreshold(
+    Four		threshold)		/* IN threshold (usec) */
+{
+
+    if (threshold < 0) ERR(eBADPARAMETER_EDUBFM);
+
+    edubfm_pinThreshold = threshold;
+
+    return( eNOERROR );
+
+}  /* EduBfM_SetPinThreshold() */
+
+
+
+/*@================================
+ * EduBfM_ReportLongPins()
+ *================================*/
+/*
+ * Function: Four EduBfM_ReportLongPins(void)
+ *
+ * Description : 
+ *  Print every pin held longer than the threshold.
+ *
+ * Returns:
+ *  # of pins held longer than the threshold
+ */
+Four EduBfM_ReportLongPins(void)
+{
+
+    return( edubfm_PinDebugCheck(TRUE) );
+
+}  /* EduBfM_ReportLongPins() */
+
+#endif /* EDUBFM_PIN_DEBUG */
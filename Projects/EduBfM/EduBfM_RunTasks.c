@@ -0,0 +1,129 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_RunTasks.c
+ *
+ * Description : 
+ *  Run a set of tasks to completion, interleaving them on their buffer
+ *  misses. A task which requests a train not in the buffer pool is suspended
+ *  while its read is pending and the other tasks run meanwhile; when every
+ *  live task is suspended, the virtual clock of the I/O emulation advances
+ *  to the earliest completion.
+ *
+ * Exports:
+ *  Four EduBfM_RunTasks(BfMTask **, Four)
+ */
+
+
+#include "EduBfM_common.h"
+#include "EduBfM.h"
+
+
+
+/*@================================
+ * EduBfM_RunTasks()
+ *================================*/
+/*
+ * Function: Four EduBfM_RunTasks(BfMTask**, Four)
+ *
+ * Description : 
+ *  Run the tasks 'tasks[0..nTasks-1]' until all of them are done.
+ *  The tasks are visited round robin; a waiting task is resumed only after
+ *  its request has become ready. A task should start with 'state' set to
+ *  BFMTASK_READY and 'resumePoint' set to 0.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_EDUBFM - bad parameter
+ *    error code returned by a task body
+ */
+Four EduBfM_RunTasks(
+    BfMTask             **tasks,                /* INOUT tasks to be run */
+    Four                nTasks)                 /* IN # of tasks */
+{
+    Four                e;                      /* for error */
+    Four                i;                      /* index of a task */
+    Four                nLive;                  /* # of tasks not yet done */
+    Boolean             ran;                    /* TRUE if some task was run in this round */
+    double              wakeup;                 /* earliest completion among the waiting tasks */
+    BfMTask             *t;
+
+
+    if(tasks == NULL || nTasks < 0) ERR(eBADPARAMETER_EDUBFM);
+
+    for(;;) {
+        nLive = 0;
+        ran = FALSE;
+        wakeup = -1.0;
+
+        for(i = 0; i < nTasks; i++) {
+            t = tasks[i];
+            if(t->state == BFMTASK_DONE) continue;
+            nLive++;
+
+            if(t->state == BFMTASK_WAITING && !EduBfM_PollTrain(&t->req)) {
+                if(wakeup < 0.0 || t->req.readyTime < wakeup) wakeup = t->req.readyTime;
+                continue;
+            }
+
+            e = t->body(t);
+            if(e < 0) ERR(e);
+            t->state = e;
+            ran = TRUE;
+        }
+
+        if(nLive == 0) break;
+
+        /* every live task is blocked: let the device complete the earliest read */
+        if(!ran) edubfm_IOEmulWait(wakeup);
+    }
+
+    return(eNOERROR);
+
+}  /* EduBfM_RunTasks() */
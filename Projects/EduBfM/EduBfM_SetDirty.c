@@ -82,6 +82,7 @@
  * Returns:
  *  error code
  *    eBADBUFFERTYPE_BFM - bad buffer type
+ *    eNOTFOUND_BFM - the train is not in the buffer
  *    some errors caused by function calls
  */
 Four EduBfM_SetDirty(
@@ -89,6 +90,7 @@ Four EduBfM_SetDirty(
     Four                type )                  /* IN buffer type */
 {
 	/* These local variables are used in the solution code. However, you don��t have to use all these variables in your code, and you may also declare and use additional local variables if needed. */
+    Four                e;                      /* for error */
     Four                index;                  /* an index of the buffer table & pool */
     BfMHashKey		hashkey;
 
@@ -99,6 +101,13 @@ Four EduBfM_SetDirty(
     hashkey.volNo=trainId->volNo;
 
     index=edubfm_LookUp(&hashkey,type);
+    if(index==NOTFOUND_IN_HTABLE) ERR(eNOTFOUND_BFM);
+
+    /* A clean buffer enters the dirty page table: record its recLSN */
+    if(!(BI_BITS(type,index)&DIRTY)){
+        e = edubfm_SetRecLsn(type,index);
+        if(e < 0) ERR(e);
+    }
 
     BI_BITS(type,index)=BI_BITS(type,index)|DIRTY;
 
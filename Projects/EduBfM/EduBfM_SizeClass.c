@@ -0,0 +1,258 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBfM_SizeClass.c
+ *
+ * Description : 
+ *  Register and size buffer pools for train sizes other than those of
+ *  PAGE_BUF and LOT_LEAF_BUF, e.g. pools of 16 or 64 page trains for
+ *  large B+ tree nodes or extent sized scan buffers. A registered size
+ *  class is a buffer type like the builtin ones and is used through the
+ *  same EduBfM interface.
+ *
+ * Exports:
+ *  Four EduBfM_RegisterSizeClass(Two, Two)
+ *  Four EduBfM_ResizeSizeClass(Four, Two)
+ *  Four EduBfM_GetSizeClass(Four)
+ *  Four EduBfM_GetSizeClassStat(Four, BfMSizeClassStat *)
+ */
+
+
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@================================
+ * EduBfM_RegisterSizeClass()
+ *================================*/
+/*
+ * Function: Four EduBfM_RegisterSizeClass(Two, Two)
+ *
+ * Description : 
+ *  Create a buffer pool of 'nBufs' buffers each holding a train of
+ *  'bufSize' pages.
+ *
+ * Returns:
+ *  1) buffer type of the new pool
+ *  2) Error codes: Negative value means error code.
+ *     eBADSIZECLASS_EDUBFM - bad size or no room for another pool
+ *     eMEMORYALLOCERR_EDUBFM - memory allocation error
+ */
+Four EduBfM_RegisterSizeClass(
+    Two			bufSize,		/* IN size of a buffer in page size */
+    Two			nBufs)			/* IN # of buffers */
+{
+    Four		e;				/* error code */
+    Four		type;			/* buffer type of the new pool */
+    Four		node;			/* NUMA node */
+
+
+    if (bufSize < 1) ERR(eBADSIZECLASS_EDUBFM);
+    if (nBufs < 1 || nBufs > SIZECLASS_MAX_NBUFS) ERR(eBADSIZECLASS_EDUBFM);
+    if (NUM_BUF_TYPES >= MAX_BUF_TYPES) ERR(eBADSIZECLASS_EDUBFM);
+
+    /* every NUMA partition needs at least one buffer */
+    if (nBufs < edubfm_numaTopology.nNodes) ERR(eBADSIZECLASS_EDUBFM);
+
+    type = NUM_BUF_TYPES;
+
+    e = edubfm_InitPool(type, bufSize, nBufs);
+    if (e < 0) ERR(e);
+
+    edubfm_nBufTypes++;
+
+    for (node = 0; node < edubfm_numaTopology.nNodes; node++)
+        NUMA_PART_HAND(type, node) = NUMA_PART_LO(type, node);
+
+    return( type );
+
+}  /* EduBfM_RegisterSizeClass() */
+
+
+
+/*@================================
+ * EduBfM_ResizeSizeClass()
+ *================================*/
+/*
+ * Function: Four EduBfM_ResizeSizeClass(Four, Two)
+ *
+ * Description : 
+ *  Change the number of buffers of a registered size class.
+ *  Dirty trains of the pool are written out and the pool is emptied, so no
+ *  buffer of the pool may be fixed.
+ *
+ * Returns:
+ *  error code
+ *    eBADBUFFERTYPE_BFM - not a registered size class
+ *    eBADSIZECLASS_EDUBFM - bad size
+ *    eFLUSHFIXEDBUF_BFM - a buffer of the pool is fixed
+ *    some errors caused by function calls
+ */
+Four EduBfM_ResizeSizeClass(
+    Four		type,			/* IN buffer type of the size class */
+    Two			nBufs)			/* IN new # of buffers */
+{
+    Four		e;				/* error code */
+    Four		i;				/* index of a buffer element */
+    Four		node;			/* NUMA node */
+    Two			bufSize;		/* size of a buffer in page size */
+    TrainID		trainId;
+
+
+    if (type < NUM_BUILTIN_BUF_TYPES || IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);
+    if (nBufs < 1 || nBufs > SIZECLASS_MAX_NBUFS) ERR(eBADSIZECLASS_EDUBFM);
+    if (nBufs < edubfm_numaTopology.nNodes) ERR(eBADSIZECLASS_EDUBFM);
+
+    for (i = 0; i < BI_NBUFS(type); i++)
+        if (BI_FIXED(type, i) > 0) ERR(eFLUSHFIXEDBUF_BFM);
+
+    /* the write queue may refer to buffers of the pool */
+    e = edubfm_DrainWriteQueue(0);
+    if (e < 0) ERR(e);
+
+    edubfm_DwbBegin();
+    for (i = 0; i < BI_NBUFS(type); i++) {
+        if (BI_BITS(type, i) & DIRTY) {
+            trainId.pageNo = BI_KEY(type, i).pageNo;
+            trainId.volNo = BI_KEY(type, i).volNo;
+            e = edubfm_FlushTrain(&trainId, type);
+            if (e < 0) {
+                edubfm_DwbEnd();
+                ERR(e);
+            }
+        }
+    }
+    e = edubfm_DwbEnd();
+    if (e < 0) ERR(e);
+
+    bufSize = BI_BUFSIZE(type);
+    edubfm_FreePool(type);
+
+    e = edubfm_InitPool(type, bufSize, nBufs);
+    if (e < 0) ERR(e);
+
+    for (node = 0; node < edubfm_numaTopology.nNodes; node++)
+        NUMA_PART_HAND(type, node) = NUMA_PART_LO(type, node);
+
+    return( eNOERROR );
+
+}  /* EduBfM_ResizeSizeClass() */
+
+
+
+/*@================================
+ * EduBfM_GetSizeClass()
+ *================================*/
+/*
+ * Function: Four EduBfM_GetSizeClass(Four)
+ *
+ * Description : 
+ *  Return the buffer type with the smallest train size not less than
+ *  'nPages' pages.
+ *
+ * Returns:
+ *  1) buffer type
+ *  2) Error codes: Negative value means error code.
+ *     eBADSIZECLASS_EDUBFM - no buffer pool holds such a train
+ */
+Four EduBfM_GetSizeClass(
+    Four		nPages)			/* IN # of pages of the train */
+{
+    Four		type;			/* buffer type */
+    Four		best;			/* best fitting buffer type so far */
+
+
+    best = NIL;
+    for (type = PAGE_BUF; type < NUM_BUF_TYPES; type++) {
+        if (BI_BUFSIZE(type) < nPages) continue;
+        if (best == NIL || BI_BUFSIZE(type) < BI_BUFSIZE(best)) best = type;
+    }
+
+    if (best == NIL) ERR(eBADSIZECLASS_EDUBFM);
+
+    return( best );
+
+}  /* EduBfM_GetSizeClass() */
+
+
+
+/*@================================
+ * EduBfM_GetSizeClassStat()
+ *================================*/
+/*
+ * Function: Four EduBfM_GetSizeClassStat(Four, BfMSizeClassStat*)
+ *
+ * Description : 
+ *  Return the statistics of the buffer pool 'type'.
+ *
+ * Returns:
+ *  error code
+ *    eBADBUFFERTYPE_BFM - Invalid Buffer type
+ *    eBADBUFFER_BFM - Invalid Buffer
+ *
+ * Side effects:
+ *  1) parameter stat
+ *     the statistics of the buffer pool
+ */
+Four EduBfM_GetSizeClassStat(
+    Four		type,			/* IN buffer type */
+    BfMSizeClassStat	*stat)		/* OUT statistics */
+{
+
+    if (IS_BAD_BUFFERTYPE(type)) ERR(eBADBUFFERTYPE_BFM);
+    if (stat == NULL) ERR(eBADBUFFER_BFM);
+
+    *stat = edubfm_classStat[type];
+    stat->bufSize = BI_BUFSIZE(type);
+    stat->nBufs = BI_NBUFS(type);
+
+    return( eNOERROR );
+
+}  /* EduBfM_GetSizeClassStat() */
@@ -50,15 +50,69 @@
 #define _EDUBFM_H_
 
 
+#include "EduBfM_Internal.h"
+
+
 /*@
  * Function Prototypes
  */
 /* Interface Function Prototypes */
 Four EduBfM_FreeTrain(TrainID *, Four);
 Four EduBfM_GetTrain(TrainID *, char **, Four);
+Four EduBfM_GetTrainAsync(BfMGetTrainReq *, TrainID *, Four);
+Boolean EduBfM_PollTrain(BfMGetTrainReq *);
+Four EduBfM_WaitTrain(BfMGetTrainReq *);
+Four EduBfM_RunTasks(BfMTask **, Four);
+Four EduBfM_RegisterSizeClass(Two, Two);
+Four EduBfM_ResizeSizeClass(Four, Two);
+Four EduBfM_GetSizeClass(Four);
+Four EduBfM_GetSizeClassStat(Four, BfMSizeClassStat *);
+Four EduBfM_SetAccessSampling(double);
+Four EduBfM_PredictHitRatio(VolNo, Four, double *);
+Four EduBfM_GetMissRatioCurve(VolNo, BfMMrcPoint *, Four, Four);
+Four EduBfM_GetWorkingSetSize(VolNo, double, Four *);
+Four EduBfM_DumpHeatmap(char *);
+Four EduBfM_DumpMissRatioCurve(char *, Four, Four);
+
+#ifdef EDUBFM_PIN_DEBUG
+Four EduBfM_SetPinThreshold(Four);
+Four EduBfM_ReportLongPins(void);
+Four edubfm_PinGetTrain(TrainID *, char **, Four, char *, Four);
+Four edubfm_PinGetTrainAsync(BfMGetTrainReq *, TrainID *, Four, char *, Four);
+Four edubfm_PinFreeTrain(TrainID *, Four, char *, Four);
+
+/* Callers fix and free trains through the recording wrappers; the modules
+ * implementing the interface define EDUBFM_PIN_NOWRAP to see the real
+ * functions.
+ */
+#ifndef EDUBFM_PIN_NOWRAP
+#define EduBfM_GetTrain(trainId, retBuf, type) \
+    edubfm_PinGetTrain((trainId), (retBuf), (type), __FILE__, __LINE__)
+#define EduBfM_GetTrainAsync(req, trainId, type) \
+    edubfm_PinGetTrainAsync((req), (trainId), (type), __FILE__, __LINE__)
+#define EduBfM_FreeTrain(trainId, type) \
+    edubfm_PinFreeTrain((trainId), (type), __FILE__, __LINE__)
+#endif
+#endif /* EDUBFM_PIN_DEBUG */
 Four EduBfM_SetDirty(TrainID *, Four);
 Four EduBfM_DiscardAll(void);
 Four EduBfM_FlushAll(void);
+Four EduBfM_SetIOProfile(Four, BfMIOProfile *);
+Four EduBfM_GetIOStat(BfMIOStat *);
+Four EduBfM_ResetIOStat(void);
+Four EduBfM_SetEvictPolicy(Four, Four, Four);
+Four EduBfM_GetEvictStat(BfMEvictStat *);
+Four EduBfM_DrainWriteQueue(Four);
+Four EduBfM_SetCheckpointPolicy(Four, Four);
+Four EduBfM_Checkpoint(Four);
+Four EduBfM_GetDirtyPageTable(BfMDirtyPageEntry *, Four, Four *, Lsn_T *);
+Four EduBfM_SetNumaTopology(Four, Four, Four);
+Four EduBfM_SetCurrentNode(Four);
+Four EduBfM_GetHomeNode(TrainID *);
+Four EduBfM_GetNumaStat(BfMNumaStat *);
+Four EduBfM_EnableDoubleWrite(char *);
+Four EduBfM_RecoverDoubleWrite(char *);
+Four EduBfM_GetDoubleWriteStat(BfMDwbStat *);
 
 
 #endif /* _EDUBFM_H_ */
@@ -54,7 +54,13 @@
  * Constant Definitions
  */ 
 /* number of buffer types : number of buffer pools used */
-#define NUM_BUF_TYPES 2
+#define NUM_BUF_TYPES (edubfm_nBufTypes)
+
+/* number of buffer types set up by the storage system (PAGE_BUF and LOT_LEAF_BUF) */
+#define NUM_BUILTIN_BUF_TYPES 2
+
+/* maximum number of buffer types including the size classes registered at run time */
+#define MAX_BUF_TYPES 8
 
 /* Buffer Types */
 #define PAGE_BUF     0
@@ -253,18 +259,508 @@ typedef struct {
 #define NOTFOUND_IN_HTABLE  -1
 
 extern BufferInfo bufInfo[];
+extern Four edubfm_nBufTypes;
+
+
+/*@
+ * Size Classes
+ */
+/* largest train RDsM transfers at once; RDsM accepts trains of 1 or this many pages */
+#define RDSM_MAX_TRAINSIZE			4
+
+/* maximum # of buffers of a registered size class; the hash table must be indexable by Two */
+#define SIZECLASS_MAX_NBUFS			10922
+
+/* statistics of a buffer pool (size class) */
+typedef struct {
+    Two			bufSize;		/* size of a buffer in page size */
+    Two			nBufs;			/* # of buffers in the buffer pool */
+    Four		nFixes;			/* # of trains fixed */
+    Four		nHits;			/* # of fixes which found the train in the pool */
+    Four		nMisses;		/* # of fixes which read the train */
+    Four		nEvictions;		/* # of victims selected */
+    Four		nWrites;		/* # of trains written */
+} BfMSizeClassStat;
+
+extern BfMSizeClassStat edubfm_classStat[];
+
+
+/*@
+ * I/O Emulation
+ */
+/* Latency distributions of the emulated device */
+#define IOEMUL_DIST_CONSTANT		0	/* every I/O takes the mean latency */
+#define IOEMUL_DIST_UNIFORM			1	/* uniform in [mean-jitter, mean+jitter] */
+#define IOEMUL_DIST_EXPONENTIAL		2	/* exponential with the given mean */
+
+/* Predefined device profiles */
+#define IOEMUL_PROFILE_NONE			0	/* no emulation; I/Os cost what the host makes them cost */
+#define IOEMUL_PROFILE_HDD			1
+#define IOEMUL_PROFILE_SATASSD		2
+#define IOEMUL_PROFILE_NVME			3
+#define IOEMUL_NUM_PROFILES			4
+
+/* maximum number of outstanding I/Os the device model can serve concurrently */
+#define IOEMUL_MAX_QUEUEDEPTH		64
+
+/* The structure describing an emulated storage device */
+typedef struct {
+    char		*name;			/* profile name used in reports */
+    Boolean		enabled;		/* FALSE: no latency is charged */
+    Four		dist;			/* latency distribution (IOEMUL_DIST_xxx) */
+    Four		readLatency;	/* mean per-I/O read latency (usec) */
+    Four		writeLatency;	/* mean per-I/O write latency (usec) */
+    Four		jitter;			/* spread of the uniform distribution (usec) */
+    Four		bandwidth;		/* transfer rate cap (KB/sec), 0 means unlimited */
+    Four		queueDepth;		/* # of I/Os served concurrently by the device */
+    Boolean		realDelay;		/* TRUE: sleep for the emulated wait, FALSE: virtual clock only */
+    UFour		seed;			/* seed of the latency generator */
+} BfMIOProfile;
+
+/* I/O statistics of the storage layer */
+typedef struct {
+    Four		nReads;			/* # of read requests */
+    Four		nWrites;		/* # of write requests */
+    Four		nPagesRead;		/* # of pages read */
+    Four		nPagesWritten;	/* # of pages written */
+    double		busyTime;		/* emulated device service time (usec) */
+    double		waitTime;		/* emulated time callers were blocked on I/O (usec) */
+    double		clock;			/* emulated virtual clock (usec) */
+} BfMIOStat;
+
+extern BfMIOProfile edubfm_ioProfiles[];
+extern BfMIOProfile edubfm_ioProfile;
+extern BfMIOStat edubfm_ioStat;
+
+
+/*@
+ * Eviction Policy
+ */
+/* Eviction modes */
+#define EVICT_MODE_CLOCK			0	/* second chance; a dirty victim is flushed synchronously */
+#define EVICT_MODE_CLEANFIRST		1	/* second chance preferring any clean victim to a dirty one */
+
+/* default # of dirty candidates put into the write queue per allocation */
+#define EVICT_DEFAULT_WINDOW		8
+
+/* default # of queued writes issued by the write-behind per checkpoint step */
+#define EVICT_DEFAULT_WRITEBEHIND	1
+
+/* maximum # of entries in the write queue */
+#define WRITEQUEUE_SIZE				64
+
+/* The structure describing the eviction policy */
+typedef struct {
+    Four		mode;			/* EVICT_MODE_xxx */
+    Four		window;			/* # of dirty candidates queued per allocation */
+    Four		writeBehind;	/* # of queued writes issued per checkpoint step */
+} BfMEvictPolicy;
+
+/* An entry of the write queue; the key validates that the frame still holds the train */
+typedef struct {
+    BfMHashKey	key;			/* train queued for writing */
+    Four		type;			/* buffer type */
+    Two			index;			/* array index of the buffer element */
+} BfMWriteQueueEntry;
+
+/* eviction statistics */
+typedef struct {
+    Four		nEvictions;		/* # of victims selected */
+    Four		nDirtyEvictions;	/* # of victims which had to be flushed synchronously */
+    Four		nDirtySkipped;	/* # of dirty candidates skipped by the clean-first mode */
+    Four		nQueued;		/* # of trains put into the write queue */
+    Four		nQueueWrites;	/* # of trains written from the write queue */
+    Four		nQueueStale;	/* # of queue entries found already clean or replaced */
+    Four		nQueueFull;		/* # of trains not queued since the queue was full */
+} BfMEvictStat;
+
+extern BfMEvictPolicy edubfm_evictPolicy;
+extern BfMEvictStat edubfm_evictStat;
+
+
+/*@
+ * Double-Write Buffer
+ */
+/* maximum # of pages in a batch of the double-write buffer */
+#define DWB_MAX_PAGES				64
+
+/* tag of a valid header of the double-write file */
+#define DWB_MAGIC					0x44574231	/* "DWB1" */
+
+/* A page of the batch recorded in the header of the double-write file */
+typedef struct {
+    PageNo		pageNo;			/* page written */
+    VolNo		volNo;			/* volume of the page */
+    UFour		checksum;		/* checksum of the page image */
+} BfMDwbSlot;
+
+/* The header of the double-write file; the page images follow it in slot order */
+typedef struct {
+    UFour		magic;			/* DWB_MAGIC */
+    UFour		seq;			/* sequence number of the batch */
+    Four		nPages;			/* # of pages in the batch */
+    UFour		checksum;		/* checksum of the header with this field set to 0 */
+    BfMDwbSlot	slots[DWB_MAX_PAGES];
+} BfMDwbHeader;
+
+/* A train (or a piece of a train) of the batch to be written in place */
+typedef struct {
+    TrainID		trainId;		/* first page of the piece */
+    Two			nPages;			/* # of pages of the piece */
+    Two			slot;			/* slot of the first page in the batch */
+} BfMDwbEntry;
+
+/* The state of the double-write buffer */
+typedef struct {
+    Four		fd;				/* double-write file, NIL if the buffer is disabled */
+    char		*area;			/* header page followed by the page images of the batch */
+    Four		nPages;			/* # of pages in the batch */
+    Four		nEntries;		/* # of pieces in the batch */
+    BfMDwbEntry	entries[DWB_MAX_PAGES];
+    Four		depth;			/* nesting level of the open batch */
+    Boolean		sync;			/* TRUE if a caller waits for the batch */
+    Boolean		unsynced;		/* TRUE if the in-place writes of the last batch may not be durable */
+    UFour		seq;			/* sequence number of the next batch */
+} BfMDoubleWrite;
+
+/* statistics of the double-write buffer */
+typedef struct {
+    Four		nBatches;		/* # of batches written */
+    Four		nPagesWritten;	/* # of pages written through the double-write file */
+    Four		nSyncs;			/* # of file system syncs issued */
+    Four		nRepaired;		/* # of torn pages repaired by the last recovery */
+} BfMDwbStat;
+
+extern BfMDoubleWrite edubfm_dwb;
+extern BfMDwbStat edubfm_dwbStat;
+
+
+/*@
+ * Dirty Page Table
+ */
+/* Macro: LSN_CMP(a, b)
+ * Description: compare two log sequence numbers
+ * Parameters:
+ *  Lsn_T a         : log sequence number
+ *  Lsn_T b         : log sequence number
+ * Returns: negative if a < b, 0 if a == b, positive if a > b
+ */
+#define LSN_CMP(a, b) \
+    (((a).wrapCount != (b).wrapCount) ? (((a).wrapCount < (b).wrapCount) ? -1 : 1) : \
+     (((a).offset != (b).offset) ? (((a).offset < (b).offset) ? -1 : 1) : 0))
+
+/* Macro: BI_RECLSN(type, idx)
+ * Description: return the LSN at which the page/train residing in the buffer element was first dirtied
+ *              (valid only while the DIRTY bit of the buffer element is set)
+ * Parameters:
+ *  Four type       : buffer type
+ *  Four idx        : array index of the buffer element
+ * Returns: (Lsn_T) recovery LSN
+ */
+#define BI_RECLSN(type, idx)         (edubfm_recLsn[type][idx])
+
+/* An entry of the dirty page table */
+typedef struct {
+    BfMHashKey	key;			/* dirty page/train */
+    Four		type;			/* buffer type */
+    Lsn_T		recLsn;			/* LSN at which the page/train was first dirtied */
+} BfMDirtyPageEntry;
+
+/* The structure describing the incremental checkpointer */
+typedef struct {
+    Four		interval;		/* # of EduBfM_GetTrain() calls between checkpoint steps, 0 means off */
+    Four		nPagesPerStep;	/* # of oldest dirty pages written per checkpoint step */
+} BfMCheckpointPolicy;
+
+extern Lsn_T *edubfm_recLsn[];
+extern BfMCheckpointPolicy edubfm_checkpointPolicy;
+
+
+/*@
+ * NUMA Partitioning
+ */
+/* maximum # of (simulated) NUMA nodes */
+#define NUMA_MAX_NODES				8
+
+/* Placement policies: where the buffer of a missed page/train is allocated */
+#define NUMA_PLACE_LOCAL			0	/* in the partition of the accessing node (first touch) */
+#define NUMA_PLACE_HOME				1	/* in the partition of the home node of the page key */
+
+/* The structure describing the simulated NUMA topology */
+typedef struct {
+    Four		nNodes;			/* # of nodes; 1 means no partitioning */
+    Four		placement;		/* NUMA_PLACE_xxx */
+    Four		remoteLatency;	/* extra cost of a remote access (nsec), only accounted */
+} BfMNumaTopology;
+
+/* NUMA access statistics, indexed by the accessing node */
+typedef struct {
+    Four		nLocal[NUMA_MAX_NODES];		/* # of accesses to buffers in the local partition */
+    Four		nRemote[NUMA_MAX_NODES];	/* # of accesses to buffers in a remote partition */
+    Four		nSpills[NUMA_MAX_NODES];	/* # of allocations which fell back to another partition */
+    double		remoteCost;				/* accumulated remote access penalty (nsec) */
+} BfMNumaStat;
+
+extern BfMNumaTopology edubfm_numaTopology;
+extern BfMNumaStat edubfm_numaStat;
+extern UTwo edubfm_numaHand[MAX_BUF_TYPES][NUMA_MAX_NODES];
+extern __thread Four edubfm_currentNode;
+
+/* Macro: NUMA_PART_LO(type, node)
+ * Description: return the index of the first buffer element of the partition of a node
+ *              (the partition of node n is [NUMA_PART_LO(type,n), NUMA_PART_LO(type,n+1)))
+ * Parameters:
+ *  Four type       : buffer type
+ *  Four node       : NUMA node
+ * Returns: (Four) index of the first buffer element
+ */
+#define NUMA_PART_LO(type, node) \
+    ((Four)(((node) * (Four)BI_NBUFS(type)) / edubfm_numaTopology.nNodes))
+
+/* Macro: NUMA_NODE_OF(type, idx)
+ * Description: return the NUMA node whose partition contains the buffer element
+ * Parameters:
+ *  Four type       : buffer type
+ *  Four idx        : array index of the buffer element
+ * Returns: (Four) NUMA node
+ */
+#define NUMA_NODE_OF(type, idx) \
+    ((Four)((((idx) + 1) * edubfm_numaTopology.nNodes - 1) / (Four)BI_NBUFS(type)))
+
+/* Macro: NUMA_PART_HAND(type, node)
+ * Description: return the clock hand of the partition of a node
+ * Parameters:
+ *  Four type       : buffer type
+ *  Four node       : NUMA node
+ * Returns: (UTwo) array index of the next victim in the partition
+ */
+#define NUMA_PART_HAND(type, node)   (edubfm_numaHand[type][node])
+
+
+/*@
+ * Asynchronous Buffer Access
+ */
+/* Macro: BI_READYTIME(type, idx)
+ * Description: return the virtual time at which the read of the page/train into the buffer element completes
+ * Parameters:
+ *  Four type       : buffer type
+ *  Four idx        : array index of the buffer element
+ * Returns: (double) completion time of the read (usec)
+ */
+#define BI_READYTIME(type, idx)      (edubfm_readyTime[type][idx])
+
+/* A request for a train; the train may still be on its way into the buffer */
+typedef struct {
+    TrainID		trainId;		/* requested train */
+    Four		type;			/* buffer type */
+    Four		index;			/* array index of the buffer element holding the train */
+    char		*buf;			/* pointer to the buffer; the contents are valid once the request is ready */
+    double		readyTime;		/* virtual time at which the train is in the buffer (usec) */
+} BfMGetTrainReq;
+
+/* States of a task */
+#define BFMTASK_READY				0	/* runnable */
+#define BFMTASK_WAITING				1	/* suspended until its train request is ready */
+#define BFMTASK_DONE				2	/* finished */
+
+/* A task run by EduBfM_RunTasks().
+ * The body is a stackless coroutine: it is written between BFMTASK_BEGIN() and
+ * BFMTASK_END() and is re-entered from the top on every resumption, so local
+ * variables of the body do not survive a suspension; keep such state in 'arg'.
+ */
+typedef struct BfMTask_tag BfMTask;
+struct BfMTask_tag {
+    Four		(*body)(BfMTask *);	/* returns BFMTASK_xxx or an error code */
+    void		*arg;			/* argument (and saved state) of the task */
+    Four		state;			/* BFMTASK_xxx */
+    Four		resumePoint;	/* where the body resumes; 0 at the start */
+    BfMGetTrainReq	req;		/* train request the task is waiting for */
+};
+
+/* Macro: BFMTASK_BEGIN(t)
+ * Description: open the body of a task; must be paired with BFMTASK_END()
+ * Parameter:
+ *  BfMTask *t      : the task
+ */
+#define BFMTASK_BEGIN(t)     switch ((t)->resumePoint) { case 0:
+
+/* Macro: BFMTASK_GETTRAIN(t, tid, retBuf, bufType)
+ * Description: fix a train like EduBfM_GetTrain(), suspending the task while the read is pending
+ * Parameters:
+ *  BfMTask *t      : the task
+ *  TrainID *tid    : train to be used
+ *  char *retBuf    : (lvalue) set to the buffer holding the train
+ *  Four bufType    : buffer type
+ */
+#define BFMTASK_GETTRAIN(t, tid, retBuf, bufType) \
+    do { \
+        Four _e = EduBfM_GetTrainAsync(&(t)->req, (tid), (bufType)); \
+        if (_e < 0) return(_e); \
+        (t)->resumePoint = __LINE__; case __LINE__: \
+        if (!EduBfM_PollTrain(&(t)->req)) return(BFMTASK_WAITING); \
+        (retBuf) = (t)->req.buf; \
+    } while (0)
+
+/* Macro: BFMTASK_YIELD(t)
+ * Description: let the other tasks run before continuing
+ * Parameter:
+ *  BfMTask *t      : the task
+ */
+#define BFMTASK_YIELD(t) \
+    do { (t)->resumePoint = __LINE__; return(BFMTASK_READY); case __LINE__: ; } while (0)
+
+/* Macro: BFMTASK_END(t)
+ * Description: close the body of a task opened by BFMTASK_BEGIN()
+ * Parameter:
+ *  BfMTask *t      : the task
+ */
+#define BFMTASK_END(t)       } (t)->resumePoint = 0; return(BFMTASK_DONE)
+
+extern double *edubfm_readyTime[];
+
+
+/*@
+ * Access Tracking
+ */
+/* maximum # of volumes tracked */
+#define MRC_MAX_VOLUMES				8
+
+/* maximum # of sampled pages/trains kept per volume */
+#define MRC_MAX_KEYS				4096
+
+/* the reuse distance histogram: MRC_NUM_BINS bins of MRC_BIN_WIDTH buffers */
+#define MRC_BIN_WIDTH				8
+#define MRC_NUM_BINS				4096
+
+/* a page/train is sampled if the hash of its key modulo MRC_MODULUS is below the threshold */
+#define MRC_MODULUS					0x1000000
+
+/* A sampled page/train: an entry of the LRU stack of a volume */
+typedef struct {
+    BfMHashKey	key;			/* sampled page/train */
+    Four		nAccesses;		/* # of accesses since it was sampled */
+    Four		lastAccess;		/* reference # of the last access within the volume */
+    Two			prev;			/* next more recently used entry */
+    Two			next;			/* next less recently used entry */
+} BfMAccessEntry;
+
+/* Access tracking state of a volume */
+typedef struct {
+    VolNo		volNo;			/* tracked volume, NIL if the slot is empty */
+    Four		nRefs;			/* # of accesses to the volume */
+    Four		nSampled;		/* # of sampled accesses */
+    Four		nCold;			/* # of sampled accesses with no earlier access in the stack */
+    Four		nEntries;		/* # of entries in the LRU stack */
+    Two			head;			/* most recently used entry */
+    Two			tail;			/* least recently used entry */
+    BfMAccessEntry	*entries;	/* the LRU stack, MRC_MAX_KEYS entries */
+    Four		*hist;			/* reuse distance histogram, MRC_NUM_BINS + 1 bins (the last: beyond) */
+} BfMAccessTracker;
+
+/* A point of a miss ratio curve */
+typedef struct {
+    Four		nBufs;			/* pool size in buffers */
+    double		hitRatio;		/* predicted hit ratio */
+} BfMMrcPoint;
+
+extern UFour edubfm_mrcThreshold;
+extern BfMAccessTracker edubfm_trackers[];
+
+
+/*@
+ * Pin Debugging
+ */
+/* With EDUBFM_PIN_DEBUG defined (make PIN_DEBUG=1) every fix made through
+ * EduBfM_GetTrain()/EduBfM_GetTrainAsync() is recorded with its call site
+ * and time until the matching EduBfM_FreeTrain(). Otherwise nothing of it
+ * is compiled.
+ */
+#ifdef EDUBFM_PIN_DEBUG
+
+/* maximum # of pins recorded at the same time */
+#define PIN_DEBUG_MAX_PINS			1024
+
+/* default time a pin may be held before it is reported (usec) */
+#define PIN_DEBUG_DEFAULT_THRESHOLD	1000000
+
+/* A pin of a buffer */
+typedef struct {
+    Boolean		inUse;			/* TRUE if the entry records a pin */
+    Boolean		reported;		/* TRUE if the pin has been reported as long */
+    Four		type;			/* buffer type */
+    BfMHashKey	key;			/* pinned page/train */
+    char		*file;			/* call site of the fix */
+    Four		line;
+    double		fixTime;		/* time of the fix (usec) */
+} BfMPinRecord;
+
+extern BfMPinRecord edubfm_pins[];
+extern Four edubfm_pinThreshold;
+
+/* Macro: PIN_DEBUG_DUMP(where)
+ * Description: print the outstanding pins
+ * Parameter:
+ *  char *where     : name of the caller used in the report
+ */
+#define PIN_DEBUG_DUMP(where)        edubfm_PinDebugDump(where)
+
+#else
+
+#define PIN_DEBUG_DUMP(where)
+
+#endif /* EDUBFM_PIN_DEBUG */
+
 
 /*@
  * Function Prototypes
  */
 /* internal function prototypes */
 Four edubfm_AllocTrain(Four);
+Four edubfm_AllocTrainInPartition(Four, Four);
 Four edubfm_Delete(BfMHashKey *, Four);
 Four edubfm_DeleteAll(void);
 Four edubfm_FlushTrain(TrainID *, Four);
 Four edubfm_Insert(BfMHashKey *, Two, Four); 
 Four edubfm_LookUp(BfMHashKey *, Four);
 Four edubfm_ReadTrain(TrainID *, char *, Four);
+Four edubfm_ReadTrainAsync(TrainID *, char *, Four, double *);
+Four edubfm_InitReadyTime(void);
+void edubfm_IOEmulReset(void);
+void edubfm_IOEmulWait(double);
+Four edubfm_TrainIO(Boolean, TrainID *, char *, Two);
+Four edubfm_EmulReadTrain(TrainID *, char *, Two);
+Four edubfm_EmulReadTrainAsync(TrainID *, char *, Two, double *);
+Four edubfm_EmulWriteTrain(char *, TrainID *, Two);
+double edubfm_IOEmulCharge(Boolean, Four, Boolean);
+Four edubfm_EnqueueWrite(Four, Four);
+void edubfm_DequeueWrite(Four, Four);
+Four edubfm_DrainWriteQueue(Four);
+void edubfm_ClearWriteQueue(void);
+Four edubfm_WriteBehind(Four, Four);
+UFour edubfm_DwbChecksum(char *, Four);
+void edubfm_DwbBegin(void);
+Four edubfm_DwbEnd(void);
+Four edubfm_DwbWrite(TrainID *, char *, Two, Boolean);
+Four edubfm_DwbFlush(void);
+Four edubfm_InitDirtyPageTable(void);
+Four edubfm_SetRecLsn(Four, Four);
+Four edubfm_CheckpointStep(Four);
+Four edubfm_CheckpointTick(void);
+Four edubfm_NumaCurrentNode(void);
+Four edubfm_NumaPlacementNode(BfMHashKey *);
+Four edubfm_NumaAllocTrain(Four, Four);
+void edubfm_NumaCountAccess(Four, Four);
+Four edubfm_InitPool(Four, Two, Two);
+void edubfm_FreePool(Four);
+void edubfm_TrackAccess(BfMHashKey *);
+BfMAccessTracker *edubfm_LookUpTracker(VolNo);
+double edubfm_MrcHitRatio(BfMAccessTracker *, Four);
+void edubfm_ResetTrackers(void);
+#ifdef EDUBFM_PIN_DEBUG
+double edubfm_PinDebugNow(void);
+Four edubfm_PinDebugCheck(Boolean);
+void edubfm_PinDebugDump(char *);
+#endif
 
 
 #endif /* _EDUBFM_INTERNAL_H_ */
@@ -117,6 +117,33 @@ typedef PageID TrainID;		/* use its first page's PageID as the TrainID */
 
 #define PRINT_TRAINID(x,y) PRINT_PAGEID(x,y)
 
+
+/*
+ * log sequence number
+ */
+typedef struct Lsn_T_tag {
+    UFour offset;               /* byte position in a log volume */
+    UFour wrapCount;            /* # of wrapping around a log volume */
+} Lsn_T;
+
+
+/*
+ * Common Page
+ */
+typedef struct PageHdr_T_tag {
+    PageID pid;                 /* page id of this page */
+    Four flags;
+    Four reserved;
+    PageID fidOrIid;            /* file id or index id containing this page */
+    Lsn_T lsn;                  /* page lsn */
+    Four logRecLen;             /* log record length */
+} PageHdr;
+
+typedef struct Page_tag {
+    PageHdr header;
+    char data[PAGESIZE-sizeof(PageHdr)];
+} Page;
+
 /*
  * Error Handling
  */
@@ -124,4 +151,11 @@ typedef PageID TrainID;		/* use its first page's PageID as the TrainID */
 #define eNOERROR 0
 
 
+/*
+ * Macro Definitions
+ */
+#undef MAX
+#define MAX(a,b) (((a) >= (b)) ? (a):(b))
+
+
 #endif /* _EDUBFM_COMMON_H_ */
@@ -121,3 +121,14 @@
 #define eNOMORELOCKCONTROLBLOCKS_BFM             ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,59)
 #define NUM_ERRORS_BFM_ERR_BASE                  60
 #define eNOTSUPPORTED_EDUBFM		             ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,61)
+#define eBADIOPROFILE_EDUBFM		             ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,62)
+#define eBADEVICTPOLICY_EDUBFM		             ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,63)
+#define eMEMORYALLOCERR_EDUBFM		             ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,64)
+#define eBADCHECKPOINTPOLICY_EDUBFM	             ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,65)
+#define eBADNUMATOPOLOGY_EDUBFM		             ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,66)
+#define eBADNUMANODE_EDUBFM			             ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,67)
+#define eBADPARAMETER_EDUBFM		             ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,68)
+#define eBADSIZECLASS_EDUBFM		             ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,69)
+#define eNOTTRACKED_EDUBFM		             ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,70)
+#define eFILEOPENERR_EDUBFM		             ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,71)
+#define eDWBIOERR_EDUBFM			             ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,72)
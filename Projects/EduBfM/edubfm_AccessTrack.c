@@ -0,0 +1,327 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_AccessTrack.c
+ *
+ * Description :
+ *  Sampled tracking of page accesses and working set estimation.
+ *  Accesses are sampled by key in the manner of SHARDS: a page is tracked
+ *  if the hash of its key falls below a threshold, so the sampled pages
+ *  are a fixed fraction R of all pages and every access to them is seen.
+ *  The sampled pages of each volume are kept in an LRU stack; the depth
+ *  at which a page is found is its reuse distance among the sampled
+ *  pages, and divided by R it estimates the reuse distance among all
+ *  pages. The histogram of the scaled distances gives the hit ratio of an
+ *  LRU pool of any size (the miss ratio curve); the access count and the
+ *  last access of the sampled pages form the heatmap.
+ *
+ * Exports:
+ *  void edubfm_TrackAccess(BfMHashKey *)
+ *  BfMAccessTracker *edubfm_LookUpTracker(VolNo)
+ *  double edubfm_MrcHitRatio(BfMAccessTracker *, Four)
+ *  void edubfm_ResetTrackers(void)
+ */
+
+
+#include <stdlib.h>
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@
+ * Global Variables
+ */
+/* sampling threshold out of MRC_MODULUS; 0 means tracking is off */
+UFour edubfm_mrcThreshold = 0;
+
+/* access tracking state of each volume */
+BfMAccessTracker edubfm_trackers[MRC_MAX_VOLUMES] = {
+    { NIL }, { NIL }, { NIL }, { NIL }, { NIL }, { NIL }, { NIL }, { NIL }
+};
+
+
+/*@
+ * macro definitions
+ */
+/* Macro: MRC_HASH(k)
+ * Description: return the sampling hash of the key given as a parameter
+ * Parameters:
+ *  BfMHashKey *k   : pointer to the key
+ * Returns: (UFour) hash value in [0, MRC_MODULUS)
+ */
+#define MRC_HASH(k) \
+    (((((UFour)(k)->volNo * 0x9e3779b1U) ^ (UFour)(k)->pageNo) * 0x85ebca6bU >> 8) % MRC_MODULUS)
+
+
+/*@ Internal Function Prototypes */
+static BfMAccessTracker *edubfm_GetTracker(VolNo);
+
+
+
+/*@================================
+ * edubfm_LookUpTracker()
+ *================================*/
+/*
+ * Function: BfMAccessTracker *edubfm_LookUpTracker(VolNo)
+ *
+ * Description :
+ *  Return the tracking state of the volume 'volNo'.
+ *
+ * Returns:
+ *  pointer to the tracking state, NULL if the volume is not tracked
+ */
+BfMAccessTracker *edubfm_LookUpTracker(
+    VolNo		volNo)			/* IN volume */
+{
+    Four		i;
+
+
+    for (i = 0; i < MRC_MAX_VOLUMES; i++)
+        if (edubfm_trackers[i].volNo == volNo) return( &edubfm_trackers[i] );
+
+    return( NULL );
+
+}  /* edubfm_LookUpTracker */
+
+
+
+/*@================================
+ * edubfm_GetTracker()
+ *================================*/
+/*
+ * Function: static BfMAccessTracker *edubfm_GetTracker(VolNo)
+ *
+ * Description :
+ *  Return the tracking state of the volume 'volNo', starting to track the
+ *  volume if it is not yet tracked.
+ *
+ * Returns:
+ *  pointer to the tracking state, NULL if no more volume can be tracked
+ */
+static BfMAccessTracker *edubfm_GetTracker(
+    VolNo		volNo)			/* IN volume */
+{
+    Four		i;
+    BfMAccessTracker	*t;
+
+
+    t = edubfm_LookUpTracker(volNo);
+    if (t != NULL) return( t );
+
+    for (i = 0; i < MRC_MAX_VOLUMES; i++)
+        if (edubfm_trackers[i].volNo == NIL) break;
+    if (i == MRC_MAX_VOLUMES) return( NULL );
+
+    t = &edubfm_trackers[i];
+    if (t->entries == NULL) t->entries = (BfMAccessEntry *)malloc(sizeof(BfMAccessEntry) * MRC_MAX_KEYS);
+    if (t->hist == NULL) t->hist = (Four *)malloc(sizeof(Four) * (MRC_NUM_BINS + 1));
+    if (t->entries == NULL || t->hist == NULL) return( NULL );
+
+    t->volNo = volNo;
+    t->nRefs = t->nSampled = t->nCold = 0;
+    t->nEntries = 0;
+    t->head = t->tail = NIL;
+    for (i = 0; i <= MRC_NUM_BINS; i++) t->hist[i] = 0;
+
+    return( t );
+
+}  /* edubfm_GetTracker */
+
+
+
+/*@================================
+ * edubfm_TrackAccess()
+ *================================*/
+/*
+ * Function: void edubfm_TrackAccess(BfMHashKey*)
+ *
+ * Description :
+ *  Count an access to the page/train 'key'. If the key is sampled, its
+ *  reuse distance is added to the histogram of the volume and the key is
+ *  moved to the top of the LRU stack; a new key pushes out the bottom
+ *  entry when the stack is full.
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_TrackAccess(
+    BfMHashKey		*key)		/* IN accessed page/train */
+{
+    BfMAccessTracker	*t;		/* tracking state of the volume */
+    BfMAccessEntry	*ent;		/* entries of the LRU stack */
+    Four		i;				/* index of an entry */
+    Four		depth;			/* # of entries more recent than the key */
+    Four		bin;			/* histogram bin of the scaled distance */
+    double		distance;		/* reuse distance scaled to all pages */
+
+
+    if (edubfm_mrcThreshold == 0) return;
+
+    t = edubfm_GetTracker(key->volNo);
+    if (t == NULL) return;
+
+    t->nRefs++;
+    if (MRC_HASH(key) >= edubfm_mrcThreshold) return;
+    t->nSampled++;
+
+    ent = t->entries;
+    for (depth = 0, i = t->head; i != NIL; i = ent[i].next, depth++)
+        if (EQUALKEY(&ent[i].key, key)) break;
+
+    if (i != NIL) {
+        /* a reuse: scale the stack distance (depth + 1) to all pages */
+        distance = (depth + 1) * (double)MRC_MODULUS / edubfm_mrcThreshold;
+        bin = (Four)((distance - 1) / MRC_BIN_WIDTH);
+        t->hist[(bin < MRC_NUM_BINS) ? bin : MRC_NUM_BINS]++;
+
+        /* unlink */
+        if (ent[i].prev != NIL) ent[ent[i].prev].next = ent[i].next;
+        else t->head = ent[i].next;
+        if (ent[i].next != NIL) ent[ent[i].next].prev = ent[i].prev;
+        else t->tail = ent[i].prev;
+    }
+    else {
+        t->nCold++;
+
+        if (t->nEntries < MRC_MAX_KEYS)
+            i = t->nEntries++;
+        else {
+            /* reuse the least recently used entry */
+            i = t->tail;
+            t->tail = ent[i].prev;
+            ent[t->tail].next = NIL;
+        }
+        ent[i].key = *key;
+        ent[i].nAccesses = 0;
+    }
+
+    ent[i].nAccesses++;
+    ent[i].lastAccess = t->nRefs;
+
+    /* push on the top */
+    ent[i].prev = NIL;
+    ent[i].next = t->head;
+    if (t->head != NIL) ent[t->head].prev = i;
+    t->head = i;
+    if (t->tail == NIL) t->tail = i;
+
+}  /* edubfm_TrackAccess */
+
+
+
+/*@================================
+ * edubfm_MrcHitRatio()
+ *================================*/
+/*
+ * Function: double edubfm_MrcHitRatio(BfMAccessTracker*, Four)
+ *
+ * Description :
+ *  Predict the hit ratio of an LRU pool of 'nBufs' buffers for the
+ *  accesses tracked in 't'. The bin holding 'nBufs' is interpolated
+ *  linearly.
+ *  As in SHARDS-adj, the difference between the expected and the actual
+ *  # of sampled accesses is credited to the smallest distances, which
+ *  corrects for a sample holding more (or fewer) hot pages than its share.
+ *
+ * Returns:
+ *  predicted hit ratio in [0, 1]
+ */
+double edubfm_MrcHitRatio(
+    BfMAccessTracker	*t,		/* IN tracking state of a volume */
+    Four		nBufs)			/* IN pool size in buffers */
+{
+    Four		bin;
+    Four		full;			/* # of bins entirely below the pool size */
+    double		hits;			/* predicted # of sampled hits */
+    double		expected;		/* expected # of sampled accesses */
+
+
+    if (t->nSampled == 0 || nBufs <= 0) return( 0.0 );
+
+    full = nBufs / MRC_BIN_WIDTH;
+    if (full > MRC_NUM_BINS) full = MRC_NUM_BINS;
+
+    for (hits = 0.0, bin = 0; bin < full; bin++) hits += t->hist[bin];
+    if (full < MRC_NUM_BINS)
+        hits += t->hist[full] * (double)(nBufs % MRC_BIN_WIDTH) / MRC_BIN_WIDTH;
+
+    expected = t->nRefs * (double)edubfm_mrcThreshold / MRC_MODULUS;
+    hits += expected - t->nSampled;
+
+    if (hits <= 0.0) return( 0.0 );
+    if (hits >= expected) return( 1.0 );
+
+    return( hits / expected );
+
+}  /* edubfm_MrcHitRatio */
+
+
+
+/*@================================
+ * edubfm_ResetTrackers()
+ *================================*/
+/*
+ * Function: void edubfm_ResetTrackers(void)
+ *
+ * Description :
+ *  Stop tracking every volume and forget the tracked accesses.
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_ResetTrackers(void)
+{
+    Four		i;
+
+
+    for (i = 0; i < MRC_MAX_VOLUMES; i++)
+        edubfm_trackers[i].volNo = NIL;
+
+}  /* edubfm_ResetTrackers */
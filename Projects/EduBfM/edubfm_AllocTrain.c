@@ -54,6 +54,7 @@
  *
  * Exports:
  *  Four edubfm_AllocTrain(Four)
+ *  Four edubfm_AllocTrainInPartition(Four, Four)
  */
 
 
@@ -86,6 +87,13 @@ extern CfgParams_T sm_cfgParams;
  *  Before return the buffer, if the dirty bit of the victim is set, it 
  *  must be force out to the disk.
  *
+ *  If the clean-first eviction mode is set (see EduBfM_SetEvictPolicy()),
+ *  unreferenced dirty buffers are skipped in favour of a clean one, and the
+ *  first 'window' of them are put into the write queue. The queue is not
+ *  drained here; the caller never waits for a write while a clean unfixed
+ *  buffer exists. Only if there is none, the first skipped dirty buffer is
+ *  taken out of the write queue, selected and flushed synchronously.
+ *
  * Returns;
  *  1) An index of a new buffer from the buffer pool
  *  2) Error codes: Negative value means error code.
@@ -95,6 +103,37 @@ extern CfgParams_T sm_cfgParams;
 Four edubfm_AllocTrain(
     Four 	type)			/* IN type of buffer (PAGE or TRAIN) */
 {
+
+    return( edubfm_AllocTrainInPartition(type, NIL) );
+
+}  /* edubfm_AllocTrain */
+
+
+
+/*@================================
+ * edubfm_AllocTrainInPartition()
+ *================================*/
+/*
+ * Function: Four edubfm_AllocTrainInPartition(Four, Four)
+ *
+ * Description :
+ *  Allocate a new buffer from the partition of the buffer pool 'type'
+ *  belonging to the (simulated) NUMA node 'node', using the replacement
+ *  algorithm of edubfm_AllocTrain() restricted to the buffers of the
+ *  partition and the clock hand of the partition.
+ *  If 'node' is NIL, the whole buffer pool is used with BI_NEXTVICTIM(type)
+ *  as the clock hand.
+ *
+ * Returns;
+ *  1) An index of a new buffer from the partition
+ *  2) Error codes: Negative value means error code.
+ *     eNOUNFIXEDBUF_BFM - There is no unfixed buffer in the partition.
+ *     some errors caused by fuction calls
+ */
+Four edubfm_AllocTrainInPartition(
+    Four 	type,			/* IN type of buffer (PAGE or TRAIN) */
+    Four	node)			/* IN NUMA node owning the partition (or NIL) */
+{
 	/* These local variables are used in the solution code. However, you don��t have to use all these variables in your code, and you may also declare and use additional local variables if needed. */
     Four 	e;			/* for error */
     Four 	victim;			/* return value */
@@ -103,18 +142,46 @@ Four edubfm_AllocTrain(
     Four    index;
     TrainID trainId;
     BfMHashKey *key;
+    Four    firstDirty;         /* first dirty candidate skipped */
+    Four    nSkipped;           /* # of dirty candidates skipped */
+    Four    lo;                 /* first buffer of the partition */
+    Four    nBufs;              /* # of buffers in the partition */
+    UTwo    *hand;              /* clock hand of the partition */
     
 
 	/* Error check whether using not supported functionality by EduBfM */
 	if(sm_cfgParams.useBulkFlush) ERR(eNOTSUPPORTED_EDUBFM);
 
+    if(node == NIL){
+        lo = 0;
+        nBufs = BI_NBUFS(type);
+        hand = &BI_NEXTVICTIM(type);
+    }
+    else{
+        lo = NUMA_PART_LO(type,node);
+        nBufs = NUMA_PART_LO(type,node+1) - lo;
+        hand = &NUMA_PART_HAND(type,node);
+    }
+
+    firstDirty = -1;
+    nSkipped = 0;
+
     for(j=0; j<2; j++){
-        for(i=0; i<BI_NBUFS(type);i++){
-            index= (BI_NEXTVICTIM(type)+i)%BI_NBUFS(type);
+        for(i=0; i<nBufs;i++){
+            index= lo+(*hand-lo+i)%nBufs;
             if(BI_FIXED(type,index)==0){
                 if(BI_BITS(type,index)&REFER){
                     BI_BITS(type,index)&=~REFER;
                 }
+                else if(edubfm_evictPolicy.mode==EVICT_MODE_CLEANFIRST && (BI_BITS(type,index)&DIRTY)){
+                    if(firstDirty<0) firstDirty=index;
+                    if(nSkipped<edubfm_evictPolicy.window){
+                        e = edubfm_EnqueueWrite(type,index);
+                        if(e < 0) ERR(e);
+                        nSkipped++;
+                    }
+                    edubfm_evictStat.nDirtySkipped++;
+                }
                 else{
                     j=3;
                     break;
@@ -123,16 +190,25 @@ Four edubfm_AllocTrain(
         }
     }
 
-    if(j==2) ERR(eNOUNFIXEDBUF_BFM);
+    if(j==2){
+        if(firstDirty<0) ERR(eNOUNFIXEDBUF_BFM);
+        index=firstDirty;
+        edubfm_DequeueWrite(type,index);
+    }
+
+    edubfm_evictStat.nEvictions++;
+    edubfm_classStat[type].nEvictions++;
 
     if(BI_BITS(type,index)&DIRTY){
         trainId.pageNo=BI_KEY(type,index).pageNo;
         trainId.volNo=BI_KEY(type,index).volNo;
-        edubfm_FlushTrain(&trainId,type);
+        e = edubfm_FlushTrain(&trainId,type);
+        if(e < 0) ERR(e);
+        edubfm_evictStat.nDirtyEvictions++;
     }
     
     BI_BITS(type,index)=ALL_0;
-    BI_NEXTVICTIM(type)=(index+1)%BI_NBUFS(type);
+    *hand=lo+(index-lo+1)%nBufs;
 
     key = &BI_KEY(type,index);
     edubfm_Delete(key,type);
@@ -140,4 +216,4 @@ Four edubfm_AllocTrain(
     victim=index;
     return( victim );
     
-}  /* edubfm_AllocTrain */
+}  /* edubfm_AllocTrainInPartition */
@@ -0,0 +1,274 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_Checkpoint.c
+ *
+ * Description :
+ *  Maintain the dirty page table and run the incremental checkpointer.
+ *  The dirty page table consists of the buffer elements whose DIRTY bit is
+ *  set; for each of them the recovery LSN (recLSN), the LSN at which the
+ *  page/train was first dirtied, is kept in a side table.
+ *  Instead of writing every dirty buffer at once, the checkpointer trickles
+ *  out the dirty pages with the oldest recLSN a few at a time, so that the
+ *  minimum recLSN, i.e. the redo point, advances without a write burst.
+ *
+ * Exports:
+ *  Four edubfm_InitDirtyPageTable(void)
+ *  Four edubfm_SetRecLsn(Four, Four)
+ *  Four edubfm_CheckpointStep(Four)
+ *  Four edubfm_CheckpointTick(void)
+ */
+
+
+#include <stdlib.h> /* for malloc */
+#include <string.h>
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@
+ * Global Variables
+ */
+/* recovery LSN of each buffer element, indexed by buffer type */
+Lsn_T *edubfm_recLsn[MAX_BUF_TYPES];
+
+/* the checkpoint policy in effect; the incremental checkpointer is off by default */
+BfMCheckpointPolicy edubfm_checkpointPolicy = { 0, 1 };
+
+/* the last LSN handed out as a recLSN */
+static Lsn_T edubfm_lsnClock = { 0, 0 };
+
+/* # of EduBfM_GetTrain() calls since the last checkpoint step */
+static Four edubfm_nTicks = 0;
+
+
+
+/*@================================
+ * edubfm_InitDirtyPageTable()
+ *================================*/
+/*
+ * Function: Four edubfm_InitDirtyPageTable(void)
+ *
+ * Description :
+ *  Allocate the recLSN side tables of the buffer pools if not yet allocated.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR_EDUBFM - memory allocation error
+ */
+Four edubfm_InitDirtyPageTable(void)
+{
+    Four		type;			/* buffer type */
+
+
+    for (type = PAGE_BUF; type < NUM_BUF_TYPES; type++) {
+        if (edubfm_recLsn[type] != NULL || BI_NBUFS(type) <= 0) continue;
+
+        edubfm_recLsn[type] = (Lsn_T *)malloc(sizeof(Lsn_T) * BI_NBUFS(type));
+        if (edubfm_recLsn[type] == NULL) ERR(eMEMORYALLOCERR_EDUBFM);
+        memset(edubfm_recLsn[type], 0, sizeof(Lsn_T) * BI_NBUFS(type));
+    }
+
+    return( eNOERROR );
+
+}  /* edubfm_InitDirtyPageTable */
+
+
+
+/*@================================
+ * edubfm_SetRecLsn()
+ *================================*/
+/*
+ * Function: Four edubfm_SetRecLsn(Four, Four)
+ *
+ * Description :
+ *  Record the recLSN of the buffer element 'index' of the buffer pool 'type'
+ *  which is about to become dirty.
+ *  EduCOSMOS has no log manager which could tell the current end of log, so
+ *  the recLSN is drawn from a monotonic LSN clock kept here. The clock is
+ *  moved forward to the page LSN of a page whose LSN is ahead of it, so
+ *  that recLSNs stay ordered with the page LSNs stamped by the upper layers.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubfm_SetRecLsn(
+    Four		type,			/* IN buffer type */
+    Four		index)			/* IN array index of the buffer element */
+{
+    Four		e;			/* error code */
+    Lsn_T		*pageLsn;		/* LSN of the page */
+
+
+    e = edubfm_InitDirtyPageTable();
+    if (e < 0) ERR(e);
+
+    /* trains of LOT_LEAF_BUF hold large object data without a page header */
+    if (type == PAGE_BUF) {
+        pageLsn = &((Page *)BI_BUFFER(type, index))->header.lsn;
+        if (LSN_CMP(*pageLsn, edubfm_lsnClock) > 0) {
+            edubfm_lsnClock = *pageLsn;
+            BI_RECLSN(type, index) = edubfm_lsnClock;
+            return( eNOERROR );
+        }
+    }
+
+    if (++edubfm_lsnClock.offset == 0) edubfm_lsnClock.wrapCount++;
+    BI_RECLSN(type, index) = edubfm_lsnClock;
+
+    return( eNOERROR );
+
+}  /* edubfm_SetRecLsn */
+
+
+
+/*@================================
+ * edubfm_CheckpointStep()
+ *================================*/
+/*
+ * Function: Four edubfm_CheckpointStep(Four)
+ *
+ * Description :
+ *  Write at most 'n' dirty buffers in the order of their recLSN, the oldest
+ *  first. Fixed buffers are skipped since they may be under modification.
+ *  The writes do not block the caller (see edubfm_WriteBehind()) and go
+ *  through the double-write buffer as one batch.
+ *
+ * Returns:
+ *  1) # of trains written
+ *  2) Error codes: Negative value means error code.
+ *     some errors caused by function calls
+ */
+Four edubfm_CheckpointStep(
+    Four		n)			/* IN maximum # of trains to be written */
+{
+    Four		e;			/* error code */
+    Four		type;			/* buffer type */
+    Four		i;			/* index of a buffer element */
+    Four		nWritten;		/* # of trains written */
+    Four		oldestType;		/* buffer type of the oldest dirty buffer */
+    Four		oldestIndex;		/* index of the oldest dirty buffer */
+
+
+    e = edubfm_InitDirtyPageTable();
+    if (e < 0) ERR(e);
+
+    edubfm_DwbBegin();
+
+    for (nWritten = 0; nWritten < n; nWritten++) {
+
+        oldestType = oldestIndex = NIL;
+        for (type = PAGE_BUF; type < NUM_BUF_TYPES; type++) {
+            for (i = 0; i < BI_NBUFS(type); i++) {
+                if (!(BI_BITS(type, i) & DIRTY) || BI_FIXED(type, i) > 0) continue;
+                if (oldestIndex == NIL ||
+                    LSN_CMP(BI_RECLSN(type, i), BI_RECLSN(oldestType, oldestIndex)) < 0) {
+                    oldestType = type;
+                    oldestIndex = i;
+                }
+            }
+        }
+
+        if (oldestIndex == NIL) break;
+
+        e = edubfm_WriteBehind(oldestType, oldestIndex);
+        if (e < 0) {
+            edubfm_DwbEnd();
+            ERR(e);
+        }
+    }
+
+    e = edubfm_DwbEnd();
+    if (e < 0) ERR(e);
+
+    return( nWritten );
+
+}  /* edubfm_CheckpointStep */
+
+
+
+/*@================================
+ * edubfm_CheckpointTick()
+ *================================*/
+/*
+ * Function: Four edubfm_CheckpointTick(void)
+ *
+ * Description :
+ *  Count one buffer access; every 'interval' accesses a checkpoint step
+ *  writing 'nPagesPerStep' oldest dirty pages is taken. In the clean-first
+ *  eviction mode the step first writes behind up to 'writeBehind' trains
+ *  of the write queue, which edubfm_AllocTrain() only fills.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubfm_CheckpointTick(void)
+{
+    Four		e;			/* error code */
+
+
+    if (edubfm_checkpointPolicy.interval <= 0) return( eNOERROR );
+
+    if (++edubfm_nTicks < edubfm_checkpointPolicy.interval) return( eNOERROR );
+    edubfm_nTicks = 0;
+
+    if (edubfm_evictPolicy.mode == EVICT_MODE_CLEANFIRST && edubfm_evictPolicy.writeBehind > 0) {
+        e = edubfm_DrainWriteQueue(edubfm_evictPolicy.writeBehind);
+        if (e < 0) ERR(e);
+    }
+
+    e = edubfm_CheckpointStep(edubfm_checkpointPolicy.nPagesPerStep);
+    if (e < 0) ERR(e);
+
+    return( eNOERROR );
+
+}  /* edubfm_CheckpointTick */
@@ -0,0 +1,334 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_DoubleWrite.c
+ *
+ * Description :
+ *  Protect pages written in place against torn writes with a double-write
+ *  buffer. Trains to be written are collected into a batch; the batch is
+ *  written with one sequential write into the double-write file, which is
+ *  synced once, and only then are the trains written in place. A crash
+ *  while writing in place leaves an intact copy of every page in the
+ *  double-write file, from which EduBfM_RecoverDoubleWrite() repairs it.
+ *  Before the double-write file is overwritten by the next batch, the
+ *  in-place writes of the previous batch are made durable with one sync
+ *  of the file system holding the double-write file, which therefore has
+ *  to be the file system of the volumes.
+ *  Callers writing many trains in a row open a batch with edubfm_DwbBegin()
+ *  and close it with edubfm_DwbEnd(); a train written outside a batch forms
+ *  a batch by itself.
+ *
+ * Exports:
+ *  UFour edubfm_DwbChecksum(char *, Four)
+ *  void edubfm_DwbBegin(void)
+ *  Four edubfm_DwbEnd(void)
+ *  Four edubfm_DwbWrite(TrainID *, char *, Two, Boolean)
+ *  Four edubfm_DwbFlush(void)
+ */
+
+
+#define _GNU_SOURCE				/* for syncfs() */
+#include <unistd.h>
+#include <string.h>
+#include "EduBfM_common.h"
+#include "RDsM.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@
+ * Global Variables
+ */
+/* the double-write buffer; disabled until a double-write file is given */
+BfMDoubleWrite edubfm_dwb = { NIL, NULL, 0, 0 };
+
+/* statistics of the double-write buffer */
+BfMDwbStat edubfm_dwbStat;
+
+
+
+/*@================================
+ * edubfm_DwbChecksum()
+ *================================*/
+/*
+ * Function: UFour edubfm_DwbChecksum(char*, Four)
+ *
+ * Description :
+ *  Compute the 32 bit FNV-1a checksum of 'len' bytes starting at 'data'.
+ *
+ * Returns:
+ *  checksum
+ */
+UFour edubfm_DwbChecksum(
+    char		*data,			/* IN bytes to be checksummed */
+    Four		len)			/* IN # of bytes */
+{
+    Four		i;				/* loop index */
+    UFour		h;				/* checksum */
+
+
+    for (h = 2166136261U, i = 0; i < len; i++)
+        h = (h ^ (unsigned char)data[i]) * 16777619U;
+
+    return( h );
+
+}  /* edubfm_DwbChecksum */
+
+
+
+/*@================================
+ * edubfm_DwbBegin()
+ *================================*/
+/*
+ * Function: void edubfm_DwbBegin(void)
+ *
+ * Description :
+ *  Open a batch; trains written until the matching edubfm_DwbEnd() are
+ *  written together. Batches may be nested; the outermost one counts.
+ *  No train written into an open batch may be read from the disk before
+ *  the batch is closed.
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_DwbBegin(void)
+{
+    edubfm_dwb.depth++;
+
+}  /* edubfm_DwbBegin */
+
+
+
+/*@================================
+ * edubfm_DwbEnd()
+ *================================*/
+/*
+ * Function: Four edubfm_DwbEnd(void)
+ *
+ * Description :
+ *  Close a batch opened by edubfm_DwbBegin(); closing the outermost batch
+ *  writes it.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubfm_DwbEnd(void)
+{
+    Four		e;				/* error code */
+
+
+    if (edubfm_dwb.depth > 0 && --edubfm_dwb.depth == 0 && edubfm_dwb.nPages > 0) {
+        e = edubfm_DwbFlush();
+        if (e < 0) ERR(e);
+    }
+
+    return( eNOERROR );
+
+}  /* edubfm_DwbEnd */
+
+
+
+/*@================================
+ * edubfm_DwbWrite()
+ *================================*/
+/*
+ * Function: Four edubfm_DwbWrite(TrainID*, char*, Two, Boolean)
+ *
+ * Description :
+ *  Write a train of 'trainSize' pages. If the double-write buffer is
+ *  disabled, the train is written in place at once; otherwise its image
+ *  is copied into the batch, which is written when it becomes full or, if
+ *  no batch is open, right away. A train longer than the batch is cut
+ *  into pieces.
+ *  If 'sync' is TRUE the caller waits for the emulated write, otherwise
+ *  the write proceeds in the background.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubfm_DwbWrite(
+    TrainID		*trainId,		/* IN train to write */
+    char		*aTrain,		/* IN buffer of the train */
+    Two			trainSize,		/* IN size of the train in pages */
+    Boolean		sync)			/* IN TRUE if the caller waits for the write */
+{
+    Four		e;				/* error code */
+    Four		i;				/* loop index */
+    Two			done;			/* # of pages copied into the batch */
+    Two			piece;			/* # of pages of the current piece */
+    BfMDwbEntry	*entry;			/* entry of the current piece */
+    BfMDwbHeader *header;		/* header of the batch */
+
+
+    if (edubfm_dwb.fd == NIL) {
+        if (sync) return( edubfm_EmulWriteTrain(aTrain, trainId, trainSize) );
+
+        e = edubfm_TrainIO(TRUE, trainId, aTrain, trainSize);
+        if (e < 0) ERR(e);
+        (void) edubfm_IOEmulCharge(TRUE, trainSize, FALSE);
+
+        return( eNOERROR );
+    }
+
+    header = (BfMDwbHeader *)edubfm_dwb.area;
+
+    for (done = 0; done < trainSize; done += piece) {
+
+        if (edubfm_dwb.nPages == DWB_MAX_PAGES) {
+            e = edubfm_DwbFlush();
+            if (e < 0) ERR(e);
+        }
+
+        piece = trainSize - done;
+        if (piece > DWB_MAX_PAGES - edubfm_dwb.nPages) piece = DWB_MAX_PAGES - edubfm_dwb.nPages;
+
+        entry = &edubfm_dwb.entries[edubfm_dwb.nEntries++];
+        entry->trainId.volNo = trainId->volNo;
+        entry->trainId.pageNo = trainId->pageNo + done;
+        entry->nPages = piece;
+        entry->slot = edubfm_dwb.nPages;
+
+        for (i = 0; i < piece; i++) {
+            header->slots[edubfm_dwb.nPages].volNo = trainId->volNo;
+            header->slots[edubfm_dwb.nPages].pageNo = trainId->pageNo + done + i;
+            memcpy(edubfm_dwb.area + (size_t)PAGESIZE * (1 + edubfm_dwb.nPages),
+                   aTrain + (size_t)PAGESIZE * (done + i), PAGESIZE);
+            edubfm_dwb.nPages++;
+        }
+    }
+
+    if (sync) edubfm_dwb.sync = TRUE;
+
+    if (edubfm_dwb.depth == 0) {
+        e = edubfm_DwbFlush();
+        if (e < 0) ERR(e);
+    }
+
+    return( eNOERROR );
+
+}  /* edubfm_DwbWrite */
+
+
+
+/*@================================
+ * edubfm_DwbFlush()
+ *================================*/
+/*
+ * Function: Four edubfm_DwbFlush(void)
+ *
+ * Description :
+ *  Write the batch: make the in-place writes of the previous batch
+ *  durable, write the header and the page images into the double-write
+ *  file with one write and sync it, then write the pieces in place.
+ *  The write into the double-write file is charged to the emulated device
+ *  as one sequential request; the caller waits for it if any train of the
+ *  batch was written synchronously. The in-place writes proceed in the
+ *  background.
+ *
+ * Returns:
+ *  error code
+ *    eDWBIOERR_EDUBFM - the double-write file cannot be written or synced
+ *    some errors caused by function calls
+ */
+Four edubfm_DwbFlush(void)
+{
+    Four		e;				/* error code */
+    Four		i;				/* loop index */
+    size_t		len;			/* # of bytes written into the double-write file */
+    BfMDwbEntry	*entry;			/* entry of a piece */
+    BfMDwbHeader *header;		/* header of the batch */
+
+
+    if (edubfm_dwb.fd == NIL || edubfm_dwb.nPages == 0) return( eNOERROR );
+
+    if (edubfm_dwb.unsynced) {
+        if (syncfs(edubfm_dwb.fd) < 0) ERR(eDWBIOERR_EDUBFM);
+        edubfm_dwbStat.nSyncs++;
+        edubfm_dwb.unsynced = FALSE;
+    }
+
+    header = (BfMDwbHeader *)edubfm_dwb.area;
+    header->magic = DWB_MAGIC;
+    header->seq = edubfm_dwb.seq++;
+    header->nPages = edubfm_dwb.nPages;
+    for (i = 0; i < edubfm_dwb.nPages; i++)
+        header->slots[i].checksum = edubfm_DwbChecksum(edubfm_dwb.area + (size_t)PAGESIZE * (1 + i), PAGESIZE);
+    header->checksum = 0;
+    header->checksum = edubfm_DwbChecksum((char *)header, sizeof(BfMDwbHeader));
+
+    len = (size_t)PAGESIZE * (1 + edubfm_dwb.nPages);
+    if (pwrite(edubfm_dwb.fd, edubfm_dwb.area, len, 0) != len) ERR(eDWBIOERR_EDUBFM);
+    if (fdatasync(edubfm_dwb.fd) < 0) ERR(eDWBIOERR_EDUBFM);
+    edubfm_dwbStat.nSyncs++;
+
+    (void) edubfm_IOEmulCharge(TRUE, 1 + edubfm_dwb.nPages, edubfm_dwb.sync);
+
+    for (i = 0; i < edubfm_dwb.nEntries; i++) {
+        entry = &edubfm_dwb.entries[i];
+
+        e = edubfm_TrainIO(TRUE, &entry->trainId,
+                           edubfm_dwb.area + (size_t)PAGESIZE * (1 + entry->slot), entry->nPages);
+        if (e < 0) ERR(e);
+
+        (void) edubfm_IOEmulCharge(TRUE, entry->nPages, FALSE);
+    }
+
+    edubfm_dwbStat.nBatches++;
+    edubfm_dwbStat.nPagesWritten += edubfm_dwb.nPages;
+
+    edubfm_dwb.unsynced = TRUE;
+    edubfm_dwb.nPages = 0;
+    edubfm_dwb.nEntries = 0;
+    edubfm_dwb.sync = FALSE;
+
+    return( eNOERROR );
+
+}  /* edubfm_DwbFlush */
@@ -103,9 +103,10 @@ Four edubfm_FlushTrain(
     index= edubfm_LookUp(&key,type);
 
     if(BI_BITS(type,index)&DIRTY){
-        /* Write the page into the disk */
-        e = RDsM_WriteTrain(BI_BUFFER(type, index), trainId, BI_BUFSIZE(type));
+        /* Write the page into the disk (through the double-write buffer and the device emulation) */
+        e = edubfm_DwbWrite(trainId, BI_BUFFER(type, index), BI_BUFSIZE(type), TRUE);
         if( e < 0 ) ERR( eNOTFOUND_BFM );
+        edubfm_classStat[type].nWrites++;
     }
 
     BI_BITS(type,index)&=~DIRTY;
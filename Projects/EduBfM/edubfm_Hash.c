@@ -118,9 +118,7 @@ Four edubfm_Insert(
 
     hashValue=(key->volNo + key->pageNo)%HASHTABLESIZE(type);
 
-    if(BI_HASHTABLEENTRY(type,hashValue)!=-1){
-        BI_NEXTHASHENTRY(type,index)=BI_HASHTABLEENTRY(type,hashValue);
-    }
+    BI_NEXTHASHENTRY(type,index)=BI_HASHTABLEENTRY(type,hashValue);
     BI_HASHTABLEENTRY(type,hashValue)=index;
 
     return( eNOERROR );
@@ -160,24 +158,19 @@ Four edubfm_Delete(
 
     hashValue=(key->volNo + key->pageNo)%HASHTABLESIZE(type);
 
+    prev=-1;
     hashentry= BI_HASHTABLEENTRY(type,hashValue);
-    if(hashentry!=-1){
-
-        if(BI_NEXTHASHENTRY(type,hashentry)==-1){
-                BI_HASHTABLEENTRY(type,hashValue)=-1;
-                return( eNOERROR );
-        }
-
-        while(1){
-            if(EQUALKEY(key,&BI_KEY(type,hashentry))){
-                BI_NEXTHASHENTRY(type,prev)=-1;
-                return( eNOERROR );
-            }
-            else{
-                prev=hashentry;
-                hashentry=BI_NEXTHASHENTRY(type,hashentry);
-            }
+    while(hashentry!=-1){
+        if(EQUALKEY(key,&BI_KEY(type,hashentry))){
+            if(prev==-1)
+                BI_HASHTABLEENTRY(type,hashValue)=BI_NEXTHASHENTRY(type,hashentry);
+            else
+                BI_NEXTHASHENTRY(type,prev)=BI_NEXTHASHENTRY(type,hashentry);
+            BI_NEXTHASHENTRY(type,hashentry)=-1;
+            return( eNOERROR );
         }
+        prev=hashentry;
+        hashentry=BI_NEXTHASHENTRY(type,hashentry);
     }
 
     ERR( eNOTFOUND_BFM );
@@ -218,15 +211,14 @@ Four edubfm_LookUp(
 
     index= BI_HASHTABLEENTRY(type,hashValue);
 
-    while(1){
+    while(index!=-1){
         if(EQUALKEY(key,&BI_KEY(type,index))){
             return index;
         }
         index= BI_NEXTHASHENTRY(type,index);
-        if(index==-1){
-            return(NOTFOUND_IN_HTABLE);
-        }
-    } 
+    }
+
+    return(NOTFOUND_IN_HTABLE);
 }  /* edubfm_LookUp */
 
 
@@ -253,7 +245,7 @@ Four edubfm_DeleteAll(void)
     Four    tableSize;
     Four    type;
 
-    for(type=PAGE_BUF;type<=LOT_LEAF_BUF;type++){
+    for(type=PAGE_BUF;type<NUM_BUF_TYPES;type++){
         tableSize=HASHTABLESIZE(type);
         for(i=0;i<tableSize;i++){
             BI_HASHTABLEENTRY(type,i)=-1;
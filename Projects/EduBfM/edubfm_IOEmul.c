@@ -0,0 +1,482 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_IOEmul.c
+ *
+ * Description :
+ *  Emulate the latency, bandwidth and queue depth of a storage device
+ *  underneath RDsM_ReadTrain()/RDsM_WriteTrain().
+ *  The emulated cost of every I/O is charged to a virtual clock so that
+ *  results are repeatable on a host whose page cache hides the real cost;
+ *  optionally the caller is also put to sleep for the emulated wait.
+ *  A read may also be issued without waiting for it; the completion time
+ *  is then remembered per buffer element until someone waits for it.
+ *  RDsM transfers trains of 1 or RDSM_MAX_TRAINSIZE pages only, so a
+ *  longer train is transferred in pieces but charged as one request.
+ *
+ * Exports:
+ *  Four edubfm_TrainIO(Boolean, TrainID *, char *, Two)
+ *  Four edubfm_InitReadyTime(void)
+ *  void edubfm_IOEmulWait(double)
+ *  Four edubfm_EmulReadTrain(TrainID *, char *, Two)
+ *  Four edubfm_EmulReadTrainAsync(TrainID *, char *, Two, double *)
+ *  Four edubfm_EmulWriteTrain(char *, TrainID *, Two)
+ *  double edubfm_IOEmulCharge(Boolean, Four, Boolean)
+ */
+
+
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "EduBfM_common.h"
+#include "RDsM.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@
+ * Global Variables
+ */
+/* predefined device profiles, indexed by IOEMUL_PROFILE_xxx */
+BfMIOProfile edubfm_ioProfiles[IOEMUL_NUM_PROFILES] = {
+    /* name      enabled dist                     rdLat wrLat jitter  bandwidth  qd  realDelay seed */
+    { "none",    FALSE,  IOEMUL_DIST_CONSTANT,        0,    0,     0,         0,  1, FALSE,    1 },
+    { "hdd",     TRUE,   IOEMUL_DIST_UNIFORM,      8000, 8500,  4000,    153600,  1, FALSE,    1 },
+    { "satassd", TRUE,   IOEMUL_DIST_UNIFORM,       100,   60,    40,    552960, 32, FALSE,    1 },
+    { "nvme",    TRUE,   IOEMUL_DIST_EXPONENTIAL,    20,   15,     0,   3276800, 64, FALSE,    1 }
+};
+
+/* the profile in effect */
+BfMIOProfile edubfm_ioProfile = { "none", FALSE, IOEMUL_DIST_CONSTANT, 0, 0, 0, 0, 1, FALSE, 1 };
+
+/* I/O statistics since the last reset */
+BfMIOStat edubfm_ioStat;
+
+/* time at which each device queue slot becomes free (on the virtual clock) */
+static double edubfm_queueFree[IOEMUL_MAX_QUEUEDEPTH];
+
+/* time at which the transfer channel becomes free (on the virtual clock) */
+static double edubfm_channelFree;
+
+/* state of the latency generator */
+static UFour edubfm_ioRandState = 1;
+
+/* completion time of the last read into each buffer element (on the virtual clock) */
+double *edubfm_readyTime[MAX_BUF_TYPES];
+
+
+
+/*@================================
+ * edubfm_IOEmulRandom()
+ *================================*/
+/*
+ * Function: double edubfm_IOEmulRandom(void)
+ *
+ * Description :
+ *  Return a pseudo random number uniformly distributed in [0, 1).
+ *  A private generator is used so that the sampled latencies depend only on
+ *  the seed of the profile.
+ *
+ * Returns:
+ *  a random number in [0, 1)
+ */
+static double edubfm_IOEmulRandom(void)
+{
+    edubfm_ioRandState = edubfm_ioRandState * 1103515245 + 12345;
+
+    return( (double)((edubfm_ioRandState >> 8) & 0xffffff) / (double)0x1000000 );
+
+}  /* edubfm_IOEmulRandom */
+
+
+
+/*@================================
+ * edubfm_InitReadyTime()
+ *================================*/
+/*
+ * Function: Four edubfm_InitReadyTime(void)
+ *
+ * Description :
+ *  Allocate the ready time side tables of the buffer pools if not yet
+ *  allocated.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR_EDUBFM - memory allocation error
+ */
+Four edubfm_InitReadyTime(void)
+{
+    Four		type;			/* buffer type */
+    Four		i;
+
+
+    for (type = PAGE_BUF; type < NUM_BUF_TYPES; type++) {
+        if (edubfm_readyTime[type] != NULL || BI_NBUFS(type) <= 0) continue;
+
+        edubfm_readyTime[type] = (double *)malloc(sizeof(double) * BI_NBUFS(type));
+        if (edubfm_readyTime[type] == NULL) ERR(eMEMORYALLOCERR_EDUBFM);
+        for (i = 0; i < BI_NBUFS(type); i++) BI_READYTIME(type, i) = 0.0;
+    }
+
+    return( eNOERROR );
+
+}  /* edubfm_InitReadyTime */
+
+
+
+/*@================================
+ * edubfm_IOEmulReset()
+ *================================*/
+/*
+ * Function: void edubfm_IOEmulReset(void)
+ *
+ * Description :
+ *  Reset the virtual clock, the device queue and the statistics.
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_IOEmulReset(void)
+{
+    Four	i;
+    Four	type;
+
+
+    for (i = 0; i < IOEMUL_MAX_QUEUEDEPTH; i++)
+        edubfm_queueFree[i] = 0.0;
+    edubfm_channelFree = 0.0;
+
+    /* the clock goes back to 0, so pending completion times lose their meaning */
+    for (type = PAGE_BUF; type < NUM_BUF_TYPES; type++)
+        if (edubfm_readyTime[type] != NULL)
+            for (i = 0; i < BI_NBUFS(type); i++) BI_READYTIME(type, i) = 0.0;
+
+    edubfm_ioStat.nReads = edubfm_ioStat.nWrites = 0;
+    edubfm_ioStat.nPagesRead = edubfm_ioStat.nPagesWritten = 0;
+    edubfm_ioStat.busyTime = edubfm_ioStat.waitTime = 0.0;
+    edubfm_ioStat.clock = 0.0;
+
+    edubfm_ioRandState = (edubfm_ioProfile.seed == 0) ? 1 : edubfm_ioProfile.seed;
+
+}  /* edubfm_IOEmulReset */
+
+
+
+/*@================================
+ * edubfm_IOEmulCharge()
+ *================================*/
+/*
+ * Function: double edubfm_IOEmulCharge(Boolean, Four, Boolean)
+ *
+ * Description :
+ *  Charge one I/O of 'nPages' pages to the emulated device.
+ *  The request is issued at the current virtual time and is served by the
+ *  queue slot that becomes free first; the transfer itself is serialized on
+ *  a single channel limited by the bandwidth cap.
+ *  If 'sync' is TRUE the caller waits for the completion, i.e. the virtual
+ *  clock advances to the completion time; otherwise the request proceeds in
+ *  the background and only occupies the device.
+ *
+ * Returns:
+ *  completion time of the request on the virtual clock (usec)
+ */
+double edubfm_IOEmulCharge(
+    Boolean		isWrite,		/* IN TRUE if the request is a write */
+    Four		nPages,			/* IN # of pages transferred */
+    Boolean		sync)			/* IN TRUE if the caller waits for the request */
+{
+    Four		i;
+    Four		slot;			/* queue slot serving the request */
+    Four		qd;				/* effective queue depth */
+    double		mean;			/* mean latency of the request */
+    double		latency;		/* sampled latency of the request */
+    double		xfer;			/* transfer time of the request */
+    double		start;			/* time the device starts serving the request */
+    double		done;			/* completion time */
+
+
+    if (isWrite) {
+        edubfm_ioStat.nWrites++;
+        edubfm_ioStat.nPagesWritten += nPages;
+    }
+    else {
+        edubfm_ioStat.nReads++;
+        edubfm_ioStat.nPagesRead += nPages;
+    }
+
+    if (!edubfm_ioProfile.enabled) return( edubfm_ioStat.clock );
+
+    /*@ sample the latency */
+    mean = isWrite ? edubfm_ioProfile.writeLatency : edubfm_ioProfile.readLatency;
+    switch (edubfm_ioProfile.dist) {
+      case IOEMUL_DIST_UNIFORM:
+        latency = mean + edubfm_ioProfile.jitter * (2.0 * edubfm_IOEmulRandom() - 1.0);
+        break;
+      case IOEMUL_DIST_EXPONENTIAL:
+        latency = -mean * log(1.0 - edubfm_IOEmulRandom());
+        break;
+      default:
+        latency = mean;
+    }
+    if (latency < 0.0) latency = 0.0;
+
+    /*@ transfer time under the bandwidth cap (KB/sec -> usec) */
+    if (edubfm_ioProfile.bandwidth > 0)
+        xfer = (double)nPages * (PAGESIZE / 1024.0) * 1000000.0 / edubfm_ioProfile.bandwidth;
+    else
+        xfer = 0.0;
+
+    /*@ pick the queue slot which becomes free first */
+    qd = edubfm_ioProfile.queueDepth;
+    if (qd < 1) qd = 1;
+    if (qd > IOEMUL_MAX_QUEUEDEPTH) qd = IOEMUL_MAX_QUEUEDEPTH;
+    for (slot = 0, i = 1; i < qd; i++)
+        if (edubfm_queueFree[i] < edubfm_queueFree[slot]) slot = i;
+
+    start = MAX(edubfm_ioStat.clock, edubfm_queueFree[slot]);
+    /* the transfer follows the access, once the channel is free */
+    done = MAX(start + latency, edubfm_channelFree) + xfer;
+    edubfm_channelFree = done;
+    edubfm_queueFree[slot] = done;
+    edubfm_ioStat.busyTime += done - start;
+
+    if (sync) edubfm_IOEmulWait(done);
+
+    return( done );
+
+}  /* edubfm_IOEmulCharge */
+
+
+
+/*@================================
+ * edubfm_IOEmulWait()
+ *================================*/
+/*
+ * Function: void edubfm_IOEmulWait(double)
+ *
+ * Description :
+ *  Block the caller until the virtual time 'doneTime', i.e. advance the
+ *  virtual clock to it and account the wait. Nothing happens if the time
+ *  has already passed.
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_IOEmulWait(
+    double		doneTime)		/* IN completion time waited for */
+{
+    struct timespec	ts;
+
+
+    if (doneTime <= edubfm_ioStat.clock) return;
+
+    edubfm_ioStat.waitTime += doneTime - edubfm_ioStat.clock;
+
+    if (edubfm_ioProfile.realDelay) {
+        ts.tv_sec = (time_t)((doneTime - edubfm_ioStat.clock) / 1000000.0);
+        ts.tv_nsec = (long)(((doneTime - edubfm_ioStat.clock) - ts.tv_sec * 1000000.0) * 1000.0);
+        nanosleep(&ts, NULL);
+    }
+
+    edubfm_ioStat.clock = doneTime;
+
+}  /* edubfm_IOEmulWait */
+
+
+
+/*@================================
+ * edubfm_TrainIO()
+ *================================*/
+/*
+ * Function: Four edubfm_TrainIO(Boolean, TrainID*, char*, Two)
+ *
+ * Description :
+ *  Read or write a train of 'trainSize' consecutive pages through RDsM.
+ *  The train is cut into pieces of the sizes RDsM accepts.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by RDsM_ReadTrain()/RDsM_WriteTrain()
+ */
+Four edubfm_TrainIO(
+    Boolean		isWrite,		/* IN TRUE to write the train */
+    TrainID		*trainId,		/* IN train to transfer */
+    char		*aTrain,		/* INOUT buffer of the train */
+    Two			trainSize)		/* IN size of the train in pages */
+{
+    Four		e;				/* for error */
+    Two			done;			/* # of pages transferred */
+    Two			piece;			/* # of pages of the current piece */
+    TrainID		pieceId;		/* first page of the current piece */
+
+
+    if (trainSize == 1 || trainSize == RDSM_MAX_TRAINSIZE)
+        return( isWrite ? RDsM_WriteTrain(aTrain, trainId, trainSize)
+                        : RDsM_ReadTrain(trainId, aTrain, trainSize) );
+
+    pieceId = *trainId;
+    for (done = 0; done < trainSize; done += piece) {
+        piece = (trainSize - done >= RDSM_MAX_TRAINSIZE) ? RDSM_MAX_TRAINSIZE : 1;
+        pieceId.pageNo = trainId->pageNo + done;
+
+        if (isWrite)
+            e = RDsM_WriteTrain(aTrain + (size_t)PAGESIZE * done, &pieceId, piece);
+        else
+            e = RDsM_ReadTrain(&pieceId, aTrain + (size_t)PAGESIZE * done, piece);
+        if (e < 0) return(e);
+    }
+
+    return( eNOERROR );
+
+}  /* edubfm_TrainIO */
+
+
+
+/*@================================
+ * edubfm_EmulReadTrain()
+ *================================*/
+/*
+ * Function: Four edubfm_EmulReadTrain(TrainID*, char*, Two)
+ *
+ * Description :
+ *  Read a train through RDsM_ReadTrain() and charge the emulated cost of
+ *  the read to the caller.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by RDsM_ReadTrain()
+ */
+Four edubfm_EmulReadTrain(
+    TrainID		*trainId,		/* IN train to read */
+    char		*aTrain,		/* OUT buffer to be filled */
+    Two			trainSize)		/* IN size of the train in pages */
+{
+    Four		e;				/* for error */
+
+
+    e = edubfm_TrainIO(FALSE, trainId, aTrain, trainSize);
+    if (e < 0) return(e);
+
+    (void) edubfm_IOEmulCharge(FALSE, trainSize, TRUE);
+
+    return( eNOERROR );
+
+}  /* edubfm_EmulReadTrain */
+
+
+
+/*@================================
+ * edubfm_EmulReadTrainAsync()
+ *================================*/
+/*
+ * Function: Four edubfm_EmulReadTrainAsync(TrainID*, char*, Two, double*)
+ *
+ * Description :
+ *  Read a train through RDsM_ReadTrain() without waiting for the emulated
+ *  device; the caller gets the completion time of the read and must not
+ *  look at the buffer before the virtual clock has reached it.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by RDsM_ReadTrain()
+ *
+ * Side effects:
+ *  1) parameter doneTime
+ *     completion time of the read on the virtual clock
+ */
+Four edubfm_EmulReadTrainAsync(
+    TrainID		*trainId,		/* IN train to read */
+    char		*aTrain,		/* OUT buffer to be filled */
+    Two			trainSize,		/* IN size of the train in pages */
+    double		*doneTime)		/* OUT completion time of the read */
+{
+    Four		e;				/* for error */
+
+
+    e = edubfm_TrainIO(FALSE, trainId, aTrain, trainSize);
+    if (e < 0) return(e);
+
+    *doneTime = edubfm_IOEmulCharge(FALSE, trainSize, FALSE);
+
+    return( eNOERROR );
+
+}  /* edubfm_EmulReadTrainAsync */
+
+
+
+/*@================================
+ * edubfm_EmulWriteTrain()
+ *================================*/
+/*
+ * Function: Four edubfm_EmulWriteTrain(char*, TrainID*, Two)
+ *
+ * Description :
+ *  Write a train through RDsM_WriteTrain() and charge the emulated cost of
+ *  the write to the caller.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by RDsM_WriteTrain()
+ */
+Four edubfm_EmulWriteTrain(
+    char		*aTrain,		/* IN buffer to be written */
+    TrainID		*trainId,		/* IN train to write */
+    Two			trainSize)		/* IN size of the train in pages */
+{
+    Four		e;				/* for error */
+
+
+    e = edubfm_TrainIO(TRUE, trainId, aTrain, trainSize);
+    if (e < 0) return(e);
+
+    (void) edubfm_IOEmulCharge(TRUE, trainSize, TRUE);
+
+    return( eNOERROR );
+
+}  /* edubfm_EmulWriteTrain */
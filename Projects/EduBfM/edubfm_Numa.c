@@ -0,0 +1,216 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_Numa.c
+ *
+ * Description :
+ *  Partition the buffer pools over a simulated NUMA topology.
+ *  Each buffer pool is split into one contiguous partition per node with
+ *  its own clock hand. Every page key has a home node, and every thread
+ *  runs on a current node set by EduBfM_SetCurrentNode(); a buffer access
+ *  is local if the buffer lies in the partition of the current node.
+ *
+ * Exports:
+ *  Four edubfm_NumaCurrentNode(void)
+ *  Four edubfm_NumaPlacementNode(BfMHashKey *)
+ *  Four edubfm_NumaAllocTrain(Four, Four)
+ *  void edubfm_NumaCountAccess(Four, Four)
+ */
+
+
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+/* # of consecutive pages mapped to the same home node, so that
+ * sequential scans over an extent stay within a node */
+#define NUMA_HOME_CHUNK 16
+
+
+
+/*@
+ * Global Variables
+ */
+/* the simulated topology; a single node means no partitioning */
+BfMNumaTopology edubfm_numaTopology = { 1, NUMA_PLACE_LOCAL, 0 };
+
+/* NUMA access statistics */
+BfMNumaStat edubfm_numaStat;
+
+/* clock hand of each partition */
+UTwo edubfm_numaHand[MAX_BUF_TYPES][NUMA_MAX_NODES];
+
+/* the node the calling thread runs on */
+__thread Four edubfm_currentNode = 0;
+
+
+
+/*@================================
+ * edubfm_NumaCurrentNode()
+ *================================*/
+/*
+ * Function: Four edubfm_NumaCurrentNode(void)
+ *
+ * Description :
+ *  Return the node the calling thread runs on.
+ *
+ * Returns:
+ *  NUMA node
+ */
+Four edubfm_NumaCurrentNode(void)
+{
+
+    return( edubfm_currentNode < edubfm_numaTopology.nNodes ? edubfm_currentNode : 0 );
+
+}  /* edubfm_NumaCurrentNode */
+
+
+
+/*@================================
+ * edubfm_NumaPlacementNode()
+ *================================*/
+/*
+ * Function: Four edubfm_NumaPlacementNode(BfMHashKey*)
+ *
+ * Description :
+ *  Return the node in whose partition the page/train 'key' should be
+ *  placed when it is read into the buffer pool: the current node, so that
+ *  a miss prefers the partition local to the accessing worker, or the home
+ *  node of the page under NUMA_PLACE_HOME.
+ *
+ * Returns:
+ *  NUMA node
+ */
+Four edubfm_NumaPlacementNode(
+    BfMHashKey		*key)			/* IN page/train to be placed */
+{
+
+    if (edubfm_numaTopology.placement == NUMA_PLACE_HOME)
+        return( ((key)->volNo + (key)->pageNo / NUMA_HOME_CHUNK) % edubfm_numaTopology.nNodes );
+
+    return( edubfm_NumaCurrentNode() );
+
+}  /* edubfm_NumaPlacementNode */
+
+
+
+/*@================================
+ * edubfm_NumaAllocTrain()
+ *================================*/
+/*
+ * Function: Four edubfm_NumaAllocTrain(Four, Four)
+ *
+ * Description :
+ *  Allocate a new buffer from the partition of the node 'node'.
+ *  If the partition has no unfixed buffer, the partitions of the other
+ *  nodes are tried in turn and a spill is counted.
+ *
+ * Returns:
+ *  1) An index of a new buffer from the buffer pool
+ *  2) Error codes: Negative value means error code.
+ *     eNOUNFIXEDBUF_BFM - There is no unfixed buffer.
+ *     some errors caused by fuction calls
+ */
+Four edubfm_NumaAllocTrain(
+    Four		type,			/* IN buffer type */
+    Four		node)			/* IN preferred node */
+{
+    Four		e;			/* error code or index of the buffer */
+    Four		i;			/* loop index */
+
+
+    for (i = 0; i < edubfm_numaTopology.nNodes; i++) {
+
+        e = edubfm_AllocTrainInPartition(type, (node + i) % edubfm_numaTopology.nNodes);
+        if (e == eNOUNFIXEDBUF_BFM) continue;
+        if (e < 0) ERR(e);
+
+        if (i > 0) edubfm_numaStat.nSpills[edubfm_NumaCurrentNode()]++;
+
+        return( e );
+    }
+
+    ERR(eNOUNFIXEDBUF_BFM);
+
+}  /* edubfm_NumaAllocTrain */
+
+
+
+/*@================================
+ * edubfm_NumaCountAccess()
+ *================================*/
+/*
+ * Function: void edubfm_NumaCountAccess(Four, Four)
+ *
+ * Description :
+ *  Count an access of the current node to the buffer element 'index' of
+ *  the buffer pool 'type' as a local or remote access.
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_NumaCountAccess(
+    Four		type,			/* IN buffer type */
+    Four		index)			/* IN array index of the buffer element */
+{
+    Four		node;			/* current node */
+
+
+    if (edubfm_numaTopology.nNodes <= 1) return;
+
+    node = edubfm_NumaCurrentNode();
+
+    if (NUMA_NODE_OF(type, index) == node)
+        edubfm_numaStat.nLocal[node]++;
+    else {
+        edubfm_numaStat.nRemote[node]++;
+        edubfm_numaStat.remoteCost += edubfm_numaTopology.remoteLatency;
+    }
+
+}  /* edubfm_NumaCountAccess */
@@ -0,0 +1,353 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_PinDebug.c
+ *
+ * Description :
+ *  Pin leak and long pin detection (compiled only with EDUBFM_PIN_DEBUG).
+ *  The wrappers below stand in for EduBfM_GetTrain(), EduBfM_GetTrainAsync()
+ *  and EduBfM_FreeTrain() at the call sites; each fix is recorded with the
+ *  source location and time of the call and dropped again by the matching
+ *  free. Pins held longer than the threshold are reported once when the
+ *  next fix is made, and the pins still outstanding are printed on demand.
+ *
+ * Exports:
+ *  Four edubfm_PinGetTrain(TrainID *, char **, Four, char *, Four)
+ *  Four edubfm_PinGetTrainAsync(BfMGetTrainReq *, TrainID *, Four, char *, Four)
+ *  Four edubfm_PinFreeTrain(TrainID *, Four, char *, Four)
+ *  double edubfm_PinDebugNow(void)
+ *  Four edubfm_PinDebugCheck(Boolean)
+ *  void edubfm_PinDebugDump(char *)
+ */
+
+
+#define EDUBFM_PIN_NOWRAP
+#include <stdio.h>
+#include <sys/time.h>
+#include "EduBfM_common.h"
+#include "EduBfM.h"
+
+
+#ifdef EDUBFM_PIN_DEBUG
+
+/*@
+ * Global Variables
+ */
+/* the pins being held */
+BfMPinRecord edubfm_pins[PIN_DEBUG_MAX_PINS];
+
+/* time a pin may be held before it is reported (usec) */
+Four edubfm_pinThreshold = PIN_DEBUG_DEFAULT_THRESHOLD;
+
+
+/*@ Internal Function Prototypes */
+static void edubfm_PinRecord(Four, TrainID *, char *, Four);
+
+
+
+/*@================================
+ * edubfm_PinDebugNow()
+ *================================*/
+/*
+ * Function: double edubfm_PinDebugNow(void)
+ *
+ * Description :
+ *  Return the current wall clock time.
+ *
+ * Returns:
+ *  time in usec
+ */
+double edubfm_PinDebugNow(void)
+{
+    struct timeval	tv;
+
+
+    gettimeofday(&tv, NULL);
+
+    return( tv.tv_sec * 1000000.0 + tv.tv_usec );
+
+}  /* edubfm_PinDebugNow */
+
+
+
+/*@================================
+ * edubfm_PinRecord()
+ *================================*/
+/*
+ * Function: static void edubfm_PinRecord(Four, TrainID*, char*, Four)
+ *
+ * Description :
+ *  Record a pin of the train 'trainId' made at 'file':'line'.
+ *
+ * Returns:
+ *  None
+ */
+static void edubfm_PinRecord(
+    Four		type,			/* IN buffer type */
+    TrainID		*trainId,		/* IN pinned train */
+    char		*file,			/* IN call site */
+    Four		line)
+{
+    Four		i;
+
+
+    for (i = 0; i < PIN_DEBUG_MAX_PINS; i++)
+        if (!edubfm_pins[i].inUse) break;
+
+    if (i == PIN_DEBUG_MAX_PINS) {
+        fprintf(stderr, "pin debug: too many pins, pin of {%ld, %ld} at %s:%ld not recorded\n",
+                (long)trainId->volNo, (long)trainId->pageNo, file, (long)line);
+        return;
+    }
+
+    edubfm_pins[i].inUse = TRUE;
+    edubfm_pins[i].reported = FALSE;
+    edubfm_pins[i].type = type;
+    edubfm_pins[i].key.volNo = trainId->volNo;
+    edubfm_pins[i].key.pageNo = trainId->pageNo;
+    edubfm_pins[i].file = file;
+    edubfm_pins[i].line = line;
+    edubfm_pins[i].fixTime = edubfm_PinDebugNow();
+
+}  /* edubfm_PinRecord */
+
+
+
+/*@================================
+ * edubfm_PinGetTrain()
+ *================================*/
+/*
+ * Function: Four edubfm_PinGetTrain(TrainID*, char**, Four, char*, Four)
+ *
+ * Description :
+ *  EduBfM_GetTrain() recording the pin made at 'file':'line'.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by EduBfM_GetTrain()
+ */
+Four edubfm_PinGetTrain(
+    TrainID		*trainId,		/* IN train to be used */
+    char		**retBuf,		/* OUT pointer to the returned buffer */
+    Four		type,			/* IN buffer type */
+    char		*file,			/* IN call site */
+    Four		line)
+{
+    Four		e;				/* error code */
+
+
+    e = EduBfM_GetTrain(trainId, retBuf, type);
+    if (e < 0) return(e);
+
+    edubfm_PinRecord(type, trainId, file, line);
+    (void) edubfm_PinDebugCheck(FALSE);
+
+    return( eNOERROR );
+
+}  /* edubfm_PinGetTrain */
+
+
+
+/*@================================
+ * edubfm_PinGetTrainAsync()
+ *================================*/
+/*
+ * Function: Four edubfm_PinGetTrainAsync(BfMGetTrainReq*, TrainID*, Four, char*, Four)
+ *
+ * Description :
+ *  EduBfM_GetTrainAsync() recording the pin made at 'file':'line'.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by EduBfM_GetTrainAsync()
+ */
+Four edubfm_PinGetTrainAsync(
+    BfMGetTrainReq	*req,			/* OUT request to be filled */
+    TrainID		*trainId,		/* IN train to be used */
+    Four		type,			/* IN buffer type */
+    char		*file,			/* IN call site */
+    Four		line)
+{
+    Four		e;				/* error code */
+
+
+    e = EduBfM_GetTrainAsync(req, trainId, type);
+    if (e < 0) return(e);
+
+    edubfm_PinRecord(type, trainId, file, line);
+    (void) edubfm_PinDebugCheck(FALSE);
+
+    return( eNOERROR );
+
+}  /* edubfm_PinGetTrainAsync */
+
+
+
+/*@================================
+ * edubfm_PinFreeTrain()
+ *================================*/
+/*
+ * Function: Four edubfm_PinFreeTrain(TrainID*, Four, char*, Four)
+ *
+ * Description :
+ *  EduBfM_FreeTrain() dropping the latest recorded pin of the train.
+ *  A free without a recorded pin is reported with its call site.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by EduBfM_FreeTrain()
+ */
+Four edubfm_PinFreeTrain(
+    TrainID		*trainId,		/* IN train to be freed */
+    Four		type,			/* IN buffer type */
+    char		*file,			/* IN call site */
+    Four		line)
+{
+    Four		e;				/* error code */
+    Four		i;
+    Four		latest;			/* latest pin of the train */
+
+
+    e = EduBfM_FreeTrain(trainId, type);
+    if (e < 0) return(e);
+
+    latest = NIL;
+    for (i = 0; i < PIN_DEBUG_MAX_PINS; i++) {
+        if (!edubfm_pins[i].inUse || edubfm_pins[i].type != type) continue;
+        if (edubfm_pins[i].key.volNo != trainId->volNo || edubfm_pins[i].key.pageNo != trainId->pageNo) continue;
+        if (latest == NIL || edubfm_pins[i].fixTime >= edubfm_pins[latest].fixTime) latest = i;
+    }
+
+    if (latest == NIL)
+        fprintf(stderr, "pin debug: free of unpinned train {%ld, %ld} at %s:%ld\n",
+                (long)trainId->volNo, (long)trainId->pageNo, file, (long)line);
+    else
+        edubfm_pins[latest].inUse = FALSE;
+
+    return( eNOERROR );
+
+}  /* edubfm_PinFreeTrain */
+
+
+
+/*@================================
+ * edubfm_PinDebugCheck()
+ *================================*/
+/*
+ * Function: Four edubfm_PinDebugCheck(Boolean)
+ *
+ * Description :
+ *  Report the pins held longer than the threshold. A pin is reported only
+ *  once unless 'all' is TRUE.
+ *
+ * Returns:
+ *  # of pins held longer than the threshold
+ */
+Four edubfm_PinDebugCheck(
+    Boolean		all)			/* IN TRUE to report already reported pins again */
+{
+    Four		i;
+    Four		nLong;			/* # of long pins */
+    double		now;			/* current time */
+
+
+    now = edubfm_PinDebugNow();
+
+    for (nLong = 0, i = 0; i < PIN_DEBUG_MAX_PINS; i++) {
+        if (!edubfm_pins[i].inUse || now - edubfm_pins[i].fixTime < edubfm_pinThreshold) continue;
+        nLong++;
+
+        if (edubfm_pins[i].reported && !all) continue;
+        edubfm_pins[i].reported = TRUE;
+
+        fprintf(stderr, "pin debug: train {%ld, %ld} of buffer type %ld pinned at %s:%ld for %.3f sec\n",
+                (long)edubfm_pins[i].key.volNo, (long)edubfm_pins[i].key.pageNo, (long)edubfm_pins[i].type,
+                edubfm_pins[i].file, (long)edubfm_pins[i].line, (now - edubfm_pins[i].fixTime) / 1000000.0);
+    }
+
+    return( nLong );
+
+}  /* edubfm_PinDebugCheck */
+
+
+
+/*@================================
+ * edubfm_PinDebugDump()
+ *================================*/
+/*
+ * Function: void edubfm_PinDebugDump(char*)
+ *
+ * Description :
+ *  Print the pins still outstanding, e.g. when all buffers are flushed.
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_PinDebugDump(
+    char		*where)			/* IN name of the caller used in the report */
+{
+    Four		i;
+    Four		nPins;			/* # of outstanding pins */
+    double		now;			/* current time */
+
+
+    now = edubfm_PinDebugNow();
+
+    for (nPins = 0, i = 0; i < PIN_DEBUG_MAX_PINS; i++) {
+        if (!edubfm_pins[i].inUse) continue;
+
+        if (nPins++ == 0) fprintf(stderr, "pin debug: outstanding pins at %s\n", where);
+        fprintf(stderr, "    train {%ld, %ld} of buffer type %ld pinned at %s:%ld for %.3f sec\n",
+                (long)edubfm_pins[i].key.volNo, (long)edubfm_pins[i].key.pageNo, (long)edubfm_pins[i].type,
+                edubfm_pins[i].file, (long)edubfm_pins[i].line, (now - edubfm_pins[i].fixTime) / 1000000.0);
+    }
+
+}  /* edubfm_PinDebugDump */
+
+#endif /* EDUBFM_PIN_DEBUG */
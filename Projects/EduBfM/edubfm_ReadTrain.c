@@ -54,6 +54,7 @@
  *
  * Exports:
  *  edubfm_ReadTrain()
+ *  edubfm_ReadTrainAsync()
  */
 
 
@@ -100,11 +101,51 @@ Four edubfm_ReadTrain(
 	/* Error check whether using not supported functionality by EduBfM */
 	if (RM_IS_ROLLBACK_REQUIRED()) ERR(eNOTSUPPORTED_EDUBFM);
     
-    /* Read the page from the disk */
-    e = RDsM_ReadTrain(trainId, aTrain, BI_BUFSIZE(type));
+    /* Read the page from the disk (through the device emulation) */
+    e = edubfm_EmulReadTrain(trainId, aTrain, BI_BUFSIZE(type));
     if( e < 0 ) ERR( e );
 
 
     return( eNOERROR );
 
 }  /* edubfm_ReadTrain */
+
+
+
+/*@================================
+ * edubfm_ReadTrainAsync()
+ *================================*/
+/*
+ * Function: Four edubfm_ReadTrainAsync(TrainID*, char*, Four, double*)
+ *
+ * Description:
+ *  Issue the read of a train into the buffer without waiting for it.
+ *  The contents of the buffer may be used once the virtual clock of the
+ *  I/O emulation has reached 'doneTime'.
+ *
+ * Returns:
+ *  error code
+ *    eNOTSUPPORTED_EDUBFM - rollback is not supported by EduBfM
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  1) parameter doneTime
+ *     completion time of the read on the virtual clock
+ */
+Four edubfm_ReadTrainAsync(
+    TrainID *trainId,		/* IN which train? */
+    char    *aTrain,		/* OUT a pointer to buffer */
+    Four    type,		/* IN buffer type */
+    double  *doneTime)		/* OUT completion time of the read */
+{
+    Four e;			/* for error */
+
+
+    if (RM_IS_ROLLBACK_REQUIRED()) ERR(eNOTSUPPORTED_EDUBFM);
+
+    e = edubfm_EmulReadTrainAsync(trainId, aTrain, BI_BUFSIZE(type), doneTime);
+    if( e < 0 ) ERR( e );
+
+    return( eNOERROR );
+
+}  /* edubfm_ReadTrainAsync */
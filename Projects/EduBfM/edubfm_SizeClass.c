@@ -0,0 +1,169 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_SizeClass.c
+ *
+ * Description :
+ *  Buffer pools for train size classes registered at run time.
+ *  The storage system sets up PAGE_BUF and LOT_LEAF_BUF; further pools of
+ *  other train sizes take the slots after them in bufInfo[], which is
+ *  defined here with room for MAX_BUF_TYPES pools.
+ *
+ * Exports:
+ *  Four edubfm_InitPool(Four, Two, Two)
+ *  void edubfm_FreePool(Four)
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "EduBfM_common.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@
+ * Global Variables
+ */
+/* buffer pool information; the first NUM_BUILTIN_BUF_TYPES entries are set up by BfM_Init() */
+BufferInfo bufInfo[MAX_BUF_TYPES];
+
+/* # of buffer pools in use */
+Four edubfm_nBufTypes = NUM_BUILTIN_BUF_TYPES;
+
+/* per buffer pool statistics */
+BfMSizeClassStat edubfm_classStat[MAX_BUF_TYPES];
+
+
+
+/*@================================
+ * edubfm_InitPool()
+ *================================*/
+/*
+ * Function: Four edubfm_InitPool(Four, Two, Two)
+ *
+ * Description :
+ *  Allocate the buffer table, the buffers and the hash table of the buffer
+ *  pool 'type' holding 'nBufs' trains of 'bufSize' pages, and make every
+ *  buffer empty.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR_EDUBFM - memory allocation error
+ */
+Four edubfm_InitPool(
+    Four		type,			/* IN buffer type */
+    Two			bufSize,		/* IN size of a buffer in page size */
+    Two			nBufs)			/* IN # of buffers */
+{
+    Four		i;
+
+
+    bufInfo[type].bufSize = bufSize;
+    bufInfo[type].nBufs = nBufs;
+    bufInfo[type].nextVictim = 0;
+
+    bufInfo[type].bufTable = (BufferTable *)malloc(sizeof(BufferTable) * nBufs);
+    bufInfo[type].bufferPool = (char *)malloc((size_t)PAGESIZE * bufSize * nBufs);
+    bufInfo[type].hashTable = (Two *)malloc(sizeof(Two) * HASHTABLESIZE_TO_NBUFS(nBufs));
+    if (bufInfo[type].bufTable == NULL || bufInfo[type].bufferPool == NULL ||
+        bufInfo[type].hashTable == NULL) {
+        edubfm_FreePool(type);
+        ERR(eMEMORYALLOCERR_EDUBFM);
+    }
+
+    for (i = 0; i < nBufs; i++) {
+        SET_NILBFMHASHKEY(BI_KEY(type, i));
+        BI_FIXED(type, i) = 0;
+        BI_BITS(type, i) = ALL_0;
+        BI_NEXTHASHENTRY(type, i) = NOTFOUND_IN_HTABLE;
+    }
+    for (i = 0; i < HASHTABLESIZE(type); i++)
+        BI_HASHTABLEENTRY(type, i) = NOTFOUND_IN_HTABLE;
+
+    memset(&edubfm_classStat[type], 0, sizeof(BfMSizeClassStat));
+
+    return( eNOERROR );
+
+}  /* edubfm_InitPool */
+
+
+
+/*@================================
+ * edubfm_FreePool()
+ *================================*/
+/*
+ * Function: void edubfm_FreePool(Four)
+ *
+ * Description :
+ *  Free the memory of the buffer pool 'type' including its side tables.
+ *  The buffer pool must not be one set up by the storage system.
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_FreePool(
+    Four		type)			/* IN buffer type */
+{
+
+    free(bufInfo[type].bufTable);
+    free(bufInfo[type].bufferPool);
+    free(bufInfo[type].hashTable);
+    bufInfo[type].bufTable = NULL;
+    bufInfo[type].bufferPool = NULL;
+    bufInfo[type].hashTable = NULL;
+    bufInfo[type].nBufs = 0;
+
+    /* the side tables are allocated again on demand with the new size */
+    free(edubfm_recLsn[type]);
+    free(edubfm_readyTime[type]);
+    edubfm_recLsn[type] = NULL;
+    edubfm_readyTime[type] = NULL;
+
+}  /* edubfm_FreePool */
@@ -0,0 +1,300 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubfm_WriteQueue.c
+ *
+ * Description :
+ *  Manage the write queue of dirty trains skipped by the clean-first
+ *  eviction. Queued trains are written behind the callers; their emulated
+ *  I/O cost is charged to the device without blocking the caller.
+ *
+ * Exports:
+ *  Four edubfm_EnqueueWrite(Four, Four)
+ *  void edubfm_DequeueWrite(Four, Four)
+ *  Four edubfm_DrainWriteQueue(Four)
+ *  void edubfm_ClearWriteQueue(void)
+ *  Four edubfm_WriteBehind(Four, Four)
+ */
+
+
+#include "EduBfM_common.h"
+#include "RDsM.h"
+#include "EduBfM_Internal.h"
+
+
+
+/*@
+ * Global Variables
+ */
+/* the eviction policy in effect */
+BfMEvictPolicy edubfm_evictPolicy = { EVICT_MODE_CLOCK, EVICT_DEFAULT_WINDOW, EVICT_DEFAULT_WRITEBEHIND };
+
+/* eviction statistics */
+BfMEvictStat edubfm_evictStat;
+
+/* the write queue: a circular array of 'edubfm_wqCount' entries starting at 'edubfm_wqHead' */
+static BfMWriteQueueEntry edubfm_writeQueue[WRITEQUEUE_SIZE];
+static Four edubfm_wqHead = 0;
+static Four edubfm_wqCount = 0;
+
+
+
+/*@================================
+ * edubfm_EnqueueWrite()
+ *================================*/
+/*
+ * Function: Four edubfm_EnqueueWrite(Four, Four)
+ *
+ * Description :
+ *  Put the train residing in the buffer element 'index' of the buffer pool
+ *  'type' into the write queue. A train already in the queue is not queued
+ *  again. If the queue is full, the train is not queued; it stays dirty and
+ *  is queued again when it becomes a victim candidate after a drain.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubfm_EnqueueWrite(
+    Four		type,			/* IN buffer type */
+    Four		index)			/* IN array index of the buffer element */
+{
+    Four		i;			/* loop index */
+    BfMWriteQueueEntry *entry;
+
+
+    for (i = 0; i < edubfm_wqCount; i++) {
+        entry = &edubfm_writeQueue[(edubfm_wqHead + i) % WRITEQUEUE_SIZE];
+        if (entry->type == type && entry->index == index &&
+            EQUALKEY(&entry->key, &BI_KEY(type, index)))
+            return( eNOERROR );
+    }
+
+    if (edubfm_wqCount == WRITEQUEUE_SIZE) {
+        edubfm_evictStat.nQueueFull++;
+        return( eNOERROR );
+    }
+
+    entry = &edubfm_writeQueue[(edubfm_wqHead + edubfm_wqCount) % WRITEQUEUE_SIZE];
+    entry->key = BI_KEY(type, index);
+    entry->type = type;
+    entry->index = index;
+    edubfm_wqCount++;
+
+    edubfm_evictStat.nQueued++;
+
+    return( eNOERROR );
+
+}  /* edubfm_EnqueueWrite */
+
+
+
+/*@================================
+ * edubfm_DequeueWrite()
+ *================================*/
+/*
+ * Function: void edubfm_DequeueWrite(Four, Four)
+ *
+ * Description :
+ *  Take the train residing in the buffer element 'index' of the buffer pool
+ *  'type' out of the write queue, e.g. because it is flushed synchronously
+ *  as a victim. Nothing happens if the train is not in the queue.
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_DequeueWrite(
+    Four		type,			/* IN buffer type */
+    Four		index)			/* IN array index of the buffer element */
+{
+    Four		i;			/* loop index */
+    Four		nKept;			/* # of entries kept so far */
+    BfMWriteQueueEntry *entry;
+
+
+    for (i = 0, nKept = 0; i < edubfm_wqCount; i++) {
+        entry = &edubfm_writeQueue[(edubfm_wqHead + i) % WRITEQUEUE_SIZE];
+        if (entry->type == type && entry->index == index &&
+            EQUALKEY(&entry->key, &BI_KEY(type, index)))
+            continue;
+        edubfm_writeQueue[(edubfm_wqHead + nKept) % WRITEQUEUE_SIZE] = *entry;
+        nKept++;
+    }
+
+    edubfm_wqCount = nKept;
+
+}  /* edubfm_DequeueWrite */
+
+
+
+/*@================================
+ * edubfm_DrainWriteQueue()
+ *================================*/
+/*
+ * Function: Four edubfm_DrainWriteQueue(Four)
+ *
+ * Description :
+ *  Write at most 'n' trains from the head of the write queue; if 'n' is not
+ *  positive, the whole queue is drained.
+ *  An entry is written only if its buffer element still holds the queued
+ *  train, the train is still dirty and nobody has fixed it meanwhile;
+ *  otherwise the entry is stale and simply dropped. (A fixed train may be
+ *  being modified; it is queued again when it becomes a victim candidate.)
+ *  The trains drained together go through the double-write buffer as one
+ *  batch.
+ *
+ * Returns:
+ *  1) # of trains written
+ *  2) Error codes: Negative value means error code.
+ *     some errors caused by function calls
+ */
+Four edubfm_DrainWriteQueue(
+    Four		n)			/* IN maximum # of entries to be drained */
+{
+    Four		e;			/* error code */
+    Four		nWritten;		/* # of trains written */
+    Four		type;			/* buffer type */
+    Four		index;			/* array index of the buffer element */
+    BfMWriteQueueEntry *entry;
+
+
+    if (n <= 0 || n > edubfm_wqCount) n = edubfm_wqCount;
+
+    edubfm_DwbBegin();
+
+    for (nWritten = 0; n > 0; n--) {
+
+        entry = &edubfm_writeQueue[edubfm_wqHead];
+        edubfm_wqHead = (edubfm_wqHead + 1) % WRITEQUEUE_SIZE;
+        edubfm_wqCount--;
+
+        type = entry->type;
+        index = entry->index;
+
+        if (!EQUALKEY(&entry->key, &BI_KEY(type, index)) || !(BI_BITS(type, index) & DIRTY) ||
+            BI_FIXED(type, index) > 0) {
+            edubfm_evictStat.nQueueStale++;
+            continue;
+        }
+
+        e = edubfm_WriteBehind(type, index);
+        if (e < 0) {
+            edubfm_DwbEnd();
+            ERR(e);
+        }
+
+        edubfm_evictStat.nQueueWrites++;
+        nWritten++;
+    }
+
+    e = edubfm_DwbEnd();
+    if (e < 0) ERR(e);
+
+    return( nWritten );
+
+}  /* edubfm_DrainWriteQueue */
+
+
+
+/*@================================
+ * edubfm_ClearWriteQueue()
+ *================================*/
+/*
+ * Function: void edubfm_ClearWriteQueue(void)
+ *
+ * Description :
+ *  Drop all entries of the write queue without writing them.
+ *
+ * Returns:
+ *  None
+ */
+void edubfm_ClearWriteQueue(void)
+{
+    edubfm_wqHead = 0;
+    edubfm_wqCount = 0;
+
+}  /* edubfm_ClearWriteQueue */
+
+
+
+/*@================================
+ * edubfm_WriteBehind()
+ *================================*/
+/*
+ * Function: Four edubfm_WriteBehind(Four, Four)
+ *
+ * Description :
+ *  Write the dirty train residing in the buffer element 'index' of the
+ *  buffer pool 'type' without blocking the caller, i.e. the write is charged
+ *  to the emulated device asynchronously, and clear its dirty bit.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubfm_WriteBehind(
+    Four		type,			/* IN buffer type */
+    Four		index)			/* IN array index of the buffer element */
+{
+    Four		e;			/* error code */
+    TrainID		trainId;		/* train to be written */
+
+
+    trainId.pageNo = BI_KEY(type, index).pageNo;
+    trainId.volNo = BI_KEY(type, index).volNo;
+
+    e = edubfm_DwbWrite(&trainId, BI_BUFFER(type, index), BI_BUFSIZE(type), FALSE);
+    if (e < 0) ERR(e);
+
+    edubfm_classStat[type].nWrites++;
+
+    BI_BITS(type, index) &= ~DIRTY;
+
+    return( eNOERROR );
+
+}  /* edubfm_WriteBehind */
@@ -0,0 +1,247 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBtM_Bench.c
+ *
+ * Description : 
+ *  Point lookup benchmark of EduBtM.
+ *  A B+ tree on integer keys is built, then the same sequence of random
+ *  point lookups is run through BtM_Fetch() (fixing every page on the path)
+ *  and through EduBtM_SwizzledFetch() with and without swizzling.
+ *
+ *  Usage: EduBtM_Bench [# of keys] [# of lookups] [swizzle budget]
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "EduBtM_common.h"
+#include "EduBtM.h"
+#include "EduBtM_TestModule.h"
+
+
+#define BENCH_DEFAULT_NKEYS		150000
+#define BENCH_DEFAULT_NLOOKUPS	400000
+
+Four SM_CreateFile(Four, FileID*, Boolean, ObjectID*);
+Four sm_GetCatalogEntryFromDataFileId(Four, FileID*, ObjectID*);
+Four BtM_CreateIndex(ObjectID*, PageID*);
+Four BtM_InsertObject(ObjectID*, PageID*, KeyDesc*, KeyValue*, ObjectID*, Pool*, DeallocListElem*);
+Four BtM_Fetch(PageID*, KeyDesc*, KeyValue*, Four, KeyValue*, Four, BtreeCursor*);
+
+
+/* time in seconds */
+static double benchNow(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+/* run 'nLookups' random point lookups; 'swizzled' selects EduBtM_SwizzledFetch() */
+static Four benchLookups(PageID *rootPid, KeyDesc *kdesc, Four nKeys, Four nLookups, Boolean swizzled, char *label)
+{
+	Four		e;				/* for errors */
+	Four		i;				/* loop index */
+	Four		key;			/* key to be looked up */
+	Four		nFound = 0;		/* # of keys found */
+	UFour		seed = 12345;	/* the same sequence of keys for every run */
+	KeyValue	kval;			/* key value */
+	BtreeCursor	cursor;			/* result of a lookup */
+	double		start, elapsed;	/* time */
+	btm_SwizzleStat	before, after;	/* statistics */
+
+	EduBtM_GetSwizzleStat(&before);
+	start = benchNow();
+
+	for (i = 0; i < nLookups; i++) {
+		seed = seed * 1103515245 + 12345;
+		key = (seed >> 8) % nKeys;
+
+		kval.len = sizeof(Four_Invariable);
+		memcpy(&(kval.val[0]), &key, sizeof(Four_Invariable));
+
+		if (swizzled)
+			e = EduBtM_SwizzledFetch(rootPid, kdesc, &kval, &cursor);
+		else
+			e = BtM_Fetch(rootPid, kdesc, &kval, SM_EQ, &kval, SM_EQ, &cursor);
+		if (e < eNOERROR) ERR(e);
+
+		if (cursor.flag == CURSOR_ON && cursor.oid.slotNo == (key & 0x7fff)) nFound++;
+	}
+
+	elapsed = benchNow() - start;
+	EduBtM_GetSwizzleStat(&after);
+
+	printf("%-28s %10.0f lookups/sec  found %ld/%ld", label, nLookups / elapsed, nFound, nLookups);
+	if (swizzled)
+		printf("  swizzled hops %ld, fixed hops %ld",
+			   after.nSwizzledHops - before.nSwizzledHops, after.nFixedHops - before.nFixedHops);
+	printf("\n");
+
+	return(eNOERROR);
+}
+
+
+static Four EduBtM_Bench(Four volId, Four nKeys, Four nLookups, Four budget)
+{
+	Four		e;				/* for errors */
+	Four		i;				/* loop index */
+	FileID		fid;			/* file identifier */
+	ObjectID	catalogEntry;	/* catalog object */
+	ObjectID	oid;			/* object id */
+	PageID		rootPid;		/* root page identifier */
+	KeyValue	kval;			/* value of key */
+	KeyDesc		kdesc;			/* key descriptor */
+	char		label[64];		/* label of a run */
+
+	e = SM_CreateFile(volId, &fid, FALSE, NULL);
+	if (e < eNOERROR) ERR(e);
+	e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid, &catalogEntry);
+	if (e < eNOERROR) ERR(e);
+
+	e = BtM_CreateIndex(&catalogEntry, &rootPid);
+	if (e < eNOERROR) ERR(e);
+
+	kdesc.flag = KEYFLAG_UNIQUE;
+	kdesc.nparts = 1;
+	kdesc.kpart[0].type = SM_INT;
+	kdesc.kpart[0].offset = 0;
+	kdesc.kpart[0].length = sizeof(Four);
+
+	oid.pageNo = 777;
+	oid.volNo = volId;
+
+	for (i = 0; i < nKeys; i++) {
+		kval.len = sizeof(Four_Invariable);
+		memcpy(&(kval.val[0]), &i, sizeof(Four_Invariable));
+		oid.slotNo = i & 0x7fff;
+		oid.unique = i;
+		e = BtM_InsertObject(&catalogEntry, &rootPid, &kdesc, &kval, &oid, &dlPool, &dlHead);
+		if (e < eNOERROR) ERR(e);
+	}
+
+	printf("B+ tree of %ld integer keys built, %ld random point lookups per run\n", nKeys, nLookups);
+
+	e = benchLookups(&rootPid, &kdesc, nKeys, nLookups, FALSE, "BtM_Fetch");
+	if (e < eNOERROR) ERR(e);
+
+	e = EduBtM_SetSwizzleBudget(0);
+	if (e < eNOERROR) ERR(e);
+	e = benchLookups(&rootPid, &kdesc, nKeys, nLookups, TRUE, "SwizzledFetch, budget 0");
+	if (e < eNOERROR) ERR(e);
+
+	e = EduBtM_SetSwizzleBudget(budget);
+	if (e < eNOERROR) ERR(e);
+	sprintf(label, "SwizzledFetch, budget %ld", budget);
+	e = benchLookups(&rootPid, &kdesc, nKeys, nLookups, TRUE, label);
+	if (e < eNOERROR) ERR(e);
+
+	e = EduBtM_UnswizzleAll();
+	if (e < eNOERROR) ERR(e);
+
+	return(eNOERROR);
+}
+
+
+Four main(int argc, char *argv[])
+{
+	Four	e;									/* for errors */
+	Four	handle;								/* system handle */
+	char 	*devNames[MAX_DEVICES_IN_VOLUME];	/* device name */
+	Four 	volId;								/* volume identifier */
+	Four 	numPagesInDevices[MAX_DEVICES_IN_VOLUME];/* # of pages in the each devices */
+	XactID 	xactId;								/* transaction identifier */
+	Four	nKeys = BENCH_DEFAULT_NKEYS;		/* # of keys */
+	Four	nLookups = BENCH_DEFAULT_NLOOKUPS;	/* # of lookups per run */
+	Four	budget = BTM_SWIZZLE_DEFAULT_BUDGET;/* swizzle budget */
+
+	if (argc > 1) nKeys = atol(argv[1]);
+	if (argc > 2) nLookups = atol(argv[2]);
+	if (argc > 3) budget = atol(argv[3]);
+
+	e = LRDS_Init();
+	if (e < eNOERROR) { printf("LRDS_Init failed!!!\n"); exit(1); }
+
+	e = LRDS_AllocHandle(&handle);
+	if (e < eNOERROR) { printf("LRDS_AllocHandle failed!!!\n"); LRDS_Final(); exit(1); }
+
+	devNames[0] = "bench.vol";
+	volId = 1000;
+	numPagesInDevices[0] = 4000;
+
+	e = LRDS_FormatDataVolume(1, devNames, "bench", volId, 16, numPagesInDevices, 16);
+	if (e < eNOERROR) { printf("LRDS_FormatDataVolume failed!!!\n"); LRDS_FreeHandle(handle); LRDS_Final(); exit(1); }
+
+	e = LRDS_Mount(1, devNames, &volId);
+	if (e < eNOERROR) { printf("LRDS_Mount failed!!!\n"); LRDS_FreeHandle(handle); LRDS_Final(); exit(1); }
+
+	e = LRDS_BeginTransaction(&xactId, X_RR_RR);
+	if (e < eNOERROR) { LRDS_Dismount(volId); LRDS_FreeHandle(handle); LRDS_Final(); exit(1); }
+
+	e = EduBtM_Bench(volId, nKeys, nLookups, budget);
+	if (e < eNOERROR) {
+		printf("EduBtM_Bench failed!!!\n");
+		LRDS_AbortTransaction(&xactId);
+		LRDS_Dismount(volId);
+		LRDS_FreeHandle(handle);
+		LRDS_Final();
+		exit(1);
+	}
+
+	LRDS_CommitTransaction(&xactId);
+	LRDS_Dismount(volId);
+	LRDS_FreeHandle(handle);
+	LRDS_Final();
+
+	return 0;
+}
@@ -91,21 +91,18 @@ Four EduBtM_CreateIndex(
 	/* These local variables are used in the solution code. However, you don��t have to use all these variables in your code, and you may also declare and use additional local variables if needed. */
     Four e;			/* error number */
     Boolean isTmp;
-    SlottedPage *catPage;	/* buffer page containing the catalog object */
-    sm_CatOverlayForBtree *catEntry; /* pointer to Btree file catalog information */
+    sm_CatOverlayForBtree catEntry; /* Btree file catalog information */
     PhysicalFileID pFid;	/* physical file ID */
 
-    BfM_GetTrain((TrainID *)catObjForFile,(char**)&catPage,PAGE_BUF);
-    GET_PTR_TO_CATENTRY_FOR_BTREE(catObjForFile,catPage,catEntry);
+    e = edubtm_GetCatalogEntry(catObjForFile, &catEntry);
+    if (e < 0) ERR(e);
 
-    MAKE_PHYSICALFILEID(pFid, catEntry->fid.volNo, catEntry->firstPage);
+    MAKE_PHYSICALFILEID(pFid, catEntry.fid.volNo, catEntry.firstPage);
     e = btm_AllocPage(catObjForFile, (PageID *)&pFid, rootPid);
     if (e < 0) ERR(e);
 
     edubtm_InitLeaf(rootPid, 1, 0);
 
-    BfM_FreeTrain(catObjForFile,PAGE_BUF);
-
     return(eNOERROR);
     
 } /* EduBtM_CreateIndex() */
@@ -103,8 +103,7 @@ Four EduBtM_DeleteObject(
     Boolean lf;			/* flag for merging */
     Boolean lh;			/* flag for splitting */
     InternalItem item;		/* Internal item */
-    SlottedPage *catPage;	/* buffer page containing the catalog object */
-    sm_CatOverlayForBtree *catEntry; /* pointer to Btree file catalog information */
+    sm_CatOverlayForBtree catEntry; /* Btree file catalog information */
     PhysicalFileID pFid;        /* B+-tree file's FileID */
 
 
@@ -128,12 +127,16 @@ Four EduBtM_DeleteObject(
             ERR(eNOTSUPPORTED_EDUBTM);
     }
 
-    BfM_GetTrain((TrainID *)catObjForFile,(char**)&catPage,PAGE_BUF);
-    GET_PTR_TO_CATENTRY_FOR_BTREE(catObjForFile,catPage,catEntry);
+    /* The swizzled pointers mirror the slots of the pages to be changed */
+    e = edubtm_UnswizzleTree(root);
+    if (e < 0) ERR(e);
+
+    e = edubtm_GetCatalogEntry(catObjForFile, &catEntry);
+    if (e < 0) ERR(e);
 
     btm_Delete(catObjForFile,root,kdesc,kval,oid,&lf,&lh,&item,dlPool,dlHead);
 
-    MAKE_PHYSICALFILEID(pFid, catEntry->fid.volNo, catEntry->firstPage);
+    MAKE_PHYSICALFILEID(pFid, catEntry.fid.volNo, catEntry.firstPage);
     if(lf){
         printf("underflow\n");
         e=btm_root_delete(&pFid,root,dlPool,dlHead);
@@ -145,8 +148,6 @@ Four EduBtM_DeleteObject(
         if(e<0)ERR(e);
     }
 
-    BfM_FreeTrain(catObjForFile,PAGE_BUF);
-
     
     return(eNOERROR);
     
@@ -88,6 +88,10 @@ Four EduBtM_DropIndex(
     Four e;			/* for the error number */
 
 
+    /* Swizzled pages are fixed in the buffer; release them first */
+    e = edubtm_UnswizzleTree(rootPid);
+    if (e < 0) ERR(e);
+
     /*@ Free all pages concerned with the root. */
 
 	e= edubtm_FreePages(pFid, rootPid, dlPool, dlHead);
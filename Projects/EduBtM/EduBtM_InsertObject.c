@@ -98,8 +98,6 @@ Four EduBtM_InsertObject(
     Boolean lh;			/* for spliting */
     Boolean lf;			/* for merging */
     InternalItem item;		/* Internal Item */
-    SlottedPage *catPage;	/* buffer page containing the catalog object */
-    sm_CatOverlayForBtree *catEntry; /* pointer to Btree file catalog information */
     PhysicalFileID pFid;	 /* B+-tree file's FileID */
 
     
@@ -122,8 +120,9 @@ Four EduBtM_InsertObject(
             ERR(eNOTSUPPORTED_EDUBTM);
     }
 
-    BfM_GetTrain((TrainID *)catObjForFile,(char**)&catPage,PAGE_BUF);
-    GET_PTR_TO_CATENTRY_FOR_BTREE(catObjForFile,catPage,catEntry);
+    /* The swizzled pointers mirror the slots of the pages to be changed */
+    e = edubtm_UnswizzleTree(root);
+    if (e < 0) ERR(e);
 
     lh=0;
     lf=0;
@@ -131,8 +130,6 @@ Four EduBtM_InsertObject(
     if(lh==TRUE){
         edubtm_root_insert(catObjForFile,root,&item);
     }
-
-    BfM_FreeTrain(catObjForFile,PAGE_BUF);    
     
     return(eNOERROR);
     
@@ -0,0 +1,322 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduBtM_SwizzledFetch.c
+ *
+ * Description :
+ *  Find the object with the given key in a B+ tree, descending through
+ *  swizzled pointers as far as possible.
+ *
+ * Exports:
+ *  Four EduBtM_SwizzledFetch(PageID*, KeyDesc*, KeyValue*, BtreeCursor*)
+ *  Four EduBtM_SetSwizzleBudget(Four)
+ *  Four EduBtM_UnswizzleAll(void)
+ *  Four EduBtM_GetSwizzleStat(btm_SwizzleStat*)
+ */
+
+
+#include <string.h>
+#include "EduBtM_common.h"
+#include "BfM.h"
+#include "EduBtM_Internal.h"
+
+
+extern Four edubtm_swizzleBudget;
+extern btm_SwizzleStat edubtm_swizzleStat;
+
+
+
+/*@================================
+ * EduBtM_SwizzledFetch()
+ *================================*/
+/*
+ * Function: Four EduBtM_SwizzledFetch(PageID*, KeyDesc*, KeyValue*, BtreeCursor*)
+ *
+ * Description :
+ *  Find the first object whose key is equal to 'kval' in the B+ tree 'root'
+ *  and return the cursor pointing to it, as EduBtM_Fetch() with SM_EQ for
+ *  both the start and the stop condition does.
+ *  The pages on the search path are swizzled as long as the budget allows;
+ *  a swizzled page is reached through the pointer in its parent without
+ *  calling the buffer manager. The remaining pages are fixed and unfixed
+ *  as usual. A key having an overflow page is looked up by btm_Fetch().
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_BTM - bad parameter
+ *    eNOTSUPPORTED_EDUBTM - key type not supported by EduBtM
+ *    some errors caused by function calls
+ */
+Four EduBtM_SwizzledFetch(
+    PageID		*root,		/* IN root of the B+ tree */
+    KeyDesc		*kdesc,		/* IN key descriptor */
+    KeyValue		*kval,		/* IN key value to be found */
+    BtreeCursor		*cursor)	/* OUT cursor pointing to the found object */
+{
+    Four		e;		/* error number */
+    Four		i;		/* index */
+    Two			idx;		/* index of the entry found */
+    Boolean		found;		/* search result */
+    PageID		pid;		/* current page */
+    PageID		child;		/* child page */
+    BtreePage		*apage;		/* pointer to the current page */
+    Boolean		fixed;		/* TRUE if the current page is fixed only for this descent */
+    btm_SwizzleNode	*node;		/* swizzled node of the current page (or NULL) */
+    btm_SwizzleNode	*childNode;	/* swizzled node of the child page (or NULL) */
+    btm_InternalEntry	*iEntry;	/* an internal entry */
+    btm_LeafEntry	*lEntry;	/* a leaf entry */
+    ObjectID		*oidArray;	/* ObjectIDs of a leaf entry */
+
+
+    if (root == NULL || kdesc == NULL || kval == NULL || cursor == NULL) ERR(eBADPARAMETER_BTM);
+
+    /* Error check whether using not supported functionality by EduBtM */
+    for(i=0; i<kdesc->nparts; i++)
+    {
+        if(kdesc->kpart[i].type!=SM_INT && kdesc->kpart[i].type!=SM_VARSTRING)
+            ERR(eNOTSUPPORTED_EDUBTM);
+    }
+
+    pid = *root;
+
+    e = edubtm_LookUpSwizzledRoot(root, &node);
+    if (e < 0) ERR(e);
+
+    if (node != NULL) {
+        apage = node->apage;
+        fixed = FALSE;
+        edubtm_swizzleStat.nSwizzledHops++;
+    }
+    else {
+        e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+        if (e < 0) ERR(e);
+        edubtm_swizzleStat.nFixedHops++;
+
+        e = edubtm_SwizzleRoot(root, apage, &node);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+        fixed = (node == NULL);
+    }
+
+    /* Descend to the leaf */
+    while (apage->any.hdr.type & INTERNAL) {
+
+        btm_BinarySearchInternal(&apage->bi, kdesc, kval, &idx);
+
+        if (idx == -1)
+            child.pageNo = apage->bi.hdr.p0;
+        else {
+            iEntry = (btm_InternalEntry *)&apage->bi.data[apage->bi.slot[-idx]];
+            child.pageNo = iEntry->spid;
+        }
+        child.volNo = pid.volNo;
+
+        childNode = (node != NULL) ? node->child[idx + 1] : NULL;
+
+        if (childNode != NULL) {
+            /* follow the swizzled pointer */
+            if (fixed) {
+                e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+                if (e < 0) ERR(e);
+            }
+            apage = childNode->apage;
+            fixed = FALSE;
+            edubtm_swizzleStat.nSwizzledHops++;
+        }
+        else {
+            /* go through the buffer manager, and swizzle the child if possible */
+            e = BfM_GetTrain((TrainID *)&child, (char **)&apage, PAGE_BUF);
+            if (e < 0) { if (fixed) ERRB1(e, &pid, PAGE_BUF); ERR(e); }
+            edubtm_swizzleStat.nFixedHops++;
+
+            if (node != NULL) {
+                e = edubtm_SwizzleChild(node, idx + 1, &child, apage, &childNode);
+                if (e < 0) { if (fixed) ERRB2(e, &pid, PAGE_BUF, &child, PAGE_BUF); ERRB1(e, &child, PAGE_BUF); }
+            }
+
+            if (fixed) {
+                e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+                if (e < 0) ERR(e);
+            }
+            fixed = (childNode == NULL);
+        }
+
+        pid = child;
+        node = childNode;
+    }
+
+    /* Search the leaf */
+    found = btm_BinarySearchLeaf(&apage->bl, kdesc, kval, &idx);
+
+    if (!found) {
+        cursor->flag = CURSOR_EOS;
+    }
+    else {
+        lEntry = (btm_LeafEntry *)&apage->bl.data[apage->bl.slot[-idx]];
+
+        if (lEntry->nObjects < 0) {
+            /* the ObjectIDs are stored in overflow pages */
+            if (fixed) {
+                e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+                if (e < 0) ERR(e);
+            }
+            e = btm_Fetch(root, kdesc, kval, SM_EQ, kval, SM_EQ, cursor);
+            if (e < 0) ERR(e);
+            return(eNOERROR);
+        }
+
+        oidArray = (ObjectID *)&lEntry->kval[ALIGNED_LENGTH(lEntry->klen)];
+
+        cursor->flag = CURSOR_ON;
+        cursor->oid = oidArray[0];
+        cursor->key.len = lEntry->klen;
+        memcpy(&cursor->key.val[0], &lEntry->kval[0], lEntry->klen);
+        cursor->leaf = pid;
+        cursor->slotNo = idx;
+        cursor->oidArrayElemNo = 0;
+    }
+
+    if (fixed) {
+        e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+        if (e < 0) ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* EduBtM_SwizzledFetch() */
+
+
+
+/*@================================
+ * EduBtM_SetSwizzleBudget()
+ *================================*/
+/*
+ * Function: Four EduBtM_SetSwizzleBudget(Four)
+ *
+ * Description :
+ *  Set the maximum # of pages kept swizzled, i.e. kept fixed in the buffer,
+ *  at a time. The budget must leave enough unfixed buffers for the other
+ *  users of the buffer pool. A budget of 0 turns swizzling off.
+ *  All pages currently swizzled are unswizzled.
+ *
+ * Returns:
+ *  error code
+ *    eBADSWIZZLEBUDGET_EDUBTM - bad budget
+ *    some errors caused by function calls
+ */
+Four EduBtM_SetSwizzleBudget(
+    Four		budget)		/* IN maximum # of swizzled pages */
+{
+    Four		e;		/* error number */
+
+
+    if (budget < 0 || budget > BTM_SWIZZLE_MAX_BUDGET) ERR(eBADSWIZZLEBUDGET_EDUBTM);
+
+    e = edubtm_UnswizzleTree(NULL);
+    if (e < 0) ERR(e);
+
+    edubtm_swizzleBudget = budget;
+
+    return(eNOERROR);
+
+} /* EduBtM_SetSwizzleBudget() */
+
+
+
+/*@================================
+ * EduBtM_UnswizzleAll()
+ *================================*/
+/*
+ * Function: Four EduBtM_UnswizzleAll(void)
+ *
+ * Description :
+ *  Unswizzle all pages of all B+ trees, unfixing them. It must be called
+ *  before the buffers are flushed for the last time, e.g. before dismounting.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four EduBtM_UnswizzleAll(void)
+{
+    Four		e;		/* error number */
+
+
+    e = edubtm_UnswizzleTree(NULL);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduBtM_UnswizzleAll() */
+
+
+
+/*@================================
+ * EduBtM_GetSwizzleStat()
+ *================================*/
+/*
+ * Function: Four EduBtM_GetSwizzleStat(btm_SwizzleStat*)
+ *
+ * Description :
+ *  Return the statistics of the swizzled descent.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_BTM - 'stat' is NULL
+ */
+Four EduBtM_GetSwizzleStat(
+    btm_SwizzleStat	*stat)		/* OUT statistics */
+{
+
+    if (stat == NULL) ERR(eBADPARAMETER_BTM);
+
+    *stat = edubtm_swizzleStat;
+
+    return(eNOERROR);
+
+} /* EduBtM_GetSwizzleStat() */
@@ -65,6 +65,10 @@ Four EduBtM_DropIndex(PhysicalFileID*, PageID*, Pool*, DeallocListElem*);
 Four EduBtM_Fetch(PageID*, KeyDesc*, KeyValue*, Four, KeyValue*, Four, BtreeCursor*);
 Four EduBtM_FetchNext(PageID*, KeyDesc*, KeyValue*, Four, BtreeCursor*, BtreeCursor*);
 Four EduBtM_InsertObject(ObjectID*, PageID*, KeyDesc*, KeyValue*, ObjectID*, Pool*, DeallocListElem*);
+Four EduBtM_SwizzledFetch(PageID*, KeyDesc*, KeyValue*, BtreeCursor*);
+Four EduBtM_SetSwizzleBudget(Four);
+Four EduBtM_UnswizzleAll(void);
+Four EduBtM_GetSwizzleStat(btm_SwizzleStat*);
 
 
 #endif /* _EDUBTM_H_ */
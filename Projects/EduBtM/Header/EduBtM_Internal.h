@@ -308,6 +308,63 @@ BEGIN_MACRO \
 END_MACRO
 
 
+/*@
+** Pointer Swizzling
+*/
+
+/* maximum # of pages which may be kept swizzled at a time */
+#define BTM_SWIZZLE_MAX_BUDGET      64
+
+/* default # of pages which may be kept swizzled at a time */
+#define BTM_SWIZZLE_DEFAULT_BUDGET  4
+
+/* maximum # of B+ trees which may have swizzled pages at a time */
+#define BTM_SWIZZLE_MAX_TREES       8
+
+/*
+ * A swizzled page is kept fixed in the buffer and is reached from its
+ * swizzled parent through a main memory pointer instead of its PageID,
+ * i.e. without looking up the buffer hash table.
+ * A page may be swizzled only if its parent is swizzled, and may be
+ * unswizzled only if none of its children is swizzled.
+ */
+typedef struct btm_SwizzleNode_T_tag {
+	PageID pid;                 /* page id of the swizzled page */
+	BtreePage *apage;           /* the page fixed in the buffer */
+	struct btm_SwizzleNode_T_tag *parent; /* swizzled parent (NULL for the root) */
+	Two childNo;                /* index of this node in 'child' of the parent */
+	Two nChildren;              /* # of child pointers; 0 for a leaf */
+	Two nSwizzled;              /* # of swizzled children */
+	struct btm_SwizzleNode_T_tag **child; /* child[0] for p0, child[i+1] for the i-th slot */
+} btm_SwizzleNode;
+
+/* statistics of the swizzled descent */
+typedef struct {
+	Four nSwizzledHops;         /* # of pages reached through a swizzled pointer */
+	Four nFixedHops;            /* # of pages reached through the buffer manager */
+	Four nSwizzles;             /* # of pages swizzled */
+	Four nUnswizzles;           /* # of pages unswizzled */
+} btm_SwizzleStat;
+
+
+/*@
+** Catalog Cache
+*/
+
+/* # of B+ tree files whose catalog entries are cached at a time */
+#define BTM_CATALOG_CACHE_SIZE      8
+
+/*
+ * A cached catalog entry of a B+ tree file. The fields of the entry never
+ * change during the life of the file, so the copy is never out of date;
+ * a catalog object destroyed and created again gets a new unique number.
+ */
+typedef struct {
+	ObjectID catObj;            /* catalog object of the file, the key of the entry */
+	sm_CatOverlayForBtree entry; /* copy of the catalog entry */
+} btm_CatalogCacheEntry;
+
+
 /*@
  * Function Prototypes
  */
@@ -333,7 +390,17 @@ Four edubtm_SplitLeaf(ObjectID*, PageID*, BtreeLeaf*, Two, LeafItem*, InternalIt
 Four edubtm_get_objectid_from_leaf(BtreeCursor*);
 Four edubtm_root_insert(ObjectID*, PageID*, InternalItem*);
 
+Four edubtm_LookUpSwizzledRoot(PageID*, btm_SwizzleNode**);
+Four edubtm_SwizzleRoot(PageID*, BtreePage*, btm_SwizzleNode**);
+Four edubtm_SwizzleChild(btm_SwizzleNode*, Two, PageID*, BtreePage*, btm_SwizzleNode**);
+Four edubtm_Unswizzle(btm_SwizzleNode*);
+Four edubtm_UnswizzleTree(PageID*);
+Four edubtm_GetCatalogEntry(ObjectID*, sm_CatOverlayForBtree*);
+
 Four btm_AllocPage(ObjectID*, PageID*, PageID*);
+Boolean btm_BinarySearchInternal(BtreeInternal*, KeyDesc*, KeyValue*, Two*);
+Boolean btm_BinarySearchLeaf(BtreeLeaf*, KeyDesc*, KeyValue*, Two*);
+Four btm_Fetch(PageID*, KeyDesc*, KeyValue*, Four, KeyValue*, Four, BtreeCursor*);
 Boolean btm_BinarySearchOidArray(ObjectID[], ObjectID*, Two, Two*);
 Four btm_ObjectIdComp(ObjectID*, ObjectID*);
 Four btm_CreateOverflow(ObjectID*, BtreeLeaf*, Two, ObjectID*);
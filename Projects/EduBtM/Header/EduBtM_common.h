@@ -141,6 +141,16 @@ typedef struct {
 	VolNo volNo;        /* a VolNo */
 } PageID;
 
+/* Macro: EQUAL_PAGEID(x, y)
+ * Description: check whether the two page IDs are equal
+ * Parameters:
+ *  PageID x        : page ID
+ *  pageID y        : page ID
+ * returns: TRUE(1) if x is equal to y, otherwise FALSE(0)
+ */
+#define EQUAL_PAGEID(x, y)                  \
+	(((x).volNo == (y).volNo && (x).pageNo == (y).pageNo) ? TRUE:FALSE)
+
 /* Macro: MAKE_PAGEID(pid, volume, page)
  * Description: construct the page ID using the given parameters
  * Parameters:
@@ -80,3 +80,5 @@
 #define eBADCACHETREELATCHCELLPTR_BTM            ERR_ENCODE_ERROR_CODE(BTM_ERR_BASE,12)
 #define NUM_ERRORS_BTM_ERR_BASE                  13
 #define eNOTSUPPORTED_EDUBTM                     ERR_ENCODE_ERROR_CODE(BTM_ERR_BASE,14)
+#define eBADSWIZZLEBUDGET_EDUBTM                 ERR_ENCODE_ERROR_CODE(BTM_ERR_BASE,15)
+#define eMEMORYALLOCERR_EDUBTM                   ERR_ENCODE_ERROR_CODE(BTM_ERR_BASE,16)
@@ -0,0 +1,141 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubtm_CatalogCache.c
+ *
+ * Description :
+ *  Cache the catalog entries of the B+ tree files, so that an update of a
+ *  B+ tree does not fix the page of the catalog object only to decode the
+ *  entry of its file. The last BTM_CATALOG_CACHE_SIZE files used are kept,
+ *  and the entry used least recently gives its place to a new file.
+ *
+ * Exports:
+ *  Four edubtm_GetCatalogEntry(ObjectID*, sm_CatOverlayForBtree*)
+ */
+
+
+#include <string.h>
+#include "EduBtM_common.h"
+#include "BfM.h"
+#include "OM_Internal.h"	/* for SlottedPage */
+#include "EduBtM_Internal.h"
+
+
+
+/*@
+ * Global Variables
+ */
+/* cached catalog entries, the most recently used first */
+static btm_CatalogCacheEntry edubtm_catalogCache[BTM_CATALOG_CACHE_SIZE];
+static Four edubtm_nCatalogEntries = 0;
+
+
+
+/*@================================
+ * edubtm_GetCatalogEntry()
+ *================================*/
+/*
+ * Function: Four edubtm_GetCatalogEntry(ObjectID*, sm_CatOverlayForBtree*)
+ *
+ * Description :
+ *  Get the catalog entry of the B+ tree file. The page of the catalog
+ *  object is read only when the entry is not in the cache.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  1) parameter catEntry
+ *     catalog entry of the file
+ */
+Four edubtm_GetCatalogEntry(
+    ObjectID			*catObjForFile,	/* IN catalog object of the B+ tree file */
+    sm_CatOverlayForBtree	*catEntry)	/* OUT catalog entry of the file */
+{
+    Four			e;		/* error number */
+    Four			i;		/* index */
+    SlottedPage			*catPage;	/* buffer page containing the catalog object */
+    sm_CatOverlayForBtree	*pageEntry;	/* catalog entry in the buffer page */
+    btm_CatalogCacheEntry	found;		/* entry moved to the front */
+
+
+    for (i = 0; i < edubtm_nCatalogEntries; i++)
+        if (edubtm_catalogCache[i].catObj.pageNo == catObjForFile->pageNo &&
+            edubtm_catalogCache[i].catObj.volNo == catObjForFile->volNo &&
+            edubtm_catalogCache[i].catObj.slotNo == catObjForFile->slotNo &&
+            edubtm_catalogCache[i].catObj.unique == catObjForFile->unique) break;
+
+    if (i < edubtm_nCatalogEntries)
+        found = edubtm_catalogCache[i];
+    else {
+        e = BfM_GetTrain((TrainID*)catObjForFile, (char**)&catPage, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        GET_PTR_TO_CATENTRY_FOR_BTREE(catObjForFile, catPage, pageEntry);
+        found.catObj = *catObjForFile;
+        found.entry = *pageEntry;
+
+        e = BfM_FreeTrain((TrainID*)catObjForFile, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        /* the least recently used entry at the end is dropped if the cache is full */
+        if (i == BTM_CATALOG_CACHE_SIZE) i--;
+        else edubtm_nCatalogEntries++;
+    }
+
+    /*@ move the entry to the front */
+    memmove(&edubtm_catalogCache[1], &edubtm_catalogCache[0], i*sizeof(btm_CatalogCacheEntry));
+    edubtm_catalogCache[0] = found;
+
+    *catEntry = found.entry;
+
+    return(eNOERROR);
+
+} /* edubtm_GetCatalogEntry() */
@@ -0,0 +1,421 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: edubtm_Swizzle.c
+ *
+ * Description :
+ *  Swizzle and unswizzle the pages of a B+ tree.
+ *  The upper pages of a B+ tree are kept fixed in the buffer and linked by
+ *  main memory pointers, so that a descent reaches them without looking up
+ *  the buffer hash table and without fixing/unfixing each page. The number
+ *  of swizzled pages is bounded by a budget. When the budget is exhausted,
+ *  an internal page to be swizzled takes the place of a swizzled leaf page,
+ *  which is unswizzled (cooled); a leaf page is then simply not swizzled.
+ *  Thus the upper levels, which every descent goes through, stay swizzled
+ *  and random lookups do not churn the leaf pages in and out.
+ *  Any change of a B+ tree unswizzles all of its pages.
+ *
+ * Exports:
+ *  Four edubtm_LookUpSwizzledRoot(PageID*, btm_SwizzleNode**)
+ *  Four edubtm_SwizzleRoot(PageID*, BtreePage*, btm_SwizzleNode**)
+ *  Four edubtm_SwizzleChild(btm_SwizzleNode*, Two, PageID*, BtreePage*, btm_SwizzleNode**)
+ *  Four edubtm_Unswizzle(btm_SwizzleNode*)
+ *  Four edubtm_UnswizzleTree(PageID*)
+ */
+
+
+#include <stdlib.h> /* for malloc & free */
+#include "EduBtM_common.h"
+#include "BfM.h"
+#include "EduBtM_Internal.h"
+
+
+
+/*@
+ * Global Variables
+ */
+/* # of pages which may be kept swizzled at a time */
+Four edubtm_swizzleBudget = BTM_SWIZZLE_DEFAULT_BUDGET;
+
+/* statistics of the swizzled descent */
+btm_SwizzleStat edubtm_swizzleStat;
+
+/* swizzled roots of the B+ trees */
+static btm_SwizzleNode *edubtm_swizzledRoots[BTM_SWIZZLE_MAX_TREES];
+
+/* all swizzled pages, scanned by the cooling clock */
+static btm_SwizzleNode *edubtm_swizzledNodes[BTM_SWIZZLE_MAX_BUDGET];
+static Four edubtm_nSwizzledNodes = 0;
+static Four edubtm_coolingHand = 0;
+
+
+/*@ Internal Function Prototypes */
+static Four edubtm_Cool(btm_SwizzleNode*);
+
+
+
+/*@================================
+ * edubtm_NewSwizzleNode()
+ *================================*/
+/*
+ * Function: Four edubtm_NewSwizzleNode(PageID*, BtreePage*, btm_SwizzleNode*, Two, btm_SwizzleNode**)
+ *
+ * Description :
+ *  Make a swizzled node of the page 'pid' fixed at 'apage'. The node takes
+ *  over the fix of the caller. 'node' is set to NULL if there is no room in
+ *  the budget; then the caller keeps the fix.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR_EDUBTM - memory allocation error
+ *    some errors caused by function calls
+ */
+static Four edubtm_NewSwizzleNode(
+    PageID		*pid,		/* IN page to be swizzled */
+    BtreePage		*apage,		/* IN the page fixed by the caller */
+    btm_SwizzleNode	*parent,	/* IN swizzled parent (or NULL) */
+    Two			childNo,	/* IN index of the child pointer in the parent */
+    btm_SwizzleNode	**node)		/* OUT the swizzled node or NULL */
+{
+    Four		e;		/* error number */
+    Two			i;		/* index */
+    btm_SwizzleNode	*n;		/* the new node */
+
+
+    *node = NULL;
+
+    if (edubtm_nSwizzledNodes >= edubtm_swizzleBudget) {
+        /* only an internal page may take the place of a swizzled leaf page */
+        if (!(apage->any.hdr.type & INTERNAL)) return(eNOERROR);
+
+        e = edubtm_Cool(parent);
+        if (e < 0) ERR(e);
+        if (e == FALSE) return(eNOERROR);
+    }
+
+    n = (btm_SwizzleNode *)malloc(sizeof(btm_SwizzleNode));
+    if (n == NULL) ERR(eMEMORYALLOCERR_EDUBTM);
+
+    n->pid = *pid;
+    n->apage = apage;
+    n->parent = parent;
+    n->childNo = childNo;
+    n->nSwizzled = 0;
+    n->nChildren = (apage->any.hdr.type & INTERNAL) ? apage->bi.hdr.nSlots + 1 : 0;
+    n->child = NULL;
+
+    if (n->nChildren > 0) {
+        n->child = (btm_SwizzleNode **)malloc(sizeof(btm_SwizzleNode *) * n->nChildren);
+        if (n->child == NULL) {
+            free(n);
+            ERR(eMEMORYALLOCERR_EDUBTM);
+        }
+        for (i = 0; i < n->nChildren; i++) n->child[i] = NULL;
+    }
+
+    edubtm_swizzledNodes[edubtm_nSwizzledNodes++] = n;
+    edubtm_swizzleStat.nSwizzles++;
+
+    *node = n;
+
+    return(eNOERROR);
+
+} /* edubtm_NewSwizzleNode() */
+
+
+
+/*@================================
+ * edubtm_Cool()
+ *================================*/
+/*
+ * Function: Four edubtm_Cool(btm_SwizzleNode*)
+ *
+ * Description :
+ *  Unswizzle one swizzled leaf page to make room in the budget.
+ *  The page 'keep', which is being descended from, is never chosen.
+ *  The candidates are scanned by a clock.
+ *
+ * Returns:
+ *  1) TRUE if a page was unswizzled, FALSE if there was no candidate
+ *  2) Error codes: Negative value means error code.
+ *     some errors caused by function calls
+ */
+static Four edubtm_Cool(
+    btm_SwizzleNode	*keep)		/* IN node which must stay swizzled */
+{
+    Four		e;		/* error number */
+    Four		i;		/* loop index */
+    btm_SwizzleNode	*n;		/* candidate */
+
+
+    for (i = 0; i < edubtm_nSwizzledNodes; i++) {
+        if (edubtm_coolingHand >= edubtm_nSwizzledNodes) edubtm_coolingHand = 0;
+        n = edubtm_swizzledNodes[edubtm_coolingHand++];
+
+        if (n != keep && n->nChildren == 0) {
+            e = edubtm_Unswizzle(n);
+            if (e < 0) ERR(e);
+            return(TRUE);
+        }
+    }
+
+    return(FALSE);
+
+} /* edubtm_Cool() */
+
+
+
+/*@================================
+ * edubtm_LookUpSwizzledRoot()
+ *================================*/
+/*
+ * Function: Four edubtm_LookUpSwizzledRoot(PageID*, btm_SwizzleNode**)
+ *
+ * Description :
+ *  Return the swizzled root page of the B+ tree 'root';
+ *  'node' is set to NULL if the root is not swizzled.
+ *
+ * Returns:
+ *  error code
+ */
+Four edubtm_LookUpSwizzledRoot(
+    PageID		*root,		/* IN root of the B+ tree */
+    btm_SwizzleNode	**node)		/* OUT the swizzled root or NULL */
+{
+    Four		i;		/* index */
+
+
+    *node = NULL;
+
+    for (i = 0; i < BTM_SWIZZLE_MAX_TREES; i++) {
+        if (edubtm_swizzledRoots[i] != NULL && EQUAL_PAGEID(edubtm_swizzledRoots[i]->pid, *root)) {
+            *node = edubtm_swizzledRoots[i];
+            break;
+        }
+    }
+
+    return(eNOERROR);
+
+} /* edubtm_LookUpSwizzledRoot() */
+
+
+
+/*@================================
+ * edubtm_SwizzleRoot()
+ *================================*/
+/*
+ * Function: Four edubtm_SwizzleRoot(PageID*, BtreePage*, btm_SwizzleNode**)
+ *
+ * Description :
+ *  Swizzle the root page of the B+ tree 'root', which the caller has fixed
+ *  at 'apage'. If the root is swizzled, the fix is taken over; otherwise
+ *  'node' is set to NULL and the caller keeps the fix.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubtm_SwizzleRoot(
+    PageID		*root,		/* IN root of the B+ tree */
+    BtreePage		*apage,		/* IN the root page fixed by the caller */
+    btm_SwizzleNode	**node)		/* OUT the swizzled root or NULL */
+{
+    Four		e;		/* error number */
+    Four		i;		/* index */
+
+
+    *node = NULL;
+
+    for (i = 0; i < BTM_SWIZZLE_MAX_TREES; i++)
+        if (edubtm_swizzledRoots[i] == NULL) break;
+    if (i == BTM_SWIZZLE_MAX_TREES) return(eNOERROR);
+
+    e = edubtm_NewSwizzleNode(root, apage, NULL, 0, node);
+    if (e < 0) ERR(e);
+
+    edubtm_swizzledRoots[i] = *node;
+
+    return(eNOERROR);
+
+} /* edubtm_SwizzleRoot() */
+
+
+
+/*@================================
+ * edubtm_SwizzleChild()
+ *================================*/
+/*
+ * Function: Four edubtm_SwizzleChild(btm_SwizzleNode*, Two, PageID*, BtreePage*, btm_SwizzleNode**)
+ *
+ * Description :
+ *  Swizzle the child 'childNo' of the swizzled page 'parent', i.e. the page
+ *  'pid' which the caller has fixed at 'apage'. If the child is swizzled,
+ *  the fix is taken over; otherwise 'node' is set to NULL and the caller
+ *  keeps the fix.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubtm_SwizzleChild(
+    btm_SwizzleNode	*parent,	/* IN swizzled parent */
+    Two			childNo,	/* IN index of the child pointer */
+    PageID		*pid,		/* IN page id of the child */
+    BtreePage		*apage,		/* IN the child page fixed by the caller */
+    btm_SwizzleNode	**node)		/* OUT the swizzled child or NULL */
+{
+    Four		e;		/* error number */
+
+
+    e = edubtm_NewSwizzleNode(pid, apage, parent, childNo, node);
+    if (e < 0) ERR(e);
+
+    if (*node != NULL) {
+        parent->child[childNo] = *node;
+        parent->nSwizzled++;
+    }
+
+    return(eNOERROR);
+
+} /* edubtm_SwizzleChild() */
+
+
+
+/*@================================
+ * edubtm_Unswizzle()
+ *================================*/
+/*
+ * Function: Four edubtm_Unswizzle(btm_SwizzleNode*)
+ *
+ * Description :
+ *  Unswizzle the page 'node' and all its swizzled descendants:
+ *  replace the pointer in the parent by nothing (the PageID stored in the
+ *  parent page is used again) and unfix the page.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubtm_Unswizzle(
+    btm_SwizzleNode	*node)		/* IN node to be unswizzled */
+{
+    Four		e;		/* error number */
+    Four		i;		/* index */
+
+
+    for (i = 0; i < node->nChildren && node->nSwizzled > 0; i++) {
+        if (node->child[i] != NULL) {
+            e = edubtm_Unswizzle(node->child[i]);
+            if (e < 0) ERR(e);
+        }
+    }
+
+    if (node->parent != NULL) {
+        node->parent->child[node->childNo] = NULL;
+        node->parent->nSwizzled--;
+    }
+    else {
+        for (i = 0; i < BTM_SWIZZLE_MAX_TREES; i++)
+            if (edubtm_swizzledRoots[i] == node) edubtm_swizzledRoots[i] = NULL;
+    }
+
+    for (i = 0; i < edubtm_nSwizzledNodes; i++) {
+        if (edubtm_swizzledNodes[i] == node) {
+            edubtm_swizzledNodes[i] = edubtm_swizzledNodes[--edubtm_nSwizzledNodes];
+            break;
+        }
+    }
+
+    e = BfM_FreeTrain((TrainID *)&node->pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    if (node->child != NULL) free(node->child);
+    free(node);
+
+    edubtm_swizzleStat.nUnswizzles++;
+
+    return(eNOERROR);
+
+} /* edubtm_Unswizzle() */
+
+
+
+/*@================================
+ * edubtm_UnswizzleTree()
+ *================================*/
+/*
+ * Function: Four edubtm_UnswizzleTree(PageID*)
+ *
+ * Description :
+ *  Unswizzle all pages of the B+ tree 'root'; if 'root' is NULL, all pages
+ *  of all B+ trees are unswizzled. It is called before a B+ tree is changed
+ *  since the child pointers mirror the slots of the internal pages.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four edubtm_UnswizzleTree(
+    PageID		*root)		/* IN root of the B+ tree (or NULL) */
+{
+    Four		e;		/* error number */
+    Four		i;		/* index */
+
+
+    for (i = 0; i < BTM_SWIZZLE_MAX_TREES; i++) {
+        if (edubtm_swizzledRoots[i] == NULL) continue;
+        if (root != NULL && !EQUAL_PAGEID(edubtm_swizzledRoots[i]->pid, *root)) continue;
+
+        e = edubtm_Unswizzle(edubtm_swizzledRoots[i]);
+        if (e < 0) ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* edubtm_UnswizzleTree() */
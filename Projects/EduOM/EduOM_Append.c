@@ -0,0 +1,397 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_Append.c
+ *
+ * Description:
+ *  Append objects at the tail of a data file. Unlike a loop of
+ *  EduOM_CreateObject() calls, which fixes the last page again for every
+ *  object and moves it in and out of the available space lists, an append
+ *  cursor keeps the tail page fixed and only writes the object and its slot.
+ *  The file map is changed once per page, and the pages are allocated
+ *  APPEND_PREALLOC_PAGES at a time.
+ *
+ * Export:
+ *  Four EduOM_OpenAppend(ObjectID*, ObjectAppendCursor*)
+ *  Four EduOM_AppendObject(ObjectAppendCursor*, ObjectHdr*, Four, char*, ObjectID*)
+ *  Four EduOM_CloseAppend(ObjectAppendCursor*)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "RDsM.h"		/* for the raw disk manager call */
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+
+
+
+/*@ Internal Function Prototypes */
+static Four eduom_NextAppendPage(ObjectAppendCursor*);
+static Four eduom_LeaveAppendPage(ObjectAppendCursor*);
+
+
+
+/*@================================
+ * EduOM_OpenAppend()
+ *================================*/
+/*
+ * Function: Four EduOM_OpenAppend(ObjectID*, ObjectAppendCursor*)
+ *
+ * Description:
+ *  Open an append cursor on the last page of the file. The page stays
+ *  fixed until it is full or the cursor is closed, and it is not offered
+ *  to the other object creations of the file until then.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    eNOTSUPPORTED_EDUOM
+ *    some errors caused by function calls
+ *
+ * Side effect:
+ *  1) parameter cursor
+ *     cursor is initialized
+ */
+Four EduOM_OpenAppend(
+    ObjectID  *catObjForFile,	/* IN file to append the objects to */
+    ObjectAppendCursor *cursor)	/* OUT cursor to open */
+{
+    Four e;			/* error */
+    sm_CatOverlayForData *catEntry; /* data structure for catalog object access */
+
+
+    /*@ parameter checking */
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (cursor == NULL) ERR(eBADPARAMETER_OM);
+
+    cursor->catObj = *catObjForFile;
+    cursor->apage = NULL;
+    cursor->nPrealloc = 0;
+    cursor->nextPrealloc = 0;
+
+    /* the cached last page is checked against the page list of the file */
+    e = eduom_GetLastPage(catObjForFile, &catEntry, &cursor->pid, &cursor->apage);
+    if (e < 0) {
+        cursor->apage = NULL;
+        ERR(e);
+    }
+
+    /* a record of the PAX layout is not appended as an object */
+    if (IS_PAX_PAGE(cursor->apage)) {
+        cursor->apage = NULL;
+        ERRB1(eNOTSUPPORTED_EDUOM, &cursor->pid, PAGE_BUF);
+    }
+
+    /*@ keep the tail page to ourselves */
+    e = om_RemoveFromAvailSpaceList(catObjForFile, &cursor->pid, cursor->apage);
+    if (e >= 0) e = eduom_FsmUpdate(catObjForFile, catEntry, &cursor->pid, 0);
+    if (e < 0) {
+        cursor->apage = NULL;
+        ERRB1(e, &cursor->pid, PAGE_BUF);
+    }
+
+    return(eNOERROR);
+
+} /* EduOM_OpenAppend() */
+
+
+
+/*@================================
+ * EduOM_AppendObject()
+ *================================*/
+/*
+ * Function: Four EduOM_AppendObject(ObjectAppendCursor*, ObjectHdr*, Four, char*, ObjectID*)
+ *
+ * Description:
+ *  Create a new object at the end of the tail page of the file. The object
+ *  always takes a new slot, and the page is not compacted; if the
+ *  contiguous free area of the tail page is too small, the next page
+ *  allocated in advance becomes the tail page.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    eBADLENGTH_OM
+ *    eBADUSERBUF_OM
+ *    eNOTSUPPORTED_EDUOM
+ *    some errors caused by function calls
+ *
+ * Side effect:
+ *  1) parameter oid
+ *     'oid' is set to the ObjectID of the newly created object.
+ */
+Four EduOM_AppendObject(
+    ObjectAppendCursor *cursor,	/* INOUT append cursor */
+    ObjectHdr *objHdr,		/* IN from which tag is to be set */
+    Four      length,		/* IN amount of data */
+    char      *data,		/* IN the initial data for the object */
+    ObjectID  *oid)		/* OUT the object's ObjectID */
+{
+    Four e;			/* error */
+    Four alignedLen;		/* aligned length of the data */
+    Four neededSpace;		/* space needed for the object and its slot */
+    SlottedPage *apage;		/* tail page */
+    Object *obj;		/* the new object in the page */
+    Two slotNo;			/* slot of the new object */
+
+
+    /*@ parameter checking */
+    if (cursor == NULL || cursor->apage == NULL) ERR(eBADPARAMETER_OM);
+
+    if (length < 0) ERR(eBADLENGTH_OM);
+
+    if (length > 0 && data == NULL) ERR(eBADUSERBUF_OM);
+
+    if (oid == NULL) ERR(eBADOBJECTID_OM);
+
+    if (ALIGNED_LENGTH(length) > LRGOBJ_THRESHOLD) ERR(eNOTSUPPORTED_EDUOM);
+
+    alignedLen = DATA_LENGTH_IN_PAGE(length);
+    neededSpace = sizeof(ObjectHdr) + alignedLen + sizeof(SlottedPageSlot);
+
+    if (neededSpace > SP_CFREE(cursor->apage)) {
+        e = eduom_NextAppendPage(cursor);
+        if (e < 0) ERR(e);
+    }
+
+    apage = cursor->apage;
+    slotNo = apage->header.nSlots;
+
+    obj = (Object *)&(apage->data[apage->header.free]);
+    obj->header.properties = 0x0;
+    obj->header.tag = (objHdr == NULL) ? 0 : objHdr->tag;
+    obj->header.length = length;
+    memcpy(obj->data, data, length);
+
+    apage->slot[-slotNo].offset = apage->header.free;
+    e = om_GetUnique(&cursor->pid, &(apage->slot[-slotNo].unique));
+    if (e < 0) ERR(e);
+
+    apage->header.free += sizeof(ObjectHdr) + alignedLen;
+    apage->header.nSlots++;
+
+    MAKE_OBJECTID(*oid, cursor->pid.volNo, cursor->pid.pageNo, slotNo, apage->slot[-slotNo].unique);
+
+    return(eNOERROR);
+
+} /* EduOM_AppendObject() */
+
+
+
+/*@================================
+ * EduOM_CloseAppend()
+ *================================*/
+/*
+ * Function: Four EduOM_CloseAppend(ObjectAppendCursor*)
+ *
+ * Description:
+ *  Close the append cursor. The tail page is put back into the available
+ *  space lists and the free-space map, and the pages allocated in advance
+ *  and not used are freed at once; they have never been part of the file.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_CloseAppend(
+    ObjectAppendCursor *cursor)	/* INOUT cursor to close */
+{
+    Four e;			/* error */
+
+
+    /*@ parameter checking */
+    if (cursor == NULL) ERR(eBADPARAMETER_OM);
+
+    if (cursor->apage != NULL) {
+        e = eduom_LeaveAppendPage(cursor);
+        if (e < 0) ERR(e);
+    }
+
+    /*@ give back the pages allocated in advance */
+    for ( ; cursor->nextPrealloc < cursor->nPrealloc; cursor->nextPrealloc++) {
+        e = RDsM_FreeTrain(&cursor->prealloc[cursor->nextPrealloc], PAGESIZE2);
+        if (e < 0) ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* EduOM_CloseAppend() */
+
+
+
+/*@================================
+ * eduom_NextAppendPage()
+ *================================*/
+/*
+ * Function: static Four eduom_NextAppendPage(ObjectAppendCursor*)
+ *
+ * Description:
+ *  Make the next page allocated in advance the tail page of the file,
+ *  allocating APPEND_PREALLOC_PAGES more pages near the tail page if none
+ *  is left, and leave the old tail page. The new page is initialized and
+ *  marked dirty before it is linked into the file; if linking fails, it
+ *  stays among the pages allocated in advance. Once it is linked it is the
+ *  tail page of the cursor even if leaving the old tail page fails, so the
+ *  file never has a linked page which is not written.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_NextAppendPage(
+    ObjectAppendCursor *cursor)	/* INOUT append cursor */
+{
+    Four e;			/* error */
+    Four firstExt;		/* first extent of the file */
+    PageID pid;			/* the new tail page */
+    SlottedPage *apage;		/* buffer of the new tail page */
+    PhysicalFileID pFid;	/* physical ID of the file */
+    sm_CatOverlayForData *catEntry; /* data structure for catalog object access */
+
+
+    e = eduom_GetCatalogEntry(&cursor->catObj, &catEntry);
+    if (e < 0) ERR(e);
+
+    /*@ allocate the next pages at once */
+    if (cursor->nextPrealloc == cursor->nPrealloc) {
+        MAKE_PHYSICALFILEID(pFid, catEntry->fid.volNo, catEntry->firstPage);
+        e = RDsM_PageIdToExtNo((PageID *)&pFid, &firstExt);
+        if (e >= 0)
+            e = RDsM_AllocTrains(catEntry->fid.volNo, firstExt, &cursor->pid, catEntry->eff,
+                                 APPEND_PREALLOC_PAGES, PAGESIZE2, cursor->prealloc);
+        if (e < 0) ERR(e);
+
+        cursor->nPrealloc = APPEND_PREALLOC_PAGES;
+        cursor->nextPrealloc = 0;
+    }
+
+    pid = cursor->prealloc[cursor->nextPrealloc];
+
+    e = BfM_GetNewTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    apage->header.pid = pid;
+    apage->header.flags = SLOTTED_PAGE_TYPE;
+    SP_SET_FREESLOT_HEAD(apage, NIL);
+    apage->header.nSlots = 0;
+    apage->header.free = 0;
+    apage->header.unused = 0;
+    apage->header.fid = catEntry->fid;
+    apage->header.unique = 0;
+    apage->header.uniqueLimit = 0;
+    apage->header.prevPage = cursor->pid.pageNo;
+    apage->header.nextPage = NIL;
+    apage->header.spaceListPrev = NIL;
+    apage->header.spaceListNext = NIL;
+
+    e = BfM_SetDirty((TrainID *)&pid, PAGE_BUF);
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    /*@ the new page follows the tail page in the file */
+    e = om_FileMapAddPage(&cursor->catObj, &cursor->pid, &pid);
+    eduom_InvalidateCatalogEntry(&cursor->catObj);
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    cursor->nextPrealloc++;
+
+    /*@ leave the old tail page; the new page is the tail page from now on */
+    e = eduom_LeaveAppendPage(cursor);
+
+    cursor->pid = pid;
+    cursor->apage = apage;
+
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* eduom_NextAppendPage() */
+
+
+
+/*@================================
+ * eduom_LeaveAppendPage()
+ *================================*/
+/*
+ * Function: static Four eduom_LeaveAppendPage(ObjectAppendCursor*)
+ *
+ * Description:
+ *  Put the tail page of the cursor back into the available space lists and
+ *  the free-space map of the file, and unfix it.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_LeaveAppendPage(
+    ObjectAppendCursor *cursor)	/* INOUT append cursor */
+{
+    Four e;			/* error */
+    SlottedPage *apage;		/* tail page */
+    sm_CatOverlayForData *catEntry; /* data structure for catalog object access */
+
+
+    apage = cursor->apage;
+    cursor->apage = NULL;
+
+    e = eduom_GetCatalogEntry(&cursor->catObj, &catEntry);
+    if (e >= 0) e = om_PutInAvailSpaceList(&cursor->catObj, &cursor->pid, apage);
+    if (e >= 0) e = eduom_FsmUpdate(&cursor->catObj, catEntry, &cursor->pid, SP_FREE(apage));
+    if (e >= 0) e = BfM_SetDirty((TrainID *)&cursor->pid, PAGE_BUF);
+    if (e < 0) ERRB1(e, &cursor->pid, PAGE_BUF);
+
+    e = BfM_FreeTrain((TrainID *)&cursor->pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* eduom_LeaveAppendPage() */
@@ -0,0 +1,310 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_AppendToObject.c
+ * 
+ * Description :
+ *  EduOM_AppendToObject() appends data to the end of an object.
+ *
+ * Exports:
+ *  Four EduOM_AppendToObject(ObjectID*, ObjectID*, Four, char*, Pool*, DeallocListElem*)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "BfM.h"		/* for the buffer manager call */
+#include "LOT.h"		/* for the large object manager call */
+#include "EduOM_Internal.h"
+#include "EduOM.h"
+
+
+
+/*@ Internal Function Prototypes */
+static Four eduom_AppendToMovedObject(ObjectID*, sm_CatOverlayForData*, ObjectID*, ObjectID*,
+				      Four, char*, Pool*, DeallocListElem*);
+
+
+
+/*@================================
+ * EduOM_AppendToObject()
+ *================================*/
+/*
+ * Function: Four EduOM_AppendToObject(ObjectID*, ObjectID*, Four, char*, Pool*, DeallocListElem*)
+ * 
+ * Description :
+ *  (1) What to do?
+ *  EduOM_AppendToObject() appends 'length' bytes of 'data' to the end of
+ *  the object 'oid'. An object which outgrows its page is converted into
+ *  a large object; the data of a large object is kept in a tree whose
+ *  leaves are trains of TRAINSIZE pages, and only the root of the tree
+ *  stays in the slotted page. An object of any size can thus be written
+ *  a piece at a time without ever having the whole of it in memory.
+ *
+ *  (2) How to do?
+ *  a. Read in the slotted page
+ *  b. IF moved object THEN
+ *	   append to it with eduom_AppendToMovedObject() and return
+ *     ENDIF
+ *     Remove this page from the 'availSpaceList'
+ *  c. IF small object and the grown object still fits in the page THEN
+ *	   IF the object is not followed by enough contiguous free space THEN
+ *	       compact the page moving the object to the end
+ *	   ENDIF
+ *	   copy the data after the object
+ *     ELSE
+ *	   IF small object THEN
+ *	       compact the page moving the object to the end unless it is
+ *	           there already
+ *	       call the large object manager's LOT_ConvertToLarge()
+ *	   ENDIF
+ *	   call the large object manager's LOT_AppendToObject()
+ *     ENDIF
+ *  d. Update the length of the object
+ *  e. Put this page into the proper 'availSpaceList' and record its free
+ *     space in the free-space map of the file
+ *  f. Return
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADOBJECTID_OM
+ *    eBADLENGTH_OM
+ *    eBADUSERBUF_OM
+ *    eNOTSUPPORTED_EDUOM
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  The object may be converted into a large object; 'dlPool' and 'dlHead'
+ *  are used only when the object to convert has been moved from its page.
+ */
+Four EduOM_AppendToObject(
+    ObjectID  *catObjForFile,	/* IN file containing the object */
+    ObjectID  *oid,		/* IN object to append to */
+    Four      length,		/* IN amount of data to append */
+    char      *data,		/* IN data to append */
+    Pool      *dlPool,		/* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead)	/* INOUT head of dealloc list */
+{
+    Four        e;		/* error number */
+    PageID      pid;		/* page on which the object resides */
+    SlottedPage *apage;		/* pointer to the buffer holding the page */
+    Object      *obj;		/* points to the object in data area */
+    Four        alignedLen;	/* aligned length of the object data */
+    Four        newAlignedLen;	/* aligned length of the object data after appending */
+    sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
+    ObjectID    movedOid;	/* where the data of a moved object is */
+
+
+    /*@ parameter checking */
+
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (oid == NULL) ERR(eBADOBJECTID_OM);
+
+    if (length < 0) ERR(eBADLENGTH_OM);
+
+    if (length > 0 && data == NULL) ERR(eBADUSERBUF_OM);
+
+    if (length == 0) return(eNOERROR);
+
+    e = eduom_GetCatalogEntry(catObjForFile, &catEntry);
+    if (e < 0) ERR(e);
+
+    MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
+
+    e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    if (oid->slotNo < 0 || oid->slotNo >= apage->header.nSlots || !IS_VALID_OBJECTID(oid, apage))
+        ERRB1(eBADOBJECTID_OM, &pid, PAGE_BUF);
+
+    /* a record of the PAX layout keeps its length */
+    if (IS_PAX_PAGE(apage)) ERRB1(eNOTSUPPORTED_EDUOM, &pid, PAGE_BUF);
+
+    obj = (Object *)&(apage->data[apage->slot[-(oid->slotNo)].offset]);
+
+    /* the data of a moved object is reached only through its stub */
+    if (obj->header.properties & P_FORWARDED) ERRB1(eBADOBJECTID_OM, &pid, PAGE_BUF);
+
+    if (obj->header.properties & P_MOVED) {
+        memcpy(&movedOid, obj->data, sizeof(ObjectID));
+
+        e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        e = eduom_AppendToMovedObject(catObjForFile, catEntry, oid, &movedOid, length, data, dlPool, dlHead);
+        if (e < 0) ERR(e);
+
+        return(eNOERROR);
+    }
+
+    e = om_RemoveFromAvailSpaceList(catObjForFile, &pid, apage);
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    alignedLen = DATA_LENGTH_IN_PAGE(obj->header.length);
+    newAlignedLen = DATA_LENGTH_IN_PAGE(obj->header.length + length);
+
+    if (!(obj->header.properties & P_LRGOBJ) &&
+        newAlignedLen <= LRGOBJ_THRESHOLD && newAlignedLen - alignedLen <= SP_FREE(apage)) {
+
+        /*@ grow the object within the page */
+        if (apage->slot[-(oid->slotNo)].offset + sizeof(ObjectHdr) + alignedLen != apage->header.free ||
+            newAlignedLen - alignedLen > SP_CFREE(apage)) {
+            EduOM_CompactPage(apage, oid->slotNo);
+            obj = (Object *)&(apage->data[apage->slot[-(oid->slotNo)].offset]);
+        }
+
+        memcpy(&(obj->data[obj->header.length]), data, length);
+        apage->header.free += newAlignedLen - alignedLen;
+    }
+    else {
+        /*@ grow the object by its tree of trains */
+        if (!(obj->header.properties & P_LRGOBJ)) {
+            /* the root replaces the object in place when the object is at the end of the data area */
+            if (apage->slot[-(oid->slotNo)].offset + sizeof(ObjectHdr) + alignedLen != apage->header.free) {
+                EduOM_CompactPage(apage, oid->slotNo);
+                obj = (Object *)&(apage->data[apage->slot[-(oid->slotNo)].offset]);
+            }
+
+            e = LOT_ConvertToLarge(catObjForFile, apage, oid->slotNo, dlPool, dlHead);
+            if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+        }
+
+        e = LOT_AppendToObject(catObjForFile, &pid, oid->slotNo, length, data);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+        /* the root may have been moved within the page */
+        obj = (Object *)&(apage->data[apage->slot[-(oid->slotNo)].offset]);
+    }
+
+    obj->header.length += length;
+
+    e = om_PutInAvailSpaceList(catObjForFile, &pid, apage);
+    if (e >= 0) e = eduom_FsmUpdate(catObjForFile, catEntry, &pid, SP_FREE(apage));
+    if (e >= 0) e = BfM_SetDirty((TrainID *)&pid, PAGE_BUF);
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+    
+} /* EduOM_AppendToObject() */
+
+
+
+/*@================================
+ * eduom_AppendToMovedObject()
+ *================================*/
+/*
+ * Function: static Four eduom_AppendToMovedObject(ObjectID*, sm_CatOverlayForData*, ObjectID*, ObjectID*,
+ *                                                 Four, char*, Pool*, DeallocListElem*)
+ * 
+ * Description :
+ *  Append 'length' bytes of 'data' to the object 'oid' whose data has been
+ *  moved to 'movedOid'. While the grown object is still a small one it is
+ *  rewritten with EduOM_UpdateObject(), which keeps it where it is or moves
+ *  it again; otherwise its data is brought back into the home slot, which
+ *  is never too small for the root of a large object, and appended to from
+ *  there.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_AppendToMovedObject(
+    ObjectID  *catObjForFile,	/* IN file containing the object */
+    sm_CatOverlayForData *catEntry, /* IN catalog entry of the file */
+    ObjectID  *oid,		/* IN object to append to */
+    ObjectID  *movedOid,	/* IN where the data of the object is */
+    Four      length,		/* IN amount of data to append */
+    char      *data,		/* IN data to append */
+    Pool      *dlPool,		/* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead)	/* INOUT head of dealloc list */
+{
+    Four        e;		/* error number */
+    PageID      pid;		/* page on which the moved data resides */
+    SlottedPage *apage;		/* pointer to the buffer holding the page */
+    Object      *obj;		/* points to the moved data */
+    Four        movedLength;	/* length of the moved data */
+    char        buf[LRGOBJ_THRESHOLD]; /* the moved data (and the appended data) */
+
+
+    MAKE_PAGEID(pid, movedOid->volNo, movedOid->pageNo);
+
+    e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    obj = (Object *)&(apage->data[apage->slot[-(movedOid->slotNo)].offset]);
+    movedLength = obj->header.length;
+    memcpy(buf, obj->data, movedLength);
+
+    e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    if (ALIGNED_LENGTH(movedLength + length) <= LRGOBJ_THRESHOLD) {
+        memcpy(&buf[movedLength], data, length);
+
+        return(EduOM_UpdateObject(catObjForFile, oid, movedLength + length, buf, dlPool, dlHead));
+    }
+
+    /*@ bring the data home emptied and grow it from there */
+    e = eduom_ReplaceObject(catObjForFile, catEntry, oid, 0, 0, NULL);
+    if (e < 0) ERR(e);
+
+    e = EduOM_DestroyObject(catObjForFile, movedOid, dlPool, dlHead);
+    if (e < 0) ERR(e);
+
+    e = EduOM_AppendToObject(catObjForFile, oid, movedLength, buf, dlPool, dlHead);
+    if (e < 0) ERR(e);
+
+    return(EduOM_AppendToObject(catObjForFile, oid, length, data, dlPool, dlHead));
+
+} /* eduom_AppendToMovedObject() */
@@ -0,0 +1,1582 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_Bench.c
+ *
+ * Description : 
+ *  Benchmark of EduOM.
+ *  Free-space management: objects of random sizes are inserted into a file,
+ *  a random half of them is destroyed, and as many objects as destroyed are
+ *  inserted again; this is run through OM_CreateObject() (placing objects
+ *  by the available space lists) and through EduOM_CreateObject() (placing
+ *  them by the free-space map), each on a freshly formatted volume, and the
+ *  throughput and the space utilization of the file are reported after
+ *  every phase.
+ *  Bulk load: objects of random sizes are loaded into a new file through
+ *  EduOM_CreateObject() one by one and through EduOM_CreateObjects() in
+ *  batches of BENCH_LOAD_BATCH objects, and are read back to check them.
+ *  Append: the same objects are appended through an append cursor.
+ *  Batched read: objects loaded in bulk are read in random order through
+ *  EduOM_ReadObject() one by one and through EduOM_ReadObjects() in batches
+ *  of BENCH_LOAD_BATCH objects.
+ *  Pinned read: the first bytes of the objects loaded in bulk are looked at
+ *  in random order, copying every object through EduOM_ReadObject() and
+ *  through a view of the object pinned in the buffer.
+ *  Scan: a file loaded in bulk is scanned through EduOM_NextObject() object by
+ *  object and through a scan cursor page by page.
+ *  Filter: the objects of a file loaded in bulk whose first integer is less
+ *  than BENCH_FILTER_SELECT of BENCH_FILTER_RANGE are selected, reading every
+ *  object through EduOM_ReadObject() to compare it, and pushing the filter
+ *  down into the scan.
+ *  Parallel scan: every byte of a file loaded in bulk is summed up by a scan
+ *  cursor and by parallel scans with 1 to BENCH_MAX_THREADS threads.
+ *  Update: every object of a file loaded in bulk is grown by up to
+ *  'max object size' bytes and then shrunk to a random size, through
+ *  EduOM_UpdateObject() and through destroying and creating the object
+ *  again; the objects moved by growing are counted and moved back with
+ *  EduOM_CollapseForwards() afterwards.
+ *  Page compaction: BENCH_COMPACT_PAGES pages are filled with objects of
+ *  random sizes in a random order of their slots, a random part of them is
+ *  destroyed to leave holes, and the pages are compacted by
+ *  EduOM_CompactPage(), keeping the order of the objects or moving a random
+ *  object to the end; after every compaction the contents, the slot
+ *  offsets, 'free' and 'unused' of the page are checked.
+ *  Large object: a BENCH_LRGOBJ_SIZE byte object is created at once and by
+ *  appending BENCH_LRGOBJ_CHUNK bytes at a time, read sequentially and at
+ *  random in chunks, overwritten at random in chunks, and truncated to a
+ *  half; its content is checked after every phase.
+ *  PAX layout: records of a fixed schema are loaded into a file of slotted
+ *  pages and into a file of the PAX layout, and one integer column of all
+ *  of them is summed up BENCH_PAX_SCANS times, by a scan cursor and by a
+ *  projection scan; a half of the records is then destroyed and the sum is
+ *  checked again.
+ *  Slot reuse: a file is loaded in bulk with BENCH_SLOT_TINY byte objects,
+ *  about 250 slots a page, and with BENCH_SLOT_SMALL byte objects; every
+ *  BENCH_SLOT_GAP-th object is destroyed to leave empty slots and free space
+ *  in every page, and the file is churned: a random object is destroyed and
+ *  created again near its neighbor, reusing an empty slot of the page,
+ *  BENCH_SLOT_ROUNDS times '# of objects' times.
+ *
+ *  Usage: EduOM_Bench [# of objects] [min object size] [max object size]
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "EduOM_common.h"
+#include "LOT.h"		/* for OBJECT_SIZE_IN_PAGE() */
+#include "EduOM.h"
+#include "EduOM_TestModule.h"
+
+
+#define BENCH_DEFAULT_NOBJECTS	20000
+#define BENCH_DEFAULT_MINSIZE	20
+#define BENCH_DEFAULT_MAXSIZE	1000
+#define BENCH_LOAD_BATCH		1000	/* # of objects per EduOM_CreateObjects() call */
+#define BENCH_MAX_THREADS		8		/* parallel scans run with 1, 2, 4, ... threads up to this */
+#define BENCH_LRGOBJ_SIZE		(8 * 1024 * 1024)	/* size of the large object */
+#define BENCH_LRGOBJ_CHUNK		(64 * 1024)	/* unit of reading and writing the large object */
+#define BENCH_PAX_SCANS			100		/* # of times the records are summed up */
+#define BENCH_SLOT_TINY			4		/* size of the objects filling a page with slots */
+#define BENCH_SLOT_SMALL		64		/* size of the objects of the comparison run */
+#define BENCH_SLOT_GAP			8		/* one object in this many is destroyed before the churn */
+#define BENCH_SLOT_ROUNDS		10		/* # of churns per object */
+#define BENCH_COMPACT_PAGES		20000	/* # of pages compacted */
+#define BENCH_FILTER_RANGE		1000	/* the first integers of the objects are below this */
+#define BENCH_FILTER_SELECT		100		/* the objects whose first integer is below this are selected */
+
+/* what a thread of a parallel scan has seen, padded to a cache line of its own */
+typedef struct {
+	Four	nObjects;
+	UFour	checksum;
+	char	pad[64 - sizeof(Four) - sizeof(UFour)];
+} BenchScanTotal;
+
+Four SM_CreateFile(Four, FileID*, Boolean, ObjectID*);
+Four sm_GetCatalogEntryFromDataFileId(Four, FileID*, ObjectID*);
+Four OM_CreateObject(ObjectID*, ObjectID*, ObjectHdr*, Four, void*, ObjectID*);
+Four OM_DestroyObject(ObjectID*, ObjectID*, Pool*, DeallocListElem*);
+
+
+/* time in seconds */
+static double benchNow(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+/* random number in [0, n) */
+static Four benchRandom(UFour *seed, Four n)
+{
+	*seed = *seed * 1103515245 + 12345;
+	return (Four)((*seed >> 8) % n);
+}
+
+
+/* create a new data file */
+static Four benchCreateFile(Four volId, ObjectID *catalogEntry)
+{
+	Four		e;
+	FileID		fid;
+
+	e = SM_CreateFile(volId, &fid, FALSE, NULL);
+	if (e < eNOERROR) ERR(e);
+
+	e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid, catalogEntry);
+	if (e < eNOERROR) ERR(e);
+
+	return(eNOERROR);
+}
+
+
+/* # of pages of the file and # of bytes of the objects in them */
+static Four benchFileSpace(ObjectID *catalogEntry, Four *nPages, Four *nBytes)
+{
+	Four		e;
+	Four		i;
+	PageID		pid;
+	ShortPageID	pageNo;
+	SlottedPage	*apage;
+	SlottedPage	*catPage;
+	sm_CatOverlayForData *catEntry;
+	Object		*obj;
+
+	e = BfM_GetTrain((TrainID *)catalogEntry, (char **)&catPage, PAGE_BUF);
+	if (e < eNOERROR) ERR(e);
+	GET_PTR_TO_CATENTRY_FOR_DATA(catalogEntry, catPage, catEntry);
+
+	*nPages = *nBytes = 0;
+	for (pageNo = catEntry->firstPage; pageNo != NIL; pageNo = apage->header.nextPage) {
+		MAKE_PAGEID(pid, catEntry->fid.volNo, pageNo);
+		e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+		if (e < eNOERROR) ERR(e);
+
+		(*nPages)++;
+		if (IS_PAX_PAGE(apage)) *nBytes += PAX_HDR(apage)->nRecords * PAX_HDR(apage)->recordLength;
+		for (i = 0; i < apage->header.nSlots && !IS_PAX_PAGE(apage); i++) {
+			if (apage->slot[-i].offset == EMPTYSLOT) continue;
+			obj = (Object *)&(apage->data[apage->slot[-i].offset]);
+			*nBytes += obj->header.length;
+		}
+
+		e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+		if (e < eNOERROR) ERR(e);
+	}
+
+	e = BfM_FreeTrain((TrainID *)catalogEntry, PAGE_BUF);
+	if (e < eNOERROR) ERR(e);
+
+	return(eNOERROR);
+}
+
+
+static Four benchReport(ObjectID *catalogEntry, char *label, char *phase, Four nOps, double elapsed)
+{
+	Four		e;
+	Four		nPages, nBytes;
+
+	e = benchFileSpace(catalogEntry, &nPages, &nBytes);
+	if (e < eNOERROR) ERR(e);
+
+	printf("%-22s %-10s %12.0f %8ld %10.2f%%\n", label, phase, nOps / elapsed, nPages,
+		   100.0 * nBytes / ((double)nPages * (PAGESIZE - SP_FIXED)));
+
+	return(eNOERROR);
+}
+
+
+/* insert, destroy a half, insert again; 'edu' selects EduOM_CreateObject()/EduOM_DestroyObject() */
+static Four benchFreeSpace(Four volId, Four nObjects, Four minSize, Four maxSize, Boolean edu, char *label)
+{
+	Four		e;
+	Four		i, j;
+	Four		length;
+	Four		nDestroyed;
+	UFour		seed = 4711;	/* the same sequence for every run */
+	ObjectID	catalogEntry;
+	ObjectID	*oids;
+	ObjectID	tmp;
+	char		data[LRGOBJ_THRESHOLD];
+	double		start;
+
+	oids = (ObjectID *)malloc(sizeof(ObjectID) * nObjects);
+	if (oids == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+	memset(data, 'x', sizeof(data));
+
+	e = benchCreateFile(volId, &catalogEntry);
+	if (e < eNOERROR) ERR(e);
+
+	start = benchNow();
+	for (i = 0; i < nObjects; i++) {
+		length = minSize + benchRandom(&seed, maxSize - minSize + 1);
+		if (edu) e = EduOM_CreateObject(&catalogEntry, NULL, NULL, length, data, &oids[i]);
+		else e = OM_CreateObject(&catalogEntry, NULL, NULL, length, data, &oids[i]);
+		if (e < eNOERROR) ERR(e);
+	}
+	e = benchReport(&catalogEntry, label, "insert", nObjects, benchNow() - start);
+	if (e < eNOERROR) ERR(e);
+
+	/* destroy a random half */
+	for (i = nObjects - 1; i > 0; i--) {
+		j = benchRandom(&seed, i + 1);
+		tmp = oids[i]; oids[i] = oids[j]; oids[j] = tmp;
+	}
+	nDestroyed = nObjects / 2;
+	start = benchNow();
+	for (i = 0; i < nDestroyed; i++) {
+		if (edu) e = EduOM_DestroyObject(&catalogEntry, &oids[i], &dlPool, &dlHead);
+		else e = OM_DestroyObject(&catalogEntry, &oids[i], &dlPool, &dlHead);
+		if (e < eNOERROR) ERR(e);
+	}
+	e = benchReport(&catalogEntry, label, "destroy", nDestroyed, benchNow() - start);
+	if (e < eNOERROR) ERR(e);
+
+	start = benchNow();
+	for (i = 0; i < nDestroyed; i++) {
+		length = minSize + benchRandom(&seed, maxSize - minSize + 1);
+		if (edu) e = EduOM_CreateObject(&catalogEntry, NULL, NULL, length, data, &oids[i]);
+		else e = OM_CreateObject(&catalogEntry, NULL, NULL, length, data, &oids[i]);
+		if (e < eNOERROR) ERR(e);
+	}
+	e = benchReport(&catalogEntry, label, "reinsert", nDestroyed, benchNow() - start);
+	if (e < eNOERROR) ERR(e);
+
+	free(oids);
+
+	return(eNOERROR);
+}
+
+
+/* load objects of random sizes into a new file, one by one or in batches ('bulk'), and read them back */
+static Four benchLoad(Four volId, Four nObjects, Four minSize, Four maxSize, Boolean bulk, char *label)
+{
+	Four		e;
+	Four		i, n;
+	UFour		seed = 4711;	/* the same sequence for every run */
+	ObjectID	catalogEntry;
+	ObjectID	*oids;
+	Four		*lengths;
+	char		**data;
+	char		pattern[LRGOBJ_THRESHOLD + 256];
+	char		buf[LRGOBJ_THRESHOLD];
+	double		start;
+
+	oids = (ObjectID *)malloc(sizeof(ObjectID) * nObjects);
+	lengths = (Four *)malloc(sizeof(Four) * nObjects);
+	data = (char **)malloc(sizeof(char *) * nObjects);
+	if (oids == NULL || lengths == NULL || data == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+
+	/* object i starts at its own offset of the pattern so that misplaced data is noticed */
+	for (i = 0; i < sizeof(pattern); i++) pattern[i] = (char)(i * 7);
+	for (i = 0; i < nObjects; i++) {
+		lengths[i] = minSize + benchRandom(&seed, maxSize - minSize + 1);
+		data[i] = &pattern[i % 256];
+	}
+
+	e = benchCreateFile(volId, &catalogEntry);
+	if (e < eNOERROR) ERR(e);
+
+	start = benchNow();
+	for (i = 0; i < nObjects; i += n) {
+		if (bulk) {
+			n = MAX(1, BENCH_LOAD_BATCH);
+			if (n > nObjects - i) n = nObjects - i;
+			e = EduOM_CreateObjects(&catalogEntry, n, NULL, &lengths[i], &data[i], &oids[i]);
+		}
+		else {
+			n = 1;
+			e = EduOM_CreateObject(&catalogEntry, NULL, NULL, lengths[i], data[i], &oids[i]);
+		}
+		if (e < eNOERROR) ERR(e);
+	}
+	e = benchReport(&catalogEntry, label, "load", nObjects, benchNow() - start);
+	if (e < eNOERROR) ERR(e);
+
+	for (i = 0; i < nObjects; i++) {
+		e = EduOM_ReadObject(&oids[i], 0, lengths[i], buf);
+		if (e < eNOERROR) ERR(e);
+		if (e != lengths[i] || memcmp(buf, data[i], lengths[i]) != 0) {
+			printf("object %ld read back wrong\n", i);
+			ERR(eBADOBJECTID_OM);
+		}
+	}
+
+	free(oids);
+	free(lengths);
+	free(data);
+
+	return(eNOERROR);
+}
+
+
+/* append objects of random sizes to a new file through an append cursor, and read them back */
+static Four benchAppend(Four volId, Four nObjects, Four minSize, Four maxSize, Boolean unused, char *label)
+{
+	Four		e;
+	Four		i;
+	UFour		seed = 4711;	/* the same sequence as benchLoad() */
+	ObjectID	catalogEntry;
+	ObjectID	*oids;
+	Four		*lengths;
+	char		pattern[LRGOBJ_THRESHOLD + 256];
+	char		buf[LRGOBJ_THRESHOLD];
+	ObjectAppendCursor cursor;
+	double		start;
+
+	oids = (ObjectID *)malloc(sizeof(ObjectID) * nObjects);
+	lengths = (Four *)malloc(sizeof(Four) * nObjects);
+	if (oids == NULL || lengths == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+
+	for (i = 0; i < sizeof(pattern); i++) pattern[i] = (char)(i * 7);
+	for (i = 0; i < nObjects; i++)
+		lengths[i] = minSize + benchRandom(&seed, maxSize - minSize + 1);
+
+	e = benchCreateFile(volId, &catalogEntry);
+	if (e < eNOERROR) ERR(e);
+
+	start = benchNow();
+	e = EduOM_OpenAppend(&catalogEntry, &cursor);
+	if (e < eNOERROR) ERR(e);
+	for (i = 0; i < nObjects; i++) {
+		e = EduOM_AppendObject(&cursor, NULL, lengths[i], &pattern[i % 256], &oids[i]);
+		if (e < eNOERROR) ERR(e);
+	}
+	e = EduOM_CloseAppend(&cursor);
+	if (e < eNOERROR) ERR(e);
+	e = benchReport(&catalogEntry, label, "load", nObjects, benchNow() - start);
+	if (e < eNOERROR) ERR(e);
+
+	for (i = 0; i < nObjects; i++) {
+		e = EduOM_ReadObject(&oids[i], 0, lengths[i], buf);
+		if (e < eNOERROR) ERR(e);
+		if (e != lengths[i] || memcmp(buf, &pattern[i % 256], lengths[i]) != 0) {
+			printf("object %ld read back wrong\n", i);
+			ERR(eBADOBJECTID_OM);
+		}
+	}
+
+	free(oids);
+	free(lengths);
+
+	return(eNOERROR);
+}
+
+
+/* load objects of random sizes in bulk and read them in random order, one by one or in batches ('batched') */
+static Four benchRead(Four volId, Four nObjects, Four minSize, Four maxSize, Boolean batched, char *label)
+{
+	Four		e;
+	Four		i, j, n;
+	UFour		seed = 4711;	/* the same sequence for every run */
+	ObjectID	catalogEntry;
+	ObjectID	*oids;
+	ObjectID	tmp;
+	Four		*lengths;
+	Four		*nRead;
+	char		**data;
+	char		**bufs;
+	char		pattern[LRGOBJ_THRESHOLD + 256];
+	double		start;
+
+	oids = (ObjectID *)malloc(sizeof(ObjectID) * nObjects);
+	lengths = (Four *)malloc(sizeof(Four) * nObjects);
+	nRead = (Four *)malloc(sizeof(Four) * nObjects);
+	data = (char **)malloc(sizeof(char *) * nObjects);
+	bufs = (char **)malloc(sizeof(char *) * nObjects);
+	if (oids == NULL || lengths == NULL || nRead == NULL || data == NULL || bufs == NULL)
+		ERR(eMEMORYALLOCERR_EDUOM);
+
+	for (i = 0; i < sizeof(pattern); i++) pattern[i] = (char)(i * 7);
+	for (i = 0; i < nObjects; i++) {
+		lengths[i] = minSize + benchRandom(&seed, maxSize - minSize + 1);
+		data[i] = &pattern[i % 256];
+	}
+
+	e = benchCreateFile(volId, &catalogEntry);
+	if (e < eNOERROR) ERR(e);
+
+	e = EduOM_CreateObjects(&catalogEntry, nObjects, NULL, lengths, data, oids);
+	if (e < eNOERROR) ERR(e);
+
+	/* shuffle the objects along with their lengths and data */
+	for (i = nObjects - 1; i > 0; i--) {
+		j = benchRandom(&seed, i + 1);
+		tmp = oids[i]; oids[i] = oids[j]; oids[j] = tmp;
+		n = lengths[i]; lengths[i] = lengths[j]; lengths[j] = n;
+		bufs[0] = data[i]; data[i] = data[j]; data[j] = bufs[0];
+	}
+
+	for (i = 0; i < nObjects; i++) {
+		bufs[i] = (char *)malloc(lengths[i]);
+		if (bufs[i] == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+		nRead[i] = REMAINDER;
+	}
+
+	start = benchNow();
+	for (i = 0; i < nObjects; i += n) {
+		if (batched) {
+			n = MAX(1, BENCH_LOAD_BATCH);
+			if (n > nObjects - i) n = nObjects - i;
+			e = EduOM_ReadObjects(&oids[i], n, &bufs[i], &nRead[i]);
+		}
+		else {
+			n = 1;
+			e = nRead[i] = EduOM_ReadObject(&oids[i], 0, lengths[i], bufs[i]);
+		}
+		if (e < eNOERROR) ERR(e);
+	}
+	e = benchReport(&catalogEntry, label, "read", nObjects, benchNow() - start);
+	if (e < eNOERROR) ERR(e);
+
+	for (i = 0; i < nObjects; i++) {
+		if (nRead[i] != lengths[i] || memcmp(bufs[i], data[i], lengths[i]) != 0) {
+			printf("object %ld read wrong\n", i);
+			ERR(eBADOBJECTID_OM);
+		}
+		free(bufs[i]);
+	}
+
+	free(oids);
+	free(lengths);
+	free(nRead);
+	free(data);
+	free(bufs);
+
+	return(eNOERROR);
+}
+
+
+/* load objects of random sizes in bulk and select some of them, reading them one by one or by a filter ('pushdown') */
+static Four benchFilter(Four volId, Four nObjects, Four minSize, Four maxSize, Boolean pushdown, char *label)
+{
+	Four		e;
+	Four		i, n;
+	UFour		seed = 4711;	/* the same sequence for every run */
+	ObjectID	catalogEntry;
+	ObjectID	*oids;
+	Four		*lengths;
+	char		**data;
+	Four		key;
+	Four		nSelected, expected;
+	ObjectID	scanned[PAGESIZE / sizeof(ObjectHdr)];
+	Object		*objs[PAGESIZE / sizeof(ObjectHdr)];
+	char		buf[LRGOBJ_THRESHOLD];
+	ObjectScanCursor scan;
+	ObjectFilter filter;
+	double		start;
+
+	if (minSize < sizeof(Four)) minSize = sizeof(Four);
+	if (maxSize < minSize) maxSize = minSize;
+
+	oids = (ObjectID *)malloc(sizeof(ObjectID) * nObjects);
+	lengths = (Four *)malloc(sizeof(Four) * nObjects);
+	data = (char **)malloc(sizeof(char *) * nObjects);
+	if (oids == NULL || lengths == NULL || data == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+
+	for (i = expected = 0; i < nObjects; i++) {
+		lengths[i] = minSize + benchRandom(&seed, maxSize - minSize + 1);
+		data[i] = (char *)calloc(lengths[i], 1);
+		if (data[i] == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+		key = benchRandom(&seed, BENCH_FILTER_RANGE);
+		memcpy(data[i], &key, sizeof(Four));
+		if (key < BENCH_FILTER_SELECT) expected++;
+	}
+
+	e = benchCreateFile(volId, &catalogEntry);
+	if (e < eNOERROR) ERR(e);
+
+	e = EduOM_CreateObjects(&catalogEntry, nObjects, NULL, lengths, data, oids);
+	if (e < eNOERROR) ERR(e);
+
+	filter.nTerms = 1;
+	filter.terms[0].offset = 0;
+	filter.terms[0].type = SM_INT;
+	filter.terms[0].op = SM_LT;
+	filter.terms[0].constant = BENCH_FILTER_SELECT;
+	filter.fn = NULL;
+	filter.arg = NULL;
+
+	start = benchNow();
+	e = EduOM_OpenScan(&catalogEntry, &scan);
+	if (e < eNOERROR) ERR(e);
+
+	nSelected = 0;
+	for (;;) {
+		if (pushdown)
+			n = EduOM_NextMatchingObjects(&scan, &filter, PAGESIZE / sizeof(ObjectHdr), scanned, objs);
+		else
+			n = EduOM_NextObjects(&scan, PAGESIZE / sizeof(ObjectHdr), scanned, NULL);
+		if (n < eNOERROR) { EduOM_CloseScan(&scan); ERR(n); }
+		if (n == 0) break;
+
+		for (i = 0; i < n; i++) {
+			if (pushdown) {
+				nSelected++;
+				continue;
+			}
+			e = EduOM_ReadObject(&scanned[i], 0, REMAINDER, buf);
+			if (e < eNOERROR) { EduOM_CloseScan(&scan); ERR(e); }
+			memcpy(&key, buf, sizeof(Four));
+			if (key < BENCH_FILTER_SELECT) nSelected++;
+		}
+	}
+
+	e = EduOM_CloseScan(&scan);
+	if (e < eNOERROR) ERR(e);
+	e = benchReport(&catalogEntry, label, "select", nObjects, benchNow() - start);
+	if (e < eNOERROR) ERR(e);
+
+	if (nSelected != expected) {
+		printf("%ld objects selected, expected %ld\n", nSelected, expected);
+		ERR(eBADOBJECTID_OM);
+	}
+
+	for (i = 0; i < nObjects; i++) free(data[i]);
+	free(oids);
+	free(lengths);
+	free(data);
+
+	return(eNOERROR);
+}
+
+
+/* load objects of random sizes in bulk and sum up their first bytes in random order, copying the objects or through views ('pinned') */
+static Four benchPin(Four volId, Four nObjects, Four minSize, Four maxSize, Boolean pinned, char *label)
+{
+	Four		e;
+	Four		i, j;
+	UFour		seed = 4711;	/* the same sequence for every run */
+	ObjectID	catalogEntry;
+	ObjectID	*oids;
+	ObjectID	tmp;
+	Four		*lengths;
+	char		**data;
+	char		pattern[LRGOBJ_THRESHOLD + 256];
+	char		buf[LRGOBJ_THRESHOLD];
+	ObjectView	view;
+	UFour		sum, expected;
+	double		start;
+
+	oids = (ObjectID *)malloc(sizeof(ObjectID) * nObjects);
+	lengths = (Four *)malloc(sizeof(Four) * nObjects);
+	data = (char **)malloc(sizeof(char *) * nObjects);
+	if (oids == NULL || lengths == NULL || data == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+
+	for (i = 0; i < sizeof(pattern); i++) pattern[i] = (char)(i * 7);
+	for (i = expected = 0; i < nObjects; i++) {
+		lengths[i] = minSize + benchRandom(&seed, maxSize - minSize + 1);
+		data[i] = &pattern[i % 256];
+		expected += (unsigned char)data[i][0];
+	}
+
+	e = benchCreateFile(volId, &catalogEntry);
+	if (e < eNOERROR) ERR(e);
+
+	e = EduOM_CreateObjects(&catalogEntry, nObjects, NULL, lengths, data, oids);
+	if (e < eNOERROR) ERR(e);
+
+	for (i = nObjects - 1; i > 0; i--) {
+		j = benchRandom(&seed, i + 1);
+		tmp = oids[i]; oids[i] = oids[j]; oids[j] = tmp;
+	}
+
+	start = benchNow();
+	for (i = sum = 0; i < nObjects; i++) {
+		if (pinned) {
+			e = EduOM_PinObject(&oids[i], &view);
+			if (e < eNOERROR) ERR(e);
+			sum += (unsigned char)view.data[0];
+			e = EduOM_UnpinObject(&view);
+		}
+		else {
+			e = EduOM_ReadObject(&oids[i], 0, REMAINDER, buf);
+			sum += (unsigned char)buf[0];
+		}
+		if (e < eNOERROR) ERR(e);
+	}
+	e = benchReport(&catalogEntry, label, "read", nObjects, benchNow() - start);
+	if (e < eNOERROR) ERR(e);
+
+	if (sum != expected) {
+		printf("sum %lu, expected %lu\n", (unsigned long)sum, (unsigned long)expected);
+		ERR(eBADOBJECTID_OM);
+	}
+
+	free(oids);
+	free(lengths);
+	free(data);
+
+	return(eNOERROR);
+}
+
+
+/* load objects of random sizes in bulk and scan the file, object by object or page by page ('cursor') */
+static Four benchScan(Four volId, Four nObjects, Four minSize, Four maxSize, Boolean cursor, char *label)
+{
+	Four		e;
+	Four		i, n;
+	UFour		seed = 4711;	/* the same sequence for every run */
+	ObjectID	catalogEntry;
+	ObjectID	*oids;
+	Four		*lengths;
+	char		**data;
+	char		pattern[LRGOBJ_THRESHOLD + 256];
+	ObjectID	oid;
+	ObjectID	scanned[PAGESIZE / sizeof(ObjectHdr)];
+	Object		*objs[PAGESIZE / sizeof(ObjectHdr)];
+	ObjectHdr	objHdr;
+	ObjectScanCursor scan;
+	Four		nScanned;
+	Four		nBytes, nBytesScanned;
+	double		start;
+
+	oids = (ObjectID *)malloc(sizeof(ObjectID) * nObjects);
+	lengths = (Four *)malloc(sizeof(Four) * nObjects);
+	data = (char **)malloc(sizeof(char *) * nObjects);
+	if (oids == NULL || lengths == NULL || data == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+
+	for (i = 0; i < sizeof(pattern); i++) pattern[i] = (char)(i * 7);
+	for (i = nBytes = 0; i < nObjects; i++) {
+		lengths[i] = minSize + benchRandom(&seed, maxSize - minSize + 1);
+		data[i] = &pattern[i % 256];
+		nBytes += lengths[i];
+	}
+
+	e = benchCreateFile(volId, &catalogEntry);
+	if (e < eNOERROR) ERR(e);
+
+	e = EduOM_CreateObjects(&catalogEntry, nObjects, NULL, lengths, data, oids);
+	if (e < eNOERROR) ERR(e);
+
+	nScanned = nBytesScanned = 0;
+	start = benchNow();
+	if (cursor) {
+		e = EduOM_OpenScan(&catalogEntry, &scan);
+		if (e < eNOERROR) ERR(e);
+
+		while ((n = EduOM_NextObjects(&scan, sizeof(objs) / sizeof(objs[0]), scanned, objs)) > 0)
+			for (i = 0; i < n; i++, nScanned++) nBytesScanned += objs[i]->header.length;
+		if (n < eNOERROR) ERR(n);
+
+		e = EduOM_CloseScan(&scan);
+		if (e < eNOERROR) ERR(e);
+	}
+	else {
+		for (e = EduOM_NextObject(&catalogEntry, NULL, &oid, &objHdr); e != EOS;
+			 e = EduOM_NextObject(&catalogEntry, &oid, &oid, &objHdr)) {
+			if (e < eNOERROR) ERR(e);
+			nScanned++;
+			nBytesScanned += objHdr.length;
+		}
+	}
+	e = benchReport(&catalogEntry, label, "scan", nObjects, benchNow() - start);
+	if (e < eNOERROR) ERR(e);
+
+	if (nScanned != nObjects || nBytesScanned != nBytes) {
+		printf("scanned %ld objects of %ld bytes instead of %ld of %ld\n", nScanned, nBytesScanned, nObjects, nBytes);
+		ERR(eBADOBJECTID_OM);
+	}
+
+	free(oids);
+	free(lengths);
+	free(data);
+
+	return(eNOERROR);
+}
+
+
+/* process objects as a scan would: sum up the bytes of their data */
+static void benchProcess(Four nObjects, Object **objs, BenchScanTotal *total)
+{
+	Four		i, j;
+
+	for (i = 0; i < nObjects; i++) {
+		for (j = 0; j < objs[i]->header.length; j++) total->checksum += (UOne)objs[i]->data[j];
+		total->nObjects++;
+	}
+}
+
+
+/* ParallelScanFn of benchParallelScan() */
+static Four benchParallelProcess(Four thread, Four nObjects, ObjectID *oids, Object **objs, void *arg)
+{
+	benchProcess(nObjects, objs, &((BenchScanTotal *)arg)[thread]);
+
+	return(eNOERROR);
+}
+
+
+/* load objects of random sizes in bulk and process all of them with a scan cursor and with parallel scans */
+static Four benchParallelScan(Four volId, Four nObjects, Four minSize, Four maxSize, Boolean unused, char *label)
+{
+	Four		e;
+	Four		i, n;
+	Four		nThreads;
+	UFour		seed = 4711;	/* the same sequence for every run */
+	ObjectID	catalogEntry;
+	ObjectID	*oids;
+	Four		*lengths;
+	char		**data;
+	char		pattern[LRGOBJ_THRESHOLD + 256];
+	char		threadLabel[32];
+	ObjectID	scanned[PAGESIZE / sizeof(ObjectHdr)];
+	Object		*objs[PAGESIZE / sizeof(ObjectHdr)];
+	ObjectScanCursor scan;
+	BenchScanTotal totals[BENCH_MAX_THREADS];
+	BenchScanTotal expected;
+	double		start;
+
+	oids = (ObjectID *)malloc(sizeof(ObjectID) * nObjects);
+	lengths = (Four *)malloc(sizeof(Four) * nObjects);
+	data = (char **)malloc(sizeof(char *) * nObjects);
+	if (oids == NULL || lengths == NULL || data == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+
+	for (i = 0; i < sizeof(pattern); i++) pattern[i] = (char)(i * 7);
+	for (i = 0; i < nObjects; i++) {
+		lengths[i] = minSize + benchRandom(&seed, maxSize - minSize + 1);
+		data[i] = &pattern[i % 256];
+	}
+
+	e = benchCreateFile(volId, &catalogEntry);
+	if (e < eNOERROR) ERR(e);
+
+	e = EduOM_CreateObjects(&catalogEntry, nObjects, NULL, lengths, data, oids);
+	if (e < eNOERROR) ERR(e);
+
+	/* one thread with a scan cursor */
+	memset(&expected, 0, sizeof(expected));
+	start = benchNow();
+	e = EduOM_OpenScan(&catalogEntry, &scan);
+	if (e < eNOERROR) ERR(e);
+	while ((n = EduOM_NextObjects(&scan, sizeof(objs) / sizeof(objs[0]), scanned, objs)) > 0)
+		benchProcess(n, objs, &expected);
+	if (n < eNOERROR) ERR(n);
+	e = EduOM_CloseScan(&scan);
+	if (e < eNOERROR) ERR(e);
+	e = benchReport(&catalogEntry, "scan cursor", "process", nObjects, benchNow() - start);
+	if (e < eNOERROR) ERR(e);
+
+	for (nThreads = 1; nThreads <= BENCH_MAX_THREADS; nThreads *= 2) {
+		memset(totals, 0, sizeof(totals));
+		start = benchNow();
+		e = EduOM_ParallelScan(&catalogEntry, nThreads, 0, benchParallelProcess, totals);
+		if (e < eNOERROR) ERR(e);
+		sprintf(threadLabel, "%s, %ld thread%s", label, nThreads, (nThreads > 1) ? "s" : "");
+		e = benchReport(&catalogEntry, threadLabel, "process", nObjects, benchNow() - start);
+		if (e < eNOERROR) ERR(e);
+
+		for (i = 1; i < nThreads; i++) {
+			totals[0].nObjects += totals[i].nObjects;
+			totals[0].checksum += totals[i].checksum;
+		}
+		if (totals[0].nObjects != expected.nObjects || totals[0].checksum != expected.checksum) {
+			printf("parallel scan saw %ld objects instead of %ld\n", totals[0].nObjects, expected.nObjects);
+			ERR(eBADOBJECTID_OM);
+		}
+	}
+
+	free(oids);
+	free(lengths);
+	free(data);
+
+	return(eNOERROR);
+}
+
+
+/* fill a page with objects of random sizes in a random order of slots and destroy some of them */
+static void benchCompactFill(SlottedPage *apage, UFour *seed, Four maxSize)
+{
+	Four		i, j, n;
+	Two		offset;
+	Object		*obj;
+
+	apage->header.nSlots = 0;
+	apage->header.free = 0;
+	apage->header.unused = 0;
+	apage->header.flags = SLOTTED_PAGE_TYPE;
+
+	/* lay down as many objects as fit with their slots */
+	for (offset = 0, n = 0; ; n++) {
+		obj = (Object *)&apage->data[offset];
+		obj->header.properties = 0;
+		obj->header.tag = (Two)n;
+		obj->header.length = 1 + benchRandom(seed, maxSize);
+		if (offset + OBJECT_SIZE_IN_PAGE(obj) + n * sizeof(SlottedPageSlot) > PAGESIZE - SP_FIXED)
+			break;
+		for (i = 0; i < obj->header.length; i++) obj->data[i] = (char)benchRandom(seed, 256);
+		offset += OBJECT_SIZE_IN_PAGE(obj);
+	}
+
+	/* the objects are given to the slots in a random order */
+	for (i = 0, offset = 0; i < n; i++) {
+		obj = (Object *)&apage->data[offset];
+		apage->slot[-i].offset = offset;
+		apage->slot[-i].unique = i;
+		offset += OBJECT_SIZE_IN_PAGE(obj);
+	}
+	apage->header.nSlots = n;
+	apage->header.free = offset;
+	for (i = n - 1; i > 0; i--) {
+		j = benchRandom(seed, i + 1);
+		offset = apage->slot[-i].offset; apage->slot[-i].offset = apage->slot[-j].offset; apage->slot[-j].offset = offset;
+	}
+
+	/* destroy some objects to leave holes */
+	for (i = 0; i < n; i++) {
+		if (benchRandom(seed, 3) != 0) continue;
+		obj = (Object *)&apage->data[apage->slot[-i].offset];
+		apage->header.unused += OBJECT_SIZE_IN_PAGE(obj);
+		apage->slot[-i].offset = EMPTYSLOT;
+	}
+}
+
+
+/* check a page compacted by EduOM_CompactPage() against its copy before the compaction */
+static Four benchCompactCheck(SlottedPage *apage, SlottedPage *before, Two slotNo)
+{
+	Four		i, j;
+	Four		size, total;
+	Object		*obj, *old;
+
+	if (apage->header.nSlots != before->header.nSlots || apage->header.unused != 0) return(FALSE);
+
+	for (i = total = 0; i < apage->header.nSlots; i++) {
+		if (before->slot[-i].offset == EMPTYSLOT) {
+			if (apage->slot[-i].offset != EMPTYSLOT) return(FALSE);
+			continue;
+		}
+		obj = (Object *)&apage->data[apage->slot[-i].offset];
+		old = (Object *)&before->data[before->slot[-i].offset];
+		size = OBJECT_SIZE_IN_PAGE(old);
+		total += size;
+
+		/* the object is intact and within the compacted area */
+		if (apage->slot[-i].offset < 0 || apage->slot[-i].offset + size > apage->header.free) return(FALSE);
+		if (memcmp(obj, old, sizeof(ObjectHdr) + old->header.length) != 0) return(FALSE);
+
+		/* the object of 'slotNo' is the last one; the others keep their order */
+		if (i == slotNo && apage->slot[-i].offset + size != apage->header.free) return(FALSE);
+		for (j = 0; j < i && i != slotNo; j++) {
+			if (j == slotNo || before->slot[-j].offset == EMPTYSLOT) continue;
+			if ((before->slot[-j].offset < before->slot[-i].offset) !=
+				(apage->slot[-j].offset < apage->slot[-i].offset))
+				return(FALSE);
+		}
+	}
+
+	/* no hole is left: the objects fill the area up to 'free' */
+	return(total == apage->header.free);
+}
+
+
+/* compact pages with holes, keeping the order of the objects or moving a random one to the end ('toEnd') */
+static Four benchCompact(Four volId, Four nObjects, Four minSize, Four maxSize, Boolean toEnd, char *label)
+{
+	Four		e;
+	Four		i, k;
+	UFour		seed = 4711;	/* the same sequence for every run */
+	Two		slotNo;
+	SlottedPage	*apage, *before;
+	double		elapsed;
+	double		start;
+
+	apage = (SlottedPage *)malloc(sizeof(SlottedPage));
+	before = (SlottedPage *)malloc(sizeof(SlottedPage));
+	if (apage == NULL || before == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+
+	/* small objects make pages of many objects and holes */
+	if (maxSize > BENCH_SLOT_SMALL * 4) maxSize = BENCH_SLOT_SMALL * 4;
+
+	for (k = 0, elapsed = 0.0; k < BENCH_COMPACT_PAGES; k++) {
+		benchCompactFill(apage, &seed, maxSize);
+		memcpy(before, apage, sizeof(SlottedPage));
+
+		slotNo = NIL;
+		if (toEnd) {
+			for (i = 0; i < 8 && slotNo == NIL; i++) {
+				slotNo = benchRandom(&seed, apage->header.nSlots);
+				if (apage->slot[-slotNo].offset == EMPTYSLOT) slotNo = NIL;
+			}
+		}
+
+		start = benchNow();
+		e = EduOM_CompactPage(apage, slotNo);
+		elapsed += benchNow() - start;
+		if (e < eNOERROR) ERR(e);
+
+		if (!benchCompactCheck(apage, before, slotNo)) {
+			printf("page %ld compacted wrong (slotNo %d)\n", k, slotNo);
+			ERR(eBADOBJECTID_OM);
+		}
+	}
+	printf("%-22s %-10s %12.0f\n", label, "compact", BENCH_COMPACT_PAGES / elapsed);
+
+	free(apage);
+	free(before);
+
+	return(eNOERROR);
+}
+
+
+/* print the throughput of a large object phase in MB/sec */
+static void benchReportBytes(char *label, char *phase, double nBytes, double elapsed)
+{
+	printf("%-22s %-10s %12.1f\n", label, phase, nBytes / elapsed / (1024 * 1024));
+}
+
+
+/* check the large object against the copy in memory */
+static Four benchCheckLarge(ObjectID *oid, char *expected, Four length, char *buf)
+{
+	Four		e;
+	Four		i, n;
+
+	for (i = 0; i < length; i += BENCH_LRGOBJ_CHUNK) {
+		n = (length - i < BENCH_LRGOBJ_CHUNK) ? length - i : BENCH_LRGOBJ_CHUNK;
+		e = EduOM_ReadObject(oid, i, BENCH_LRGOBJ_CHUNK, buf);
+		if (e < eNOERROR) ERR(e);
+		if (e != n || memcmp(buf, &expected[i], n) != 0) {
+			printf("large object read back wrong at %ld\n", i);
+			ERR(eBADOBJECTID_OM);
+		}
+	}
+
+	/* nothing is there past the end */
+	e = EduOM_ReadObject(oid, length, BENCH_LRGOBJ_CHUNK, buf);
+	if (e < eNOERROR) ERR(e);
+	if (e != 0) {
+		printf("large object is longer than %ld\n", length);
+		ERR(eBADOBJECTID_OM);
+	}
+
+	return(eNOERROR);
+}
+
+
+/* create a large object at once or by appending chunks ('streamed'), then read, overwrite, and truncate it */
+static Four benchLargeObject(Four volId, Four nObjects, Four minSize, Four maxSize, Boolean streamed, char *label)
+{
+	Four		e;
+	Four		i, n;
+	Four		offset;
+	UFour		seed = 4711;	/* the same sequence for every run */
+	ObjectID	catalogEntry;
+	ObjectID	oid;
+	char		*expected;
+	char		*buf;
+	double		start;
+
+	expected = (char *)malloc(BENCH_LRGOBJ_SIZE);
+	buf = (char *)malloc(BENCH_LRGOBJ_CHUNK);
+	if (expected == NULL || buf == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+
+	for (i = 0; i < BENCH_LRGOBJ_SIZE; i++) expected[i] = (char)(i * 7 + i / PAGESIZE);
+
+	e = benchCreateFile(volId, &catalogEntry);
+	if (e < eNOERROR) ERR(e);
+
+	start = benchNow();
+	if (streamed) {
+		e = EduOM_CreateObject(&catalogEntry, NULL, NULL, 0, NULL, &oid);
+		for (i = 0; e >= eNOERROR && i < BENCH_LRGOBJ_SIZE; i += BENCH_LRGOBJ_CHUNK)
+			e = EduOM_AppendToObject(&catalogEntry, &oid, BENCH_LRGOBJ_CHUNK, &expected[i], &dlPool, &dlHead);
+	}
+	else
+		e = EduOM_CreateObject(&catalogEntry, NULL, NULL, BENCH_LRGOBJ_SIZE, expected, &oid);
+	if (e < eNOERROR) ERR(e);
+	benchReportBytes(label, "create", BENCH_LRGOBJ_SIZE, benchNow() - start);
+
+	start = benchNow();
+	e = benchCheckLarge(&oid, expected, BENCH_LRGOBJ_SIZE, buf);
+	if (e < eNOERROR) ERR(e);
+	benchReportBytes(label, "read", BENCH_LRGOBJ_SIZE, benchNow() - start);
+
+	/* chunks at random offsets, not aligned to the leaves */
+	n = BENCH_LRGOBJ_SIZE / BENCH_LRGOBJ_CHUNK;
+	start = benchNow();
+	for (i = 0; i < n; i++) {
+		offset = benchRandom(&seed, BENCH_LRGOBJ_SIZE - BENCH_LRGOBJ_CHUNK);
+		e = EduOM_ReadObject(&oid, offset, BENCH_LRGOBJ_CHUNK, buf);
+		if (e < eNOERROR) ERR(e);
+		if (memcmp(buf, &expected[offset], BENCH_LRGOBJ_CHUNK) != 0) {
+			printf("large object read back wrong at %ld\n", offset);
+			ERR(eBADOBJECTID_OM);
+		}
+	}
+	benchReportBytes(label, "rand read", (double)n * BENCH_LRGOBJ_CHUNK, benchNow() - start);
+
+	start = benchNow();
+	for (i = 0; i < n; i++) {
+		offset = benchRandom(&seed, BENCH_LRGOBJ_SIZE - BENCH_LRGOBJ_CHUNK);
+		memset(&expected[offset], (char)i, BENCH_LRGOBJ_CHUNK);
+		e = EduOM_WriteObject(&oid, offset, BENCH_LRGOBJ_CHUNK, &expected[offset]);
+		if (e < eNOERROR) ERR(e);
+	}
+	benchReportBytes(label, "rand write", (double)n * BENCH_LRGOBJ_CHUNK, benchNow() - start);
+
+	e = benchCheckLarge(&oid, expected, BENCH_LRGOBJ_SIZE, buf);
+	if (e < eNOERROR) ERR(e);
+
+	start = benchNow();
+	e = EduOM_TruncateObject(&catalogEntry, &oid, BENCH_LRGOBJ_SIZE / 2 + 1, &dlPool, &dlHead);
+	if (e < eNOERROR) ERR(e);
+	benchReportBytes(label, "truncate", BENCH_LRGOBJ_SIZE / 2, benchNow() - start);
+
+	e = benchCheckLarge(&oid, expected, BENCH_LRGOBJ_SIZE / 2 + 1, buf);
+	if (e < eNOERROR) ERR(e);
+
+	e = EduOM_DestroyObject(&catalogEntry, &oid, &dlPool, &dlHead);
+	if (e < eNOERROR) ERR(e);
+
+	free(expected);
+	free(buf);
+
+	return(eNOERROR);
+}
+
+
+/* # of objects of the file moved out of their pages */
+static Four benchCountMoved(ObjectID *catalogEntry)
+{
+	Four		e;
+	Four		i, n;
+	Four		nMoved = 0;
+	ObjectScanCursor cursor;
+	ObjectID	oids[PAGESIZE / sizeof(SlottedPageSlot)];
+	Object		*objs[PAGESIZE / sizeof(SlottedPageSlot)];
+
+	e = EduOM_OpenScan(catalogEntry, &cursor);
+	if (e < eNOERROR) ERR(e);
+
+	while ((n = EduOM_NextObjects(&cursor, PAGESIZE / sizeof(SlottedPageSlot), oids, objs)) > 0)
+		for (i = 0; i < n; i++)
+			if (objs[i]->header.properties & P_MOVED) nMoved++;
+	if (n < eNOERROR) ERR(n);
+
+	e = EduOM_CloseScan(&cursor);
+	if (e < eNOERROR) ERR(e);
+
+	return(nMoved);
+}
+
+
+/* grow and shrink every object of a file loaded in bulk, in place or by destroying and creating it ('inPlace') */
+static Four benchUpdate(Four volId, Four nObjects, Four minSize, Four maxSize, Boolean inPlace, char *label)
+{
+	Four		e;
+	Four		i, phase;
+	UFour		seed = 4711;	/* the same sequence for every run */
+	ObjectID	catalogEntry;
+	ObjectID	*oids;
+	Four		*lengths;
+	char		**data;
+	char		pattern[LRGOBJ_THRESHOLD + 256];
+	char		buf[LRGOBJ_THRESHOLD];
+	Four		nMoved = 0;
+	Four		nCollapsed;
+	double		start;
+
+	oids = (ObjectID *)malloc(sizeof(ObjectID) * nObjects);
+	lengths = (Four *)malloc(sizeof(Four) * nObjects);
+	data = (char **)malloc(sizeof(char *) * nObjects);
+	if (oids == NULL || lengths == NULL || data == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+
+	for (i = 0; i < sizeof(pattern); i++) pattern[i] = (char)(i * 7);
+	for (i = 0; i < nObjects; i++) {
+		lengths[i] = minSize + benchRandom(&seed, maxSize - minSize + 1);
+		data[i] = &pattern[i % 256];
+	}
+
+	e = benchCreateFile(volId, &catalogEntry);
+	if (e < eNOERROR) ERR(e);
+
+	e = EduOM_CreateObjects(&catalogEntry, nObjects, NULL, lengths, data, oids);
+	if (e < eNOERROR) ERR(e);
+
+	/* the new data of an object starts at another offset of the pattern so that stale data is noticed */
+	for (phase = 0; phase < 2; phase++) {
+		start = benchNow();
+		for (i = 0; i < nObjects; i++) {
+			if (phase == 0) {
+				lengths[i] += 1 + benchRandom(&seed, maxSize);
+				if (lengths[i] > LRGOBJ_THRESHOLD) lengths[i] = LRGOBJ_THRESHOLD;
+			}
+			else
+				lengths[i] = minSize + benchRandom(&seed, lengths[i] - minSize + 1);
+			data[i] = &pattern[(i + phase + 1) % 256];
+
+			if (inPlace)
+				e = EduOM_UpdateObject(&catalogEntry, &oids[i], lengths[i], data[i], &dlPool, &dlHead);
+			else {
+				/* the object gets another ObjectID, which the indexes on the file would have to follow */
+				e = EduOM_DestroyObject(&catalogEntry, &oids[i], &dlPool, &dlHead);
+				if (e >= eNOERROR)
+					e = EduOM_CreateObject(&catalogEntry, NULL, NULL, lengths[i], data[i], &oids[i]);
+			}
+			if (e < eNOERROR) ERR(e);
+		}
+		e = benchReport(&catalogEntry, label, phase == 0 ? "grow" : "shrink", nObjects, benchNow() - start);
+		if (e < eNOERROR) ERR(e);
+
+		if (phase == 0) {
+			nMoved = benchCountMoved(&catalogEntry);
+			if (nMoved < eNOERROR) ERR(nMoved);
+		}
+	}
+
+	if (inPlace) {
+		start = benchNow();
+		nCollapsed = EduOM_CollapseForwards(&catalogEntry, &dlPool, &dlHead);
+		if (nCollapsed < eNOERROR) ERR(nCollapsed);
+		e = benchReport(&catalogEntry, label, "collapse", nCollapsed, benchNow() - start);
+		if (e < eNOERROR) ERR(e);
+
+		printf("%-22s %ld of %ld objects moved by growing, %ld moved back after shrinking\n",
+			   "", nMoved, nObjects, nCollapsed);
+	}
+
+	for (i = 0; i < nObjects; i++) {
+		e = EduOM_ReadObject(&oids[i], 0, lengths[i], buf);
+		if (e < eNOERROR) ERR(e);
+		if (e != lengths[i] || memcmp(buf, data[i], lengths[i]) != 0) {
+			printf("object %ld read back wrong\n", i);
+			ERR(eBADOBJECTID_OM);
+		}
+	}
+
+	free(oids);
+	free(lengths);
+	free(data);
+
+	return(eNOERROR);
+}
+
+
+/* the schema of the records of benchPax(): a key, the value summed up, and a payload */
+static Four benchPaxWidths[] = { sizeof(Four), sizeof(Four), 8, 16, 32 };
+#define BENCH_PAX_NCOLUMNS		(sizeof(benchPaxWidths) / sizeof(benchPaxWidths[0]))
+#define BENCH_PAX_RECORD		64
+#define BENCH_PAX_VALUE			sizeof(Four)	/* offset of the value in the record */
+
+
+/* ProjectScanFn of benchPax(): sum up the values of the page */
+static Four benchPaxSum(Four nRecords, char **columns, void *arg)
+{
+	Four		i;
+	Four		*values = (Four *)columns[0];
+	Four		sum = 0;
+
+	for (i = 0; i < nRecords; i++) sum += values[i];
+	*(Four *)arg += sum;
+
+	return(eNOERROR);
+}
+
+
+/* sum up the values of the records with a scan cursor, or with a projection scan if the file is of the PAX layout */
+static Four benchPaxScan(ObjectID *catalogEntry, Boolean pax, Four *sum)
+{
+	Four		e;
+	Four		i, n;
+	Four		column = 1;
+	Four		value;
+	ObjectScanCursor scan;
+	ObjectID	scanned[PAGESIZE / sizeof(ObjectHdr)];
+	Object		*objs[PAGESIZE / sizeof(ObjectHdr)];
+
+	*sum = 0;
+	if (pax) return(EduOM_ProjectScan(catalogEntry, 1, &column, benchPaxSum, sum));
+
+	e = EduOM_OpenScan(catalogEntry, &scan);
+	if (e < eNOERROR) ERR(e);
+	while ((n = EduOM_NextObjects(&scan, sizeof(objs) / sizeof(objs[0]), scanned, objs)) > 0)
+		for (i = 0; i < n; i++) {
+			memcpy(&value, &objs[i]->data[BENCH_PAX_VALUE], sizeof(Four));
+			*sum += value;
+		}
+	if (n < eNOERROR) ERR(n);
+
+	return(EduOM_CloseScan(&scan));
+}
+
+
+/* load records of a fixed schema and sum up a column of them, in slotted pages or in the PAX layout ('pax') */
+static Four benchPax(Four volId, Four nObjects, Four minSize, Four maxSize, Boolean pax, char *label)
+{
+	Four		e;
+	Four		i, k;
+	ObjectID	catalogEntry;
+	ObjectID	*oids;
+	char		*records;
+	char		**data;
+	Four		*lengths;
+	Four		value;
+	Four		sum, expected;
+	char		buf[BENCH_PAX_RECORD];
+	double		start;
+
+	oids = (ObjectID *)malloc(sizeof(ObjectID) * nObjects);
+	records = (char *)malloc(BENCH_PAX_RECORD * nObjects);
+	data = (char **)malloc(sizeof(char *) * nObjects);
+	lengths = (Four *)malloc(sizeof(Four) * nObjects);
+	if (oids == NULL || records == NULL || data == NULL || lengths == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+
+	expected = 0;
+	for (i = 0; i < nObjects; i++) {
+		data[i] = &records[i * BENCH_PAX_RECORD];
+		lengths[i] = BENCH_PAX_RECORD;
+		for (k = 0; k < BENCH_PAX_RECORD; k++) data[i][k] = (char)(i + k);
+		value = i % 1000;
+		memcpy(&data[i][0], &i, sizeof(Four));
+		memcpy(&data[i][BENCH_PAX_VALUE], &value, sizeof(Four));
+		expected += value;
+	}
+
+	e = benchCreateFile(volId, &catalogEntry);
+	if (e < eNOERROR) ERR(e);
+
+	if (pax) {
+		e = EduOM_SetPaxLayout(&catalogEntry, BENCH_PAX_NCOLUMNS, benchPaxWidths);
+		if (e < eNOERROR) ERR(e);
+	}
+
+	start = benchNow();
+	e = EduOM_CreateObjects(&catalogEntry, nObjects, NULL, lengths, data, oids);
+	if (e < eNOERROR) ERR(e);
+	e = benchReport(&catalogEntry, label, "load", nObjects, benchNow() - start);
+	if (e < eNOERROR) ERR(e);
+
+	start = benchNow();
+	for (i = 0; i < BENCH_PAX_SCANS; i++) {
+		e = benchPaxScan(&catalogEntry, pax, &sum);
+		if (e < eNOERROR) ERR(e);
+	}
+	e = benchReport(&catalogEntry, label, "sum", nObjects * BENCH_PAX_SCANS, benchNow() - start);
+	if (e < eNOERROR) ERR(e);
+
+	if (sum != expected) {
+		printf("summed up %ld instead of %ld\n", sum, expected);
+		ERR(eBADOBJECTID_OM);
+	}
+
+	/* destroy every other record; the rest must read back as written */
+	for (i = 0; i < nObjects; i += 2) {
+		e = EduOM_DestroyObject(&catalogEntry, &oids[i], &dlPool, &dlHead);
+		if (e < eNOERROR) ERR(e);
+		memcpy(&value, &data[i][BENCH_PAX_VALUE], sizeof(Four));
+		expected -= value;
+	}
+
+	for (i = 1; i < nObjects; i += 2) {
+		e = EduOM_ReadObject(&oids[i], 0, BENCH_PAX_RECORD, buf);
+		if (e < eNOERROR) ERR(e);
+		if (e != BENCH_PAX_RECORD || memcmp(buf, data[i], BENCH_PAX_RECORD) != 0) {
+			printf("record %ld is corrupted\n", i);
+			ERR(eBADOBJECTID_OM);
+		}
+	}
+
+	e = benchPaxScan(&catalogEntry, pax, &sum);
+	if (e < eNOERROR) ERR(e);
+	if (sum != expected) {
+		printf("summed up %ld instead of %ld after destroying\n", sum, expected);
+		ERR(eBADOBJECTID_OM);
+	}
+
+	free(oids);
+	free(records);
+	free(data);
+	free(lengths);
+
+	return(eNOERROR);
+}
+
+
+/* load objects of one size in bulk and churn them: destroy a random object and create it again near its neighbor */
+static Four benchSlotReuse(Four volId, Four nObjects, Four minSize, Four maxSize, Boolean tiny, char *label)
+{
+	Four		e;
+	Four		i, k;
+	UFour		seed = 4711;	/* the same sequence for every run */
+	Four		size = tiny ? BENCH_SLOT_TINY : BENCH_SLOT_SMALL;
+	ObjectID	catalogEntry;
+	ObjectID	*oids;
+	Four		*lengths;
+	char		**data;
+	char		pattern[BENCH_SLOT_SMALL];
+	char		buf[BENCH_SLOT_SMALL];
+	ObjectHdr	objHdr;
+	double		start;
+
+	oids = (ObjectID *)malloc(sizeof(ObjectID) * nObjects);
+	lengths = (Four *)malloc(sizeof(Four) * nObjects);
+	data = (char **)malloc(sizeof(char *) * nObjects);
+	if (oids == NULL || lengths == NULL || data == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+
+	for (i = 0; i < sizeof(pattern); i++) pattern[i] = (char)(i * 7);
+	for (i = 0; i < nObjects; i++) {
+		lengths[i] = size;
+		data[i] = pattern;
+	}
+
+	e = benchCreateFile(volId, &catalogEntry);
+	if (e < eNOERROR) ERR(e);
+
+	e = EduOM_CreateObjects(&catalogEntry, nObjects, NULL, lengths, data, oids);
+	if (e < eNOERROR) ERR(e);
+
+	for (i = 0; i < nObjects; i += BENCH_SLOT_GAP) {
+		e = EduOM_DestroyObject(&catalogEntry, &oids[i], &dlPool, &dlHead);
+		if (e < eNOERROR) ERR(e);
+	}
+
+	objHdr.properties = 0x0;
+	objHdr.tag = 0;
+	objHdr.length = 0;
+
+	/* neither the object churned nor its neighbor is one of the objects destroyed */
+	start = benchNow();
+	for (i = 0; i < nObjects * BENCH_SLOT_ROUNDS; i++) {
+		do k = 2 + benchRandom(&seed, nObjects - 2); while (k % BENCH_SLOT_GAP < 2);
+
+		e = EduOM_DestroyObject(&catalogEntry, &oids[k], &dlPool, &dlHead);
+		if (e < eNOERROR) ERR(e);
+
+		e = EduOM_CreateObject(&catalogEntry, &oids[k-1], &objHdr, size, pattern, &oids[k]);
+		if (e < eNOERROR) ERR(e);
+	}
+	e = benchReport(&catalogEntry, label, "churn", nObjects * BENCH_SLOT_ROUNDS, benchNow() - start);
+	if (e < eNOERROR) ERR(e);
+
+	for (i = 0; i < nObjects; i++) {
+		if (i % BENCH_SLOT_GAP == 0) continue;
+		e = EduOM_ReadObject(&oids[i], 0, size, buf);
+		if (e < eNOERROR) ERR(e);
+		if (e != size || memcmp(buf, pattern, size) != 0) {
+			printf("object %ld is corrupted\n", i);
+			ERR(eBADOBJECTID_OM);
+		}
+	}
+
+	free(oids);
+	free(lengths);
+	free(data);
+
+	return(eNOERROR);
+}
+
+
+/* run a test on a freshly formatted volume so that no run inherits the buffers of another */
+static Four benchRun(Four (*test)(Four, Four, Four, Four, Boolean, char*),
+					 Four nObjects, Four minSize, Four maxSize, Boolean variant, char *label)
+{
+	Four	e;									/* for errors */
+	char 	*devNames[MAX_DEVICES_IN_VOLUME];	/* device name */
+	Four 	volId;								/* volume identifier */
+	Four 	numPagesInDevices[MAX_DEVICES_IN_VOLUME];/* # of pages in the each devices */
+	XactID 	xactId;								/* transaction identifier */
+	static Four nRuns = 0;						/* # of runs so far */
+
+	devNames[0] = "bench.vol";
+	/* the free-space maps outlive a volume; a new id keeps a reformatted volume from meeting them */
+	volId = 1000 + nRuns++;
+	numPagesInDevices[0] = 16000;
+
+	e = LRDS_FormatDataVolume(1, devNames, "bench", volId, 16, numPagesInDevices, 16);
+	if (e < eNOERROR) ERR(e);
+
+	e = LRDS_Mount(1, devNames, &volId);
+	if (e < eNOERROR) ERR(e);
+
+	e = LRDS_BeginTransaction(&xactId, X_RR_RR);
+	if (e < eNOERROR) { LRDS_Dismount(volId); ERR(e); }
+
+	e = test(volId, nObjects, minSize, maxSize, variant, label);
+	if (e < eNOERROR) {
+		LRDS_AbortTransaction(&xactId);
+		LRDS_Dismount(volId);
+		ERR(e);
+	}
+
+	e = LRDS_CommitTransaction(&xactId);
+	if (e < eNOERROR) { LRDS_Dismount(volId); ERR(e); }
+
+	e = LRDS_Dismount(volId);
+	if (e < eNOERROR) ERR(e);
+
+	return(eNOERROR);
+}
+
+
+static Four EduOM_Bench(Four nObjects, Four minSize, Four maxSize)
+{
+	Four		e;
+
+	if (minSize < 1 || maxSize < minSize || maxSize > LRGOBJ_THRESHOLD) ERR(eBADLENGTH_OM);
+
+	printf("%ld objects of %ld to %ld bytes\n\n", nObjects, minSize, maxSize);
+	printf("%-22s %-10s %12s %8s %11s\n", "method", "phase", "ops/sec", "pages", "utilization");
+
+	e = benchRun(benchFreeSpace, nObjects, minSize, maxSize, FALSE, "available space lists");
+	if (e < eNOERROR) ERR(e);
+
+	e = benchRun(benchFreeSpace, nObjects, minSize, maxSize, TRUE, "free-space map");
+	if (e < eNOERROR) ERR(e);
+
+	e = benchRun(benchLoad, nObjects, minSize, maxSize, FALSE, "one by one");
+	if (e < eNOERROR) ERR(e);
+
+	e = benchRun(benchLoad, nObjects, minSize, maxSize, TRUE, "bulk");
+	if (e < eNOERROR) ERR(e);
+
+	e = benchRun(benchAppend, nObjects, minSize, maxSize, FALSE, "append cursor");
+	if (e < eNOERROR) ERR(e);
+
+	e = benchRun(benchRead, nObjects, minSize, maxSize, FALSE, "one by one");
+	if (e < eNOERROR) ERR(e);
+
+	e = benchRun(benchRead, nObjects, minSize, maxSize, TRUE, "batched");
+	if (e < eNOERROR) ERR(e);
+
+	e = benchRun(benchPin, nObjects, minSize, maxSize, FALSE, "copy");
+	if (e < eNOERROR) ERR(e);
+
+	e = benchRun(benchPin, nObjects, minSize, maxSize, TRUE, "pinned view");
+	if (e < eNOERROR) ERR(e);
+
+	e = benchRun(benchScan, nObjects, minSize, maxSize, FALSE, "object by object");
+	if (e < eNOERROR) ERR(e);
+
+	e = benchRun(benchScan, nObjects, minSize, maxSize, TRUE, "scan cursor");
+	if (e < eNOERROR) ERR(e);
+
+	e = benchRun(benchFilter, nObjects, minSize, maxSize, FALSE, "read and compare");
+	if (e < eNOERROR) ERR(e);
+
+	e = benchRun(benchFilter, nObjects, minSize, maxSize, TRUE, "filter pushdown");
+	if (e < eNOERROR) ERR(e);
+
+	e = benchRun(benchParallelScan, nObjects, minSize, maxSize, FALSE, "parallel");
+	if (e < eNOERROR) ERR(e);
+
+	e = benchRun(benchUpdate, nObjects, minSize, maxSize, TRUE, "update in place");
+	if (e < eNOERROR) ERR(e);
+
+	e = benchRun(benchUpdate, nObjects, minSize, maxSize, FALSE, "destroy and create");
+	if (e < eNOERROR) ERR(e);
+
+	e = benchRun(benchPax, nObjects, minSize, maxSize, FALSE, "slotted pages");
+	if (e < eNOERROR) ERR(e);
+
+	e = benchRun(benchPax, nObjects, minSize, maxSize, TRUE, "PAX layout");
+	if (e < eNOERROR) ERR(e);
+
+	e = benchRun(benchSlotReuse, nObjects, minSize, maxSize, TRUE, "4-byte objects");
+	if (e < eNOERROR) ERR(e);
+
+	e = benchRun(benchSlotReuse, nObjects, minSize, maxSize, FALSE, "64-byte objects");
+	if (e < eNOERROR) ERR(e);
+
+	printf("\n%ld pages with holes compacted and checked\n\n", (Four)BENCH_COMPACT_PAGES);
+	printf("%-22s %-10s %12s\n", "method", "phase", "pages/sec");
+
+	e = benchRun(benchCompact, nObjects, minSize, maxSize, FALSE, "in order");
+	if (e < eNOERROR) ERR(e);
+
+	e = benchRun(benchCompact, nObjects, minSize, maxSize, TRUE, "one to the end");
+	if (e < eNOERROR) ERR(e);
+
+	printf("\nobject of %ld bytes in chunks of %ld bytes\n\n", (Four)BENCH_LRGOBJ_SIZE, (Four)BENCH_LRGOBJ_CHUNK);
+	printf("%-22s %-10s %12s\n", "method", "phase", "MB/sec");
+
+	e = benchRun(benchLargeObject, nObjects, minSize, maxSize, FALSE, "at once");
+	if (e < eNOERROR) ERR(e);
+
+	e = benchRun(benchLargeObject, nObjects, minSize, maxSize, TRUE, "streamed");
+	if (e < eNOERROR) ERR(e);
+
+	return(eNOERROR);
+}
+
+
+Four main(int argc, char *argv[])
+{
+	Four	e;									/* for errors */
+	Four	handle;								/* system handle */
+	Four	nObjects = BENCH_DEFAULT_NOBJECTS;	/* # of objects */
+	Four	minSize = BENCH_DEFAULT_MINSIZE;	/* smallest object */
+	Four	maxSize = BENCH_DEFAULT_MAXSIZE;	/* largest object */
+
+	if (argc > 1) nObjects = atol(argv[1]);
+	if (argc > 2) minSize = atol(argv[2]);
+	if (argc > 3) maxSize = atol(argv[3]);
+
+	e = LRDS_Init();
+	if (e < eNOERROR) { printf("LRDS_Init failed!!!\n"); exit(1); }
+
+	e = LRDS_AllocHandle(&handle);
+	if (e < eNOERROR) { printf("LRDS_AllocHandle failed!!!\n"); LRDS_Final(); exit(1); }
+
+	e = EduOM_Bench(nObjects, minSize, maxSize);
+	if (e < eNOERROR) {
+		printf("EduOM_Bench failed!!!\n");
+		LRDS_FreeHandle(handle);
+		LRDS_Final();
+		exit(1);
+	}
+
+	LRDS_FreeHandle(handle);
+	LRDS_Final();
+
+	return 0;
+}
@@ -0,0 +1,197 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_CollapseForwards.c
+ * 
+ * Description :
+ *  EduOM_CollapseForwards() brings the moved data of the objects of a file
+ *  back into their home pages, in one synchronous pass over the whole file.
+ *
+ * Exports:
+ *  Four EduOM_CollapseForwards(ObjectID*, Pool*, DeallocListElem*)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+#include "EduOM.h"
+
+
+
+/*@================================
+ * EduOM_CollapseForwards()
+ *================================*/
+/*
+ * Function: Four EduOM_CollapseForwards(ObjectID*, Pool*, DeallocListElem*)
+ * 
+ * Description :
+ *  (1) What to do?
+ *  EduOM_CollapseForwards() is a synchronous maintenance pass over the whole
+ *  file: it visits every page of the file and returns only when the last
+ *  one is done, so its cost grows with the size of the file, not with the
+ *  number of moved objects. There is no incremental or background mode;
+ *  run it when the file is idle, e.g. after a burst of EduOM_UpdateObject()
+ *  calls.
+ *  Every object moved out of its home page is moved back if the home page
+ *  has room for its data by now; the stub is replaced with the data and
+ *  the moved data is destroyed, so reading the object costs one page again.
+ *  Objects whose home page is still full are left moved.
+ *
+ *  (2) How to do?
+ *  a. FOR each page of the file DO
+ *	   collect the stubs of the page with the ObjectIDs of their data
+ *	   FOR each stub DO
+ *	       copy the moved data
+ *	       IF the stub is replaced with the data in the home page THEN
+ *		   destroy the moved data
+ *	       ENDIF
+ *	   ENDFOR
+ *     ENDFOR
+ *  b. Return the number of objects moved back
+ *
+ * Returns:
+ *  1) # of objects moved back into their home pages
+ *  2) Error codes: Negative value means error code.
+ *    eBADCATALOGOBJECT_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_CollapseForwards(
+    ObjectID  *catObjForFile,	/* IN file to collapse */
+    Pool      *dlPool,		/* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead)	/* INOUT head of dealloc list */
+{
+    Four        e;		/* error number */
+    Four        i;		/* index variable */
+    Two         slotNo;		/* slot of the page */
+    Four        nCollapsed;	/* # of objects moved back */
+    Four        nStubs;		/* # of stubs in the page */
+    ObjectID    stubs[PAGESIZE / sizeof(SlottedPageSlot)]; /* the stubs of the page */
+    ObjectID    movedOids[PAGESIZE / sizeof(SlottedPageSlot)]; /* where their data are */
+    PageID      pid;		/* page being collapsed */
+    SlottedPage *apage;		/* pointer to the buffer holding the page */
+    Object      *obj;		/* points to an object in data area */
+    PageNo      pageNo;		/* page being collapsed */
+    Four        length;		/* length of the moved data */
+    char        buf[LRGOBJ_THRESHOLD]; /* the moved data */
+    sm_CatOverlayForData *catEntry; /* cached catalog entry of the file */
+
+
+    /*@ parameter checking */
+
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    e = eduom_GetCatalogEntry(catObjForFile, &catEntry);
+    if (e < 0) ERR(e);
+
+    nCollapsed = 0;
+    for (pageNo = catEntry->firstPage; pageNo != NIL; ) {
+
+        /*@ collect the stubs of the page */
+        MAKE_PAGEID(pid, catEntry->fid.volNo, pageNo);
+
+        e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        /* a page of the PAX layout has no stub */
+        nStubs = 0;
+        for (slotNo = 0; !IS_PAX_PAGE(apage) && slotNo < apage->header.nSlots; slotNo++) {
+            if (apage->slot[-slotNo].offset == EMPTYSLOT) continue;
+
+            obj = (Object *)&(apage->data[apage->slot[-slotNo].offset]);
+            if (!(obj->header.properties & P_MOVED)) continue;
+
+            MAKE_OBJECTID(stubs[nStubs], pid.volNo, pid.pageNo, slotNo, apage->slot[-slotNo].unique);
+            memcpy(&movedOids[nStubs], obj->data, sizeof(ObjectID));
+            nStubs++;
+        }
+
+        e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        /*@ move the data back where there is room */
+        for (i = 0; i < nStubs; i++) {
+            MAKE_PAGEID(pid, movedOids[i].volNo, movedOids[i].pageNo);
+
+            e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+            if (e < 0) ERR(e);
+
+            obj = (Object *)&(apage->data[apage->slot[-(movedOids[i].slotNo)].offset]);
+            length = obj->header.length;
+            memcpy(buf, obj->data, length);
+
+            e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+            if (e < 0) ERR(e);
+
+            e = eduom_ReplaceObject(catObjForFile, catEntry, &stubs[i], 0, length, buf);
+            if (e < 0) ERR(e);
+            if (e == FALSE) continue;
+
+            e = EduOM_DestroyObject(catObjForFile, &movedOids[i], dlPool, dlHead);
+            if (e < 0) ERR(e);
+
+            nCollapsed++;
+        }
+
+        /*@ the page keeps its objects, so its link is read after moving the data */
+        MAKE_PAGEID(pid, catEntry->fid.volNo, pageNo);
+
+        e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        pageNo = apage->header.nextPage;
+
+        e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+        if (e < 0) ERR(e);
+    }
+
+    return(nCollapsed);
+    
+} /* EduOM_CollapseForwards() */
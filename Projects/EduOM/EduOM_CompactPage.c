@@ -66,6 +66,11 @@
 
 
 
+/*@ Internal Function Prototypes */
+static void eduom_Reverse(char*, Four);
+
+
+
 /*@================================
  * EduOM_CompactPage()
  *================================*/
@@ -83,15 +88,21 @@
  *  the beginning of the page.
  *
  *  (2) How to do?
- *  a. Save the given page into the temporary page
- *  b. FOR each nonempty slot DO
- *	Fill the original page by copying the object from the saved page
- *          to the data area of original page pointed by 'apageDataOffset'
+ *  a. Sort the nonempty slots other than 'slotNo' by the offsets of their
+ *     objects
+ *  b. FOR each of them in that order DO
+ *	Slide the object down with memmove() to 'apageDataOffset' unless
+ *          it is already there, i.e. in the prefix which is compact
  *	Update the slot offset
- *	Get 'apageDataOffet' to point the next moved position
+ *	Get 'apageDataOffset' to point the next moved position
  *     ENDFOR
- *   c. Update the 'freeStart' and 'unused' field of the page
- *   d. Return
+ *  c. IF 'slotNo' is not NIL THEN
+ *	Slide its object down as well, and rotate it past the objects
+ *          following it so that it ends up at the end
+ *     ENDIF
+ *  d. Update the 'freeStart' and 'unused' field of the page
+ *  e. Return
+ *  The page is compacted in place; no copy of the page is made.
  *	
  * Returns:
  *  error code
@@ -104,49 +115,67 @@ Four EduOM_CompactPage(
     SlottedPage	*apage,		/* IN slotted page to compact */
     Two         slotNo)		/* IN slotNo to go to the end */
 {
-	/* These local variables are used in the solution code. However, you don��t have to use all these variables in your code, and you may also declare and use additional local variables if needed. */
-    SlottedPage	tpage;		/* temporay page used to save the given page */
     Object *obj;		/* pointer to the object in the data area */
     Two    apageDataOffset;	/* where the next object is to be moved */
     Four   len;			/* length of object + length of ObjectHdr */
-    Two    lastSlot;		/* last non empty slot */
-    Two    i;			/* index variable */
+    Four   lastLen;		/* length of the object of 'slotNo' + length of ObjectHdr */
+    Two    lastOffset;		/* where the object of 'slotNo' is moved before the rotation */
+    Two    nLive;		/* # of nonempty slots to be sorted */
+    Two    live[PAGESIZE / sizeof(SlottedPageSlot)]; /* nonempty slots sorted by offset */
+    Two    i, j;		/* index variables */
+    Two    k;			/* slot being inserted into 'live' */
 
-    apageDataOffset=0;
-    tpage=*apage;
-    if(tpage.header.free==0)
+    /* the records of the PAX layout are dense already */
+    if(apage->header.free==0||IS_PAX_PAGE(apage))
         return(eNOERROR); 
-    lastSlot=tpage.header.nSlots;
-    
-    //not nil case test needed
-    if(slotNo!=NIL){
-        for(i=0;i<lastSlot;i++){
-            if(tpage.slot[-i].offset==EMPTYSLOT||i==slotNo){
-                continue;
-            }
-            obj = (Object *)&(tpage.data[tpage.slot[-i].offset]);
-            len=ALIGNED_LENGTH(obj->header.length)+sizeof(ObjectHdr);
-            apage->slot[-i].offset=apageDataOffset;
-            memcpy(&apage->data[apageDataOffset],obj,len);
-            apageDataOffset+=len;
+
+    /*@ sort the nonempty slots by offset; they are mostly in order already */
+    nLive=0;
+    for(i=0;i<apage->header.nSlots;i++){
+        if(apage->slot[-i].offset==EMPTYSLOT||i==slotNo)
+            continue;
+        k=i;
+        for(j=nLive;j>0&&apage->slot[-live[j-1]].offset>apage->slot[-k].offset;j--)
+            live[j]=live[j-1];
+        live[j]=k;
+        nLive++;
+    }
+
+    /*@ slide the objects down */
+    apageDataOffset=0;
+    lastOffset=NIL;
+    lastLen=0;
+    for(i=0;i<=nLive;i++){
+        /* the object of 'slotNo' goes down in its place in the order too */
+        if(slotNo!=NIL&&lastOffset==NIL&&
+           (i==nLive||apage->slot[-slotNo].offset<apage->slot[-live[i]].offset)){
+            obj=(Object *)&(apage->data[apage->slot[-slotNo].offset]);
+            lastLen=OBJECT_SIZE_IN_PAGE(obj);
+            if(apage->slot[-slotNo].offset!=apageDataOffset)
+                memmove(&apage->data[apageDataOffset],obj,lastLen);
+            lastOffset=apageDataOffset;
+            apageDataOffset+=lastLen;
         }
-        obj=(Object *)&(tpage.data[tpage.slot[-slotNo].offset]);
-        len=ALIGNED_LENGTH(obj->header.length)+sizeof(ObjectHdr);
-        apage->slot[-slotNo].offset=apageDataOffset;
-        memcpy(&apage->data[apageDataOffset],obj,len);
+        if(i==nLive)
+            break;
+
+        obj=(Object *)&(apage->data[apage->slot[-live[i]].offset]);
+        len=OBJECT_SIZE_IN_PAGE(obj);
+        if(apage->slot[-live[i]].offset!=apageDataOffset)
+            memmove(&apage->data[apageDataOffset],obj,len);
+        apage->slot[-live[i]].offset=apageDataOffset;
         apageDataOffset+=len;
     }
-    else{
-        for(i=0;i<lastSlot;i++){
-            if(tpage.slot[-i].offset==EMPTYSLOT){
-                continue;
-            }
-            obj = (Object *)&(tpage.data[tpage.slot[-i].offset]);
-            len=ALIGNED_LENGTH(obj->header.length)+sizeof(ObjectHdr);
-            apage->slot[-i].offset=apageDataOffset;
-            memcpy(&apage->data[apageDataOffset],obj,len);
-            apageDataOffset+=len;
-        }
+
+    /*@ rotate the object of 'slotNo' past the objects following it */
+    if(slotNo!=NIL){
+        eduom_Reverse(&apage->data[lastOffset],lastLen);
+        eduom_Reverse(&apage->data[lastOffset+lastLen],apageDataOffset-lastOffset-lastLen);
+        eduom_Reverse(&apage->data[lastOffset],apageDataOffset-lastOffset);
+        for(i=0;i<nLive;i++)
+            if(apage->slot[-live[i]].offset>lastOffset)
+                apage->slot[-live[i]].offset-=lastLen;
+        apage->slot[-slotNo].offset=apageDataOffset-lastLen;
     }
 
     apage->header.free=apageDataOffset;
@@ -155,3 +184,33 @@ Four EduOM_CompactPage(
     return(eNOERROR);
     
 } /* EduOM_CompactPage */
+
+
+
+/*@================================
+ * eduom_Reverse()
+ *================================*/
+/*
+ * Function: static void eduom_Reverse(char*, Four)
+ * 
+ * Description : 
+ *  Reverse the order of the bytes of the area; three reversals rotate an
+ *  area in place.
+ *
+ * Returns:
+ *  None
+ */
+static void eduom_Reverse(
+    char	*area,		/* INOUT area to reverse */
+    Four	len)		/* IN length of the area */
+{
+    char   c;			/* byte being swapped */
+    Four   i;			/* index variable */
+
+    for(i=0;i<len/2;i++){
+        c=area[i];
+        area[i]=area[len-1-i];
+        area[len-1-i]=c;
+    }
+
+} /* eduom_Reverse */
@@ -53,12 +53,13 @@
  *  EduOM_CreateObject() creates a new object near the specified object.
  *
  * Exports:
- *  Four EduOM_CreateObject(ObjectID*, ObjectID*, ObjectHdr*, Four, char*, ObjectID*)
+ *  Four EduOM_CreateObject(ObjectID*, ObjectID*, ObjectHdr*, Four, void*, ObjectID*)
  */
 
 
 #include "EduOM_common.h"
 #include "EduOM_Internal.h"
+#include "EduOM.h"
 
 
 
@@ -66,7 +67,7 @@
  * EduOM_CreateObject()
  *================================*/
 /*
- * Function: Four EduOM_CreateObject(ObjectID*, ObjectID*, ObjectHdr*, Four, char*, ObjectID*)
+ * Function: Four EduOM_CreateObject(ObjectID*, ObjectID*, ObjectHdr*, Four, void*, ObjectID*)
  * 
  * Description :
  * (Following description is for original ODYSSEUS/COSMOS OM.
@@ -77,6 +78,8 @@
  * If there is no room in the page holding the specified object,
  * it trys to insert into the page in the available space list. If fail, then
  * the new object will be put into the newly allocated page.
+ * An object too large for a page is created empty and its data is then
+ * appended by EduOM_AppendToObject(), which makes it a large object.
  *
  * (2) How to do?
  *	a. Read in the near slotted page
@@ -110,7 +113,7 @@ Four EduOM_CreateObject(
     ObjectID  *nearObj,		/* IN create the new object near this object */
     ObjectHdr *objHdr,		/* IN from which tag is to be set */
     Four      length,		/* IN amount of data */
-    char      *data,		/* IN the initial data for the object */
+    void      *data,		/* IN the initial data for the object */
     ObjectID  *oid)		/* OUT the object's ObjectID */
 {
 	/* These local variables are used in the solution code. However, you don��t have to use all these variables in your code, and you may also declare and use additional local variables if needed. */
@@ -126,9 +129,6 @@ Four EduOM_CreateObject(
 
     if (length > 0 && data == NULL) return(eBADUSERBUF_OM);
 
-	/* Error check whether using not supported functionality by EduOM */
-	if(ALIGNED_LENGTH(length) > LRGOBJ_THRESHOLD) ERR(eNOTSUPPORTED_EDUOM);
-
     if(objHdr==NULL){
         objectHdr.tag=0;
     }
@@ -139,7 +139,18 @@ Four EduOM_CreateObject(
     objectHdr.properties=0x0;
     objectHdr.length=0;
 
-    eduom_CreateObject(catObjForFile,nearObj,&objectHdr,length,data,oid);
+    if(ALIGNED_LENGTH(length) > LRGOBJ_THRESHOLD){
+        e = eduom_CreateObject(catObjForFile,nearObj,&objectHdr,0,NULL,oid);
+        if (e < 0) ERR(e);
+
+        /* a new object has not been moved, so no page is deallocated */
+        e = EduOM_AppendToObject(catObjForFile,oid,length,data,NULL,NULL);
+        if (e < 0) ERR(e);
+    }
+    else {
+        e = eduom_CreateObject(catObjForFile,nearObj,&objectHdr,length,data,oid);
+        if (e < 0) ERR(e);
+    }
     
     return(eNOERROR);
 }
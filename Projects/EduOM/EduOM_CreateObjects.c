@@ -0,0 +1,467 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_CreateObjects.c
+ * 
+ * Description :
+ *  EduOM_CreateObjects() creates many objects at the end of a file at once.
+ *
+ * Exports:
+ *  Four EduOM_CreateObjects(ObjectID*, Four, ObjectHdr*, Four*, char**, ObjectID*)
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "EduOM_common.h"
+#include "RDsM.h"		/* for the raw disk manager call */
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+#include "EduOM.h"
+
+
+
+/*@ Internal Function Prototypes */
+static Boolean eduom_FitsInPage(Four, Four, Four);
+static Four eduom_PagesNeeded(Four, Four*);
+static Four eduom_FillPage(SlottedPage*, Four, Four, ObjectHdr*, Four*, char**, ObjectID*);
+static void eduom_FreeNewPages(PageID*, Four, Four);
+
+
+
+/*@================================
+ * EduOM_CreateObjects()
+ *================================*/
+/*
+ * Function: Four EduOM_CreateObjects(ObjectID*, Four, ObjectHdr*, Four*, char**, ObjectID*)
+ * 
+ * Description :
+ *  Create 'nObjects' objects at the end of the file; the i-th object gets
+ *  the tag of objHdrs[i] (0 if objHdrs is NULL) and the lengths[i] bytes
+ *  of data[i] as its initial data.
+ *  This is the bulk counterpart of calling EduOM_CreateObject() with no near
+ *  object once per object: the catalog object is fixed once, the objects
+ *  are packed into the last page of the file and then into new pages in
+ *  their order, all the new pages are allocated by one RDsM_AllocTrains()
+ *  call, and the slot directory of a page is written in one pass.
+ *  The new pages are all formatted and filled before the first of them is
+ *  linked into the list of pages of the file by om_FileMapAddPage(), so the
+ *  file never reaches a page which is not formatted.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADLENGTH_OM
+ *    eBADUSERBUF_OM
+ *    eNOTSUPPORTED_EDUOM
+ *    eMEMORYALLOCERR_EDUOM
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  0) 'nObjects' new objects are created; if an error occurs after the
+ *     parameters are checked, the objects placed in the last page of the
+ *     file and in the new pages linked so far remain in the file, and the
+ *     new pages not linked yet are freed.
+ *  1) parameter oids
+ *     oids[i] is set to the ObjectID of the i-th new object.
+ */
+Four EduOM_CreateObjects(
+    ObjectID  *catObjForFile,	/* IN file in which objects are to be placed */
+    Four      nObjects,		/* IN # of objects to create */
+    ObjectHdr *objHdrs,		/* IN from which tags are to be set; may be NULL */
+    Four      *lengths,		/* IN amount of data of each object */
+    char      **data,		/* IN the initial data of each object */
+    ObjectID  *oids)		/* OUT the objects' ObjectIDs */
+{
+    Four        e;		/* error number */
+    Four        i;		/* index variable */
+    Four        done;		/* # of objects placed so far */
+    Four        nSlots;		/* # of slots of the last page in use */
+    Four        nPages;		/* # of new pages */
+    Four        firstExt;	/* first Extent No of the file */
+    PageID      lastPid;	/* last page of the file */
+    PageID      *pids;		/* new pages */
+    PhysicalFileID pFid;	/* physical ID of file */
+    SlottedPage *apage;		/* pointer to the slotted page buffer */
+    sm_CatOverlayForData *catEntry; /* cached catalog entry of the file */
+
+
+    /*@ parameter checking */
+    
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (nObjects < 0 || (nObjects > 0 && lengths == NULL)) ERR(eBADLENGTH_OM);
+
+    if (nObjects > 0 && (data == NULL || oids == NULL)) ERR(eBADUSERBUF_OM);
+
+    for (i = 0; i < nObjects; i++) {
+        if (lengths[i] < 0) ERR(eBADLENGTH_OM);
+
+        if (lengths[i] > 0 && data[i] == NULL) ERR(eBADUSERBUF_OM);
+
+        /* Error check whether using not supported functionality by EduOM */
+        if (ALIGNED_LENGTH(lengths[i]) > LRGOBJ_THRESHOLD) ERR(eNOTSUPPORTED_EDUOM);
+    }
+
+    if (nObjects == 0) return(eNOERROR);
+
+    /*@ fill the last page of the file */
+    e = eduom_GetLastPage(catObjForFile, &catEntry, &lastPid, &apage);
+    if (e < 0) ERR(e);
+
+    /* the records of the PAX layout are placed one by one, each after the previous one */
+    if (IS_PAX_PAGE(apage)) {
+        e = BfM_FreeTrain((TrainID *)&lastPid, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        for (i = 0; i < nObjects; i++) {
+            e = eduom_PaxCreateObject(catObjForFile, catEntry, &lastPid, lengths[i], data[i], &oids[i]);
+            if (e < 0) ERR(e);
+            MAKE_PAGEID(lastPid, oids[i].volNo, oids[i].pageNo);
+        }
+
+        return(eNOERROR);
+    }
+
+    /* an empty page keeps one slot which is not in use */
+    nSlots = (apage->header.free == 0) ? 0 : apage->header.nSlots;
+
+    if (apage->header.unused > 0 &&
+        eduom_FitsInPage(apage->header.free - apage->header.unused, nSlots + 1,
+                         sizeof(ObjectHdr) + DATA_LENGTH_IN_PAGE(lengths[0]))) {
+        e = EduOM_CompactPage(apage, NIL);
+        if (e < 0) ERRB1(e, &lastPid, PAGE_BUF);
+    }
+
+    done = 0;
+    if (apage->header.unused == 0 &&
+        eduom_FitsInPage(apage->header.free, nSlots + 1, sizeof(ObjectHdr) + DATA_LENGTH_IN_PAGE(lengths[0]))) {
+
+        e = om_RemoveFromAvailSpaceList(catObjForFile, &lastPid, apage);
+        if (e < 0) ERRB1(e, &lastPid, PAGE_BUF);
+
+        /* the slots of an empty page are dropped with their free-slot list */
+        if (nSlots == 0) SP_SET_FREESLOT_HEAD(apage, NIL);
+        apage->header.nSlots = nSlots;
+        done = eduom_FillPage(apage, nObjects, 0, objHdrs, lengths, data, oids);
+        if (done < 0) ERRB1(done, &lastPid, PAGE_BUF);
+
+        e = om_PutInAvailSpaceList(catObjForFile, &lastPid, apage);
+        if (e >= 0) e = eduom_FsmUpdate(catObjForFile, catEntry, &lastPid, SP_FREE(apage));
+        if (e < 0) ERRB1(e, &lastPid, PAGE_BUF);
+    }
+
+    e = BfM_SetDirty((TrainID *)&lastPid, PAGE_BUF);
+    if (e >= 0) e = BfM_FreeTrain((TrainID *)&lastPid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    if (done == nObjects) return(eNOERROR);
+
+    /*@ allocate all the new pages at once */
+    nPages = eduom_PagesNeeded(nObjects - done, &lengths[done]);
+
+    pids = (PageID *)malloc(sizeof(PageID) * nPages);
+    if (pids == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+
+    MAKE_PHYSICALFILEID(pFid, catEntry->fid.volNo, catEntry->firstPage);
+    e = RDsM_PageIdToExtNo((PageID *)&pFid, &firstExt);
+    if (e >= 0)
+        e = RDsM_AllocTrains(catEntry->fid.volNo, firstExt, &lastPid, catEntry->eff, nPages, PAGESIZE2, pids);
+    if (e < 0) {
+        free(pids);
+        ERR(e);
+    }
+
+    /*@ fill the new pages before any of them becomes part of the file */
+    for (i = 0; i < nPages; i++) {
+        e = BfM_GetNewTrain((TrainID *)&pids[i], (char **)&apage, PAGE_BUF);
+        if (e < 0) {
+            eduom_FreeNewPages(pids, 0, nPages);
+            ERR(e);
+        }
+
+        apage->header.pid = pids[i];
+        apage->header.flags = SLOTTED_PAGE_TYPE;
+        SP_SET_FREESLOT_HEAD(apage, NIL);
+        apage->header.nSlots = 0;
+        apage->header.free = 0;
+        apage->header.unused = 0;
+        apage->header.fid = catEntry->fid;
+        apage->header.unique = 0;
+        apage->header.uniqueLimit = 0;
+        apage->header.prevPage = NIL;
+        apage->header.nextPage = NIL;
+        apage->header.spaceListPrev = NIL;
+        apage->header.spaceListNext = NIL;
+
+        e = eduom_FillPage(apage, nObjects, done, objHdrs, lengths, data, oids);
+        if (e >= 0) {
+            done = e;
+            e = BfM_SetDirty((TrainID *)&pids[i], PAGE_BUF);
+        }
+        if (e < 0) {
+            BfM_FreeTrain((TrainID *)&pids[i], PAGE_BUF);
+            eduom_FreeNewPages(pids, 0, nPages);
+            ERR(e);
+        }
+
+        e = BfM_FreeTrain((TrainID *)&pids[i], PAGE_BUF);
+        if (e < 0) {
+            eduom_FreeNewPages(pids, 0, nPages);
+            ERR(e);
+        }
+    }
+
+    /*@ append the new pages to the list of pages of the file in their order */
+    for (i = 0; i < nPages; i++) {
+        e = om_FileMapAddPage(catObjForFile, (i == 0) ? &lastPid : &pids[i-1], &pids[i]);
+        eduom_InvalidateCatalogEntry(catObjForFile);
+        if (e < 0) {
+            eduom_FreeNewPages(pids, i, nPages);
+            ERR(e);
+        }
+
+        e = BfM_GetTrain((TrainID *)&pids[i], (char **)&apage, PAGE_BUF);
+        if (e < 0) {
+            eduom_FreeNewPages(pids, i+1, nPages);
+            ERR(e);
+        }
+
+        e = om_PutInAvailSpaceList(catObjForFile, &pids[i], apage);
+        if (e >= 0) e = eduom_FsmUpdate(catObjForFile, catEntry, &pids[i], SP_FREE(apage));
+        if (e >= 0) e = BfM_SetDirty((TrainID *)&pids[i], PAGE_BUF);
+        if (e < 0) {
+            BfM_FreeTrain((TrainID *)&pids[i], PAGE_BUF);
+            eduom_FreeNewPages(pids, i+1, nPages);
+            ERR(e);
+        }
+
+        e = BfM_FreeTrain((TrainID *)&pids[i], PAGE_BUF);
+        if (e < 0) {
+            eduom_FreeNewPages(pids, i+1, nPages);
+            ERR(e);
+        }
+    }
+
+    free(pids);
+
+    return(eNOERROR);
+    
+} /* EduOM_CreateObjects() */
+
+
+
+/*@================================
+ * eduom_FitsInPage()
+ *================================*/
+/*
+ * Function: static Boolean eduom_FitsInPage(Four, Four, Four)
+ * 
+ * Description :
+ *  Check whether an object of 'objSize' bytes (header included) fits in a
+ *  page whose contiguous free area starts at 'free' and which uses 'nSlots'
+ *  slots after the object is placed.
+ *
+ * Returns:
+ *  TRUE if the object fits, FALSE otherwise
+ */
+static Boolean eduom_FitsInPage(
+    Four	free,		/* IN offset of the contiguous free area */
+    Four	nSlots,		/* IN # of slots in use after placing the object */
+    Four	objSize)	/* IN size of the object */
+{
+    return((free + objSize + (nSlots-1)*(Four)sizeof(SlottedPageSlot) <= PAGESIZE - SP_FIXED) ? TRUE : FALSE);
+
+} /* eduom_FitsInPage() */
+
+
+
+/*@================================
+ * eduom_PagesNeeded()
+ *================================*/
+/*
+ * Function: static Four eduom_PagesNeeded(Four, Four*)
+ * 
+ * Description :
+ *  Compute how many empty pages the given objects fill when they are
+ *  packed in their order by eduom_FillPage().
+ *
+ * Returns:
+ *  # of pages
+ */
+static Four eduom_PagesNeeded(
+    Four	nObjects,	/* IN # of objects */
+    Four	*lengths)	/* IN amount of data of each object */
+{
+    Four        i;		/* index variable */
+    Four        nPages;		/* # of pages */
+    Four        free;		/* contiguous free area of the current page */
+    Four        nSlots;		/* # of slots of the current page */
+    Four        objSize;	/* size of an object */
+
+
+    nPages = 0;
+    free = nSlots = 0;
+    for (i = 0; i < nObjects; i++) {
+        objSize = sizeof(ObjectHdr) + DATA_LENGTH_IN_PAGE(lengths[i]);
+
+        if (nPages == 0 || !eduom_FitsInPage(free, nSlots + 1, objSize)) {
+            nPages++;
+            free = nSlots = 0;
+        }
+
+        free += objSize;
+        nSlots++;
+    }
+
+    return(nPages);
+
+} /* eduom_PagesNeeded() */
+
+
+
+/*@================================
+ * eduom_FillPage()
+ *================================*/
+/*
+ * Function: static Four eduom_FillPage(SlottedPage*, Four, Four, ObjectHdr*, Four*, char**, ObjectID*)
+ * 
+ * Description :
+ *  Place the objects from the 'done'-th on into the contiguous free area of
+ *  the page in their order while they fit; the empty slots of the page are
+ *  reused first, as the free-slot list of the page gives them. The page must have no unused bytes.
+ *
+ * Returns:
+ *  1) # of objects placed so far, i.e. 'done' plus the objects placed
+ *  2) Error codes: Negative value means error code.
+ *     some errors caused by function calls
+ */
+static Four eduom_FillPage(
+    SlottedPage	*apage,		/* INOUT page to fill */
+    Four	nObjects,	/* IN # of all objects */
+    Four	done,		/* IN # of objects placed before */
+    ObjectHdr	*objHdrs,	/* IN from which tags are to be set; may be NULL */
+    Four	*lengths,	/* IN amount of data of each object */
+    char	**data,		/* IN the initial data of each object */
+    ObjectID	*oids)		/* OUT the objects' ObjectIDs */
+{
+    Four        e;		/* error number */
+    Four        slotNo;		/* slot of the next object */
+    Four        nSlots;		/* # of slots in use */
+    Four        alignedLen;	/* aligned length of the data */
+    Object      *obj;		/* points to the new object */
+
+
+    nSlots = apage->header.nSlots;
+
+    for ( ; done < nObjects; done++) {
+
+        /* an empty slot from the free-slot list, or a new one */
+        slotNo = eduom_AllocSlot(apage);
+
+        alignedLen = DATA_LENGTH_IN_PAGE(lengths[done]);
+        if (!eduom_FitsInPage(apage->header.free, MAX(nSlots, slotNo + 1), sizeof(ObjectHdr) + alignedLen)) {
+            if (slotNo < nSlots) eduom_FreeSlot(apage, slotNo);
+            break;
+        }
+
+        obj = (Object *)&(apage->data[apage->header.free]);
+        obj->header.properties = 0x0;
+        obj->header.tag = (objHdrs == NULL) ? 0 : objHdrs[done].tag;
+        obj->header.length = lengths[done];
+        if (lengths[done] > 0) memcpy(obj->data, data[done], lengths[done]);
+
+        apage->slot[-slotNo].offset = apage->header.free;
+        e = om_GetUnique(&apage->header.pid, &(apage->slot[-slotNo].unique));
+        if (e < 0) ERR(e);
+
+        apage->header.free += sizeof(ObjectHdr) + alignedLen;
+        nSlots = MAX(nSlots, slotNo + 1);
+        apage->header.nSlots = nSlots;
+
+        oids[done].pageNo = apage->header.pid.pageNo;
+        oids[done].volNo = apage->header.pid.volNo;
+        oids[done].slotNo = slotNo;
+        oids[done].unique = apage->slot[-slotNo].unique;
+    }
+
+    return(done);
+
+} /* eduom_FillPage() */
+
+
+
+/*@================================
+ * eduom_FreeNewPages()
+ *================================*/
+/*
+ * Function: static void eduom_FreeNewPages(PageID*, Four, Four)
+ * 
+ * Description :
+ *  Give back the new pages from the 'from'-th on, which have not become
+ *  part of the file, and the array of the new pages. Called on an error,
+ *  so an error in freeing a page is not reported over the first one.
+ *
+ * Returns:
+ *  None
+ */
+static void eduom_FreeNewPages(
+    PageID	*pids,		/* IN new pages */
+    Four	from,		/* IN first page not in the file */
+    Four	nPages)		/* IN # of new pages */
+{
+    Four        i;		/* index variable */
+
+
+    for (i = from; i < nPages; i++)
+        RDsM_FreeTrain(&pids[i], PAGESIZE2);
+
+    free(pids);
+
+} /* eduom_FreeNewPages() */
@@ -56,6 +56,7 @@
  *  Four EduOM_DestroyObject(ObjectID*, ObjectID*, Pool*, DeallocListElem*)
  */
 
+#include <string.h>
 #include "EduOM_common.h"
 #include "Util.h"		/* to get Pool */
 #include "RDsM.h"
@@ -77,15 +78,28 @@
  *  EduOM_DestroyObject() destroys the specified object. The specified object
  *  will be removed from the slotted page. The freed space is not merged
  *  to make the contiguous space; it is done when it is needed.
- *  The page's membership to 'availSpaceList' may be changed.
+ *  The page's membership to 'availSpaceList' may be changed, and its free
+ *  space is recorded in the free-space map of the file. The pages of a
+ *  large object are given back through the large object manager.
  *  If the destroyed object is the only object in the page, then deallocate
  *  the page.
  *
  *  (2) How to do?
  *  a. Read in the slotted page
- *  b. Remove this page from the 'availSpaceList'
- *  c. Delete the object from the page
+ *  b. IF moved object THEN
+ *	   call this routine recursively with the moved data's identifier
+ *     ENDIF
+ *     Remove this page from the 'availSpaceList'
+ *  c. IF page of the PAX layout THEN
+ *	   move the last record of the page into the place of the object
+ *     ELSE IF large object THEN
+ *	   call the large object manager's LOT_DestroyObject(), which also
+ *	   gives back the space of the root in the page
+ *     ELSE
+ *	   Delete the object from the page
+ *     ENDIF
  *  d. Update the control information: 'unused', 'freeStart', 'slot offset'
+ *     and put the slot on the free-slot list of the page
  *  e. IF no more object in this page THEN
  *	   Remove this page from the filemap List
  *	   Dealloate this page
@@ -117,56 +131,94 @@ Four EduOM_DestroyObject(
     Object      *obj;		/* points to the object in data area */
     Four        alignedLen;	/* aligned length of object */
     Boolean     last;		/* indicates the object is the last one */
-    SlottedPage *catPage;	/* buffer page containing the catalog object */
+    Boolean     dealloc;	/* the page is deallocated from the file */
     sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
     DeallocListElem *dlElem;	/* pointer to element of dealloc list */
     PhysicalFileID pFid;	/* physical ID of file */
     Four unique;
+    ObjectID movedOid;		/* where the data of a moved object is */
 
     /*@ Check parameters. */
     if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
 
     if (oid == NULL) ERR(eBADOBJECTID_OM);
 
-    BfM_GetTrain((TrainID *)oid,(char**)&apage,PAGE_BUF);
-    BfM_GetTrain((TrainID *)catObjForFile,(char**)&catPage,PAGE_BUF);
-
-    GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile,catPage,catEntry);
+    e = eduom_GetCatalogEntry(catObjForFile, &catEntry);
+    if (e < 0) ERR(e);
 
     MAKE_PAGEID(pid,catEntry->fid.volNo,oid->pageNo);
 
+    e = BfM_GetTrain((TrainID *)&pid,(char**)&apage,PAGE_BUF);
+    if (e < 0) ERR(e);
+
     offset = apage->slot[-(oid->slotNo)].offset;
     unique = apage->slot[-(oid->slotNo)].unique;
     obj = (Object *)&(apage->data[offset]);
 
+    /* the moved data goes with its stub */
+    if(!IS_PAX_PAGE(apage) && (obj->header.properties & P_MOVED)){
+        memcpy(&movedOid, obj->data, sizeof(ObjectID));
+        e = EduOM_DestroyObject(catObjForFile, &movedOid, dlPool, dlHead);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+    }
+
     e=om_RemoveFromAvailSpaceList(catObjForFile,&pid,apage);
     if (e < 0) ERRB1(e, &pid, PAGE_BUF);
-    apage->slot[-(oid->slotNo)].offset=EMPTYSLOT;
 
-    last= (unique==apage->header.nSlots-1);
-
-    if(last){
-        apage->header.nSlots--;
-        apage->header.free-=sizeof(ObjectHdr)+ALIGNED_LENGTH(obj->header.length);
+    if(IS_PAX_PAGE(apage))
+        eduom_PaxRemoveRecord(apage, oid->slotNo);
+    else if(obj->header.properties & P_LRGOBJ){
+        e = LOT_DestroyObject(&pid, oid->slotNo, dlPool, dlHead);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
     }
     else{
-    apage->header.unused+=sizeof(ObjectHdr)+ALIGNED_LENGTH(obj->header.length);
+        alignedLen=sizeof(ObjectHdr)+DATA_LENGTH_IN_PAGE(obj->header.length);
+
+        /* the space of an object at the end of the data area goes back to the contiguous free area */
+        if(offset+alignedLen==apage->header.free)
+            apage->header.free-=alignedLen;
+        else
+            apage->header.unused+=alignedLen;
     }
+    apage->slot[-(oid->slotNo)].offset=EMPTYSLOT;
 
-    if(apage->header.nSlots==0&&(catEntry->firstPage!=oid->pageNo)){
-        om_FileMapDeletePage(catObjForFile, &pid);
+    last= (oid->slotNo==apage->header.nSlots-1);
+
+    if(last)
+        apage->header.nSlots--;
+    else
+        eduom_FreeSlot(apage, oid->slotNo);
+
+    if(IS_PAX_PAGE(apage))
+        PAX_SET_FULL(apage);
+
+    dealloc = (apage->header.nSlots==0&&(catEntry->firstPage!=oid->pageNo));
+    if(dealloc){
+        e = om_FileMapDeletePage(catObjForFile, &pid);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+        eduom_InvalidateCatalogEntry(catObjForFile);
         e = Util_getElementFromPool(dlPool, &dlElem);
-        if( e < 0 ) ERR( e );
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
         dlElem->type = DL_PAGE;
         dlElem->elem.pid = pid; /* ID of the deallocated page */ 
         dlElem->next = dlHead->next;
         dlHead->next = dlElem;
     }
     else{
-        om_PutInAvailSpaceList(catObjForFile,&pid,apage);
+        e = om_PutInAvailSpaceList(catObjForFile,&pid,apage);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
     }
-    BfM_FreeTrain(oid,PAGE_BUF);
-    BfM_FreeTrain(catObjForFile,PAGE_BUF);
+
+    /* the slot, 'free', 'unused' and the free-slot list have changed */
+    e = BfM_SetDirty((TrainID *)&pid, PAGE_BUF);
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    /*@ record the free space of the page as it is now, while it is fixed */
+    e = eduom_FsmUpdate(catObjForFile, catEntry, &pid, dealloc ? 0 : SP_FREE(apage));
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    if (e < 0) ERR(e);
  
     return(eNOERROR);
     
@@ -75,9 +75,12 @@
  *  same page which has the current Object and  if there  is no next Object in
  *  the same page, find it from the next page. If the Current Object is NULL,
  *  return the first Object of the file.
+ *  Empty slots are skipped, and so is the data of a moved object, which is
+ *  returned through its stub only.
  *
  * Returns:
- *  error code
+ *  1) eNOERROR, or EOS at the end of the file
+ *  2) error code
  *    eBADCATALOGOBJECT_OM
  *    eBADOBJECTID_OM
  *    some errors caused by function calls
@@ -103,7 +106,6 @@ Four EduOM_NextObject(
     SlottedPage *apage,*nextpage;		/* a pointer to the data page */
     Object *obj;		/* a pointer to the Object */
     PhysicalFileID pFid;	/* file in which the objects are located */
-    SlottedPage *catPage;	/* buffer page containing the catalog object */
     sm_CatOverlayForData *catEntry; /* data structure for catalog object access */
     VolNo volNo;
     Unique unique;
@@ -117,62 +119,55 @@ Four EduOM_NextObject(
     
     if (nextOID == NULL) ERR(eBADOBJECTID_OM);
 
-    if(curOID==NULL){
-        BfM_GetTrain((TrainID *)catObjForFile,(char**)&catPage,PAGE_BUF);
-        GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile,catPage,catEntry);
-        if(catEntry->firstPage==-1)
-            return(EOS);
+    e=eduom_GetCatalogEntry(catObjForFile,&catEntry);
+    if(e<0) ERR(e);
+    volNo=catEntry->fid.volNo;
 
-        pageNo= catEntry->firstPage;
-        volNo=nextOID->volNo;
-        while(1){
-            MAKE_PAGEID(pid,volNo,pageNo);
-            BfM_GetTrain(&pid,(char**)&apage,PAGE_BUF);
-            if(apage->header.nSlots==0){
-                pageNo= apage->header.nextPage;
-                //error handling check needed
-                if(pageNo==-1){
-                    e=pageNo;
-                    ERR(e);
-                }
-                continue;
-            }
-            i=0;
-            unique=apage->slot[-(i)].unique;
-            BfM_FreeTrain(catObjForFile,PAGE_BUF);
-            BfM_FreeTrain(&pid,PAGE_BUF);
-            break;
-        }
+    if(curOID==NULL){
+        pageNo=catEntry->firstPage;
+        i=0;
     }
     else{
-        BfM_GetTrain((TrainID *)curOID,(char**)&apage,PAGE_BUF);
-        slotno=curOID->slotNo;
-        if(slotno==apage->header.nSlots-1){
-            if(apage->header.nextPage==-1)
-                return(EOS);
-            pageNo= apage->header.nextPage;
-            volNo=nextOID->volNo;
-            MAKE_PAGEID(pid,volNo,pageNo);
-            BfM_GetTrain(&pid,(char**)&nextpage,PAGE_BUF);
-            i=0;
-            unique=nextpage->slot[-(i)].unique;
-            
-            BfM_FreeTrain(curOID,PAGE_BUF);
-            BfM_FreeTrain(&pid,PAGE_BUF);
+        pageNo=curOID->pageNo;
+        i=curOID->slotNo+1;
+    }
+
+    /*@ find the next slot holding an object, skipping empty slots and moved data */
+    while(pageNo!=NIL){
+        MAKE_PAGEID(pid,volNo,pageNo);
+        e=BfM_GetTrain(&pid,(char**)&apage,PAGE_BUF);
+        if(e<0) ERR(e);
+
+        for(;i<apage->header.nSlots;i++){
+            offset=apage->slot[-i].offset;
+            if(offset==EMPTYSLOT) continue;
+            if(IS_PAX_PAGE(apage)) break;
+            obj=(Object *)&(apage->data[offset]);
+            /* the data of a moved object is returned through its stub only */
+            if(!(obj->header.properties&P_FORWARDED)) break;
         }
-        else{
-            pageNo=apage->header.pid.pageNo;
-            volNo=apage->header.pid.volNo;
-            i=slotno+1;
-            BfM_FreeTrain(curOID,PAGE_BUF);
-            unique=apage->slot[-(i)].unique;
+
+        if(i<apage->header.nSlots){
+            MAKE_OBJECTID(*nextOID,volNo,pageNo,i,apage->slot[-i].unique);
+            if(objHdr!=NULL){
+                if(IS_PAX_PAGE(apage)){
+                    objHdr->properties=0;
+                    objHdr->tag=0;
+                    objHdr->length=PAX_HDR(apage)->recordLength;
+                }
+                else
+                    *objHdr=obj->header;
+            }
+            e=BfM_FreeTrain(&pid,PAGE_BUF);
+            if(e<0) ERR(e);
+            return(eNOERROR);
         }
-    }
-    nextOID->pageNo=pageNo;
-    nextOID->volNo=volNo;
-    nextOID->slotNo=i;
-    nextOID->unique=unique;
 
+        pageNo=apage->header.nextPage;
+        e=BfM_FreeTrain(&pid,PAGE_BUF);
+        if(e<0) ERR(e);
+        i=0;
+    }
 
     return(EOS);		/* end of scan */
     
@@ -0,0 +1,449 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_ParallelScan.c
+ *
+ * Description:
+ *  Morsel-driven parallel scan of a data file. The pages of the file are
+ *  cut into morsels of a few pages; worker threads pull morsels, collect
+ *  the objects of their pages in per-thread output buffers, and emit them
+ *  to a user function. The buffer manager is not thread-safe, so pages
+ *  are fixed and unfixed by the calling (coordinator) thread only. It fixes
+ *  the pages in waves: the list of pages of a wave is read from the file
+ *  map and all its pages are fixed before the workers see any morsel of it,
+ *  and the next wave is fixed while the workers process the current one.
+ *  A file of up to PSCAN_WAVE_PAGES pages is fixed as a whole before the
+ *  workers start.
+ *
+ * Export:
+ *  Four EduOM_ParallelScan(ObjectID*, Four, Four, ParallelScanFn, void*)
+ */
+
+
+#include <stdlib.h>
+#include "EduOM_common.h"
+#include "BfM.h"
+#include "EduOM_Internal.h"
+
+
+
+/*@ Internal Function Prototypes */
+static void *eduom_ParallelScanWorker(void*);
+static Four eduom_ScanMorsel(ParallelScanWorker*, Four, Four);
+static Four eduom_EmitObjects(ParallelScanWorker*);
+static Four eduom_FixWave(ParallelScan*, Four, ShortPageID*);
+static Four eduom_UnfixWave(ParallelScan*, Four);
+
+
+
+/*@================================
+ * EduOM_ParallelScan()
+ *================================*/
+/*
+ * Function: Four EduOM_ParallelScan(ObjectID*, Four, Four, ParallelScanFn, void*)
+ *
+ * Description:
+ *  Scan all the objects of the file with 'nThreads' worker threads pulling
+ *  morsels of 'morselPages' pages (PSCAN_MORSEL_PAGES if 0); every object
+ *  is passed to 'fn' exactly once, on one of the workers, in no particular
+ *  order. The calling thread fixes the pages a wave at a time, the next
+ *  wave while the workers process the morsels of the current one.
+ *  A moved object is passed as its stub (P_MOVED), whose data is the
+ *  ObjectID of the moved data; the moved data itself is not passed.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    eMEMORYALLOCERR_EDUOM
+ *    eNOTSUPPORTED_EDUOM
+ *    a negative value returned by 'fn'
+ *    some errors caused by function calls
+ */
+Four EduOM_ParallelScan(
+    ObjectID  *catObjForFile,	/* IN informations about a data file */
+    Four      nThreads,		/* IN # of worker threads */
+    Four      morselPages,	/* IN # of pages of a morsel; 0 for the default */
+    ParallelScanFn fn,		/* IN function processing the objects */
+    void      *arg)		/* IN argument passed to 'fn' */
+{
+    Four e;			/* error */
+    Four i;			/* index */
+    Four cur;			/* wave being processed */
+    Four eUnfix;		/* error of unfixing a wave */
+    Four nStarted;		/* # of worker threads started */
+    ShortPageID nextPage;	/* next page to fix */
+    sm_CatOverlayForData *catEntry; /* data structure for catalog object access */
+    ParallelScan scan;		/* state shared with the workers */
+    ParallelScanWorker *workers; /* the workers */
+    pthread_t   *threads;	/* threads of the workers */
+
+
+    /*@ parameter checking */
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (nThreads < 1 || nThreads > PSCAN_MAX_THREADS || morselPages < 0 || fn == NULL)
+        ERR(eBADPARAMETER_OM);
+
+    if (morselPages == 0) morselPages = PSCAN_MORSEL_PAGES;
+
+    e = eduom_GetCatalogEntry(catObjForFile, &catEntry);
+    if (e < 0) ERR(e);
+
+    scan.volNo = catEntry->fid.volNo;
+    nextPage = catEntry->firstPage;
+
+    /*@ set up the shared state */
+    scan.morselPages = morselPages;
+    scan.fn = fn;
+    scan.arg = arg;
+    scan.nPages[0] = scan.nPages[1] = 0;
+    scan.wave = 0;
+    scan.nMorsels = scan.nextMorsel = scan.nPending = 0;
+    scan.finished = FALSE;
+    scan.error = eNOERROR;
+
+    scan.pids[0] = (PageID *)malloc(sizeof(PageID) * 2 * PSCAN_WAVE_PAGES);
+    scan.apages[0] = (SlottedPage **)malloc(sizeof(SlottedPage *) * 2 * PSCAN_WAVE_PAGES);
+    workers = (ParallelScanWorker *)malloc(sizeof(ParallelScanWorker) * nThreads);
+    threads = (pthread_t *)malloc(sizeof(pthread_t) * nThreads);
+    if (scan.pids[0] == NULL || scan.apages[0] == NULL || workers == NULL || threads == NULL) {
+        free(scan.pids[0]); free(scan.apages[0]);
+        free(workers); free(threads);
+        ERR(eMEMORYALLOCERR_EDUOM);
+    }
+    scan.pids[1] = scan.pids[0] + PSCAN_WAVE_PAGES;
+    scan.apages[1] = scan.apages[0] + PSCAN_WAVE_PAGES;
+
+    pthread_mutex_init(&scan.mutex, NULL);
+    pthread_cond_init(&scan.startCond, NULL);
+    pthread_cond_init(&scan.doneCond, NULL);
+
+    /*@ fix the first wave, then start the workers */
+    cur = 0;
+    e = eduom_FixWave(&scan, cur, &nextPage);
+
+    for (nStarted = 0; e == eNOERROR && nStarted < nThreads; nStarted++) {
+        workers[nStarted].scan = &scan;
+        workers[nStarted].thread = nStarted;
+        workers[nStarted].nObjects = 0;
+        if (pthread_create(&threads[nStarted], NULL, eduom_ParallelScanWorker, &workers[nStarted]) != 0)
+            break;
+    }
+
+    if (e == eNOERROR && nStarted == 0) e = eMEMORYALLOCERR_EDUOM;
+
+    /*@ publish the waves, fixing each next one while the current one is processed */
+    while (e == eNOERROR && scan.nPages[cur] > 0) {
+        pthread_mutex_lock(&scan.mutex);
+        scan.wave = cur;
+        scan.nMorsels = scan.nPending = (scan.nPages[cur] + morselPages - 1) / morselPages;
+        scan.nextMorsel = 0;
+        pthread_cond_broadcast(&scan.startCond);
+        pthread_mutex_unlock(&scan.mutex);
+
+        if (nextPage != NIL) e = eduom_FixWave(&scan, 1 - cur, &nextPage);
+
+        pthread_mutex_lock(&scan.mutex);
+        while (scan.nPending > 0) pthread_cond_wait(&scan.doneCond, &scan.mutex);
+        if (e == eNOERROR) e = scan.error;
+        pthread_mutex_unlock(&scan.mutex);
+
+        eUnfix = eduom_UnfixWave(&scan, cur);
+        if (eUnfix < 0 && e == eNOERROR) e = eUnfix;
+
+        cur = 1 - cur;
+    }
+
+    /* the pages of a wave fixed but not processed because of an error */
+    eUnfix = eduom_UnfixWave(&scan, cur);
+    if (eUnfix < 0 && e == eNOERROR) e = eUnfix;
+
+    /*@ stop the workers */
+    pthread_mutex_lock(&scan.mutex);
+    scan.finished = TRUE;
+    pthread_cond_broadcast(&scan.startCond);
+    pthread_mutex_unlock(&scan.mutex);
+
+    for (i = 0; i < nStarted; i++) pthread_join(threads[i], NULL);
+
+    pthread_mutex_destroy(&scan.mutex);
+    pthread_cond_destroy(&scan.startCond);
+    pthread_cond_destroy(&scan.doneCond);
+
+    free(scan.pids[0]); free(scan.apages[0]);
+    free(workers); free(threads);
+
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduOM_ParallelScan() */
+
+
+
+/*@================================
+ * eduom_ParallelScanWorker()
+ *================================*/
+/*
+ * Function: static void *eduom_ParallelScanWorker(void*)
+ *
+ * Description:
+ *  Body of a worker thread: take the morsels of the published wave one at
+ *  a time and process them until the scan is finished. After an error the
+ *  remaining morsels are only counted as done.
+ *
+ * Returns:
+ *  NULL
+ */
+static void *eduom_ParallelScanWorker(
+    void      *arg)		/* IN the worker (ParallelScanWorker*) */
+{
+    Four e;			/* error */
+    Four wave;			/* wave of the morsel */
+    Four morsel;		/* morsel taken */
+    ParallelScanWorker *worker = (ParallelScanWorker *)arg;
+    ParallelScan *scan = worker->scan;
+
+
+    pthread_mutex_lock(&scan->mutex);
+
+    while (TRUE) {
+        while (scan->nextMorsel == scan->nMorsels && !scan->finished)
+            pthread_cond_wait(&scan->startCond, &scan->mutex);
+        if (scan->nextMorsel == scan->nMorsels) break;
+
+        wave = scan->wave;
+        morsel = scan->nextMorsel++;
+        e = scan->error;
+        pthread_mutex_unlock(&scan->mutex);
+
+        if (e == eNOERROR) e = eduom_ScanMorsel(worker, wave, morsel);
+
+        pthread_mutex_lock(&scan->mutex);
+        if (e < 0 && scan->error == eNOERROR) scan->error = e;
+        if (--scan->nPending == 0) pthread_cond_signal(&scan->doneCond);
+    }
+
+    pthread_mutex_unlock(&scan->mutex);
+
+    return(NULL);
+
+} /* eduom_ParallelScanWorker() */
+
+
+
+/*@================================
+ * eduom_ScanMorsel()
+ *================================*/
+/*
+ * Function: static Four eduom_ScanMorsel(ParallelScanWorker*, Four, Four)
+ *
+ * Description:
+ *  Collect the objects of the pages of the morsel in the output buffer of
+ *  the worker, emitting them whenever the buffer fills up and at the end of
+ *  the morsel, before its pages can be unfixed.
+ *
+ * Returns:
+ *  error code
+ *    eNOTSUPPORTED_EDUOM
+ *    a negative value returned by the function processing the objects
+ */
+static Four eduom_ScanMorsel(
+    ParallelScanWorker *worker,	/* INOUT the worker */
+    Four      wave,		/* IN wave of the morsel */
+    Four      morsel)		/* IN morsel of the wave */
+{
+    Four e;			/* error */
+    Four i;			/* index */
+    Four last;			/* end of the pages of the morsel */
+    Two  slotNo;		/* slot of the page */
+    SlottedPage *apage;		/* page of the morsel */
+    ParallelScan *scan = worker->scan;
+
+
+    last = (morsel + 1) * scan->morselPages;
+    if (last > scan->nPages[wave]) last = scan->nPages[wave];
+
+    for (i = morsel * scan->morselPages; i < last; i++) {
+        apage = scan->apages[wave][i];
+
+        /* the records of the PAX layout are not objects in the page */
+        if (IS_PAX_PAGE(apage)) return(eNOTSUPPORTED_EDUOM);
+
+        for (slotNo = 0; slotNo < apage->header.nSlots; slotNo++) {
+            if (apage->slot[-slotNo].offset == EMPTYSLOT) continue;
+            if (((Object *)&(apage->data[apage->slot[-slotNo].offset]))->header.properties & P_FORWARDED)
+                continue;
+
+            MAKE_OBJECTID(worker->oids[worker->nObjects], scan->volNo, apage->header.pid.pageNo,
+                          slotNo, apage->slot[-slotNo].unique);
+            worker->objs[worker->nObjects] = (Object *)&(apage->data[apage->slot[-slotNo].offset]);
+
+            if (++worker->nObjects == PSCAN_OUTPUT_BUFFER) {
+                e = eduom_EmitObjects(worker);
+                if (e < 0) return(e);
+            }
+        }
+    }
+
+    return(eduom_EmitObjects(worker));
+
+} /* eduom_ScanMorsel() */
+
+
+
+/*@================================
+ * eduom_EmitObjects()
+ *================================*/
+/*
+ * Function: static Four eduom_EmitObjects(ParallelScanWorker*)
+ *
+ * Description:
+ *  Pass the objects in the output buffer of the worker to the function
+ *  processing them, and empty the buffer.
+ *
+ * Returns:
+ *  error code
+ *    a negative value returned by the function processing the objects
+ */
+static Four eduom_EmitObjects(
+    ParallelScanWorker *worker)	/* INOUT the worker */
+{
+    Four e;			/* error */
+
+
+    if (worker->nObjects == 0) return(eNOERROR);
+
+    e = worker->scan->fn(worker->thread, worker->nObjects, worker->oids, worker->objs, worker->scan->arg);
+    worker->nObjects = 0;
+
+    return((e < 0) ? e : eNOERROR);
+
+} /* eduom_EmitObjects() */
+
+
+
+/*@================================
+ * eduom_FixWave()
+ *================================*/
+/*
+ * Function: static Four eduom_FixWave(ParallelScan*, Four, ShortPageID*)
+ *
+ * Description:
+ *  Fix up to PSCAN_WAVE_PAGES pages of the file starting at '*nextPage',
+ *  following the page list of the file, in the given half of the arrays of
+ *  the scan. On an error the pages already fixed are kept in the wave, to
+ *  be unfixed by eduom_UnfixWave().
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  1) parameter nextPage
+ *     the first page not fixed, NIL at the end of the file
+ */
+static Four eduom_FixWave(
+    ParallelScan *scan,		/* INOUT the scan */
+    Four      wave,		/* IN wave to be fixed */
+    ShortPageID *nextPage)	/* INOUT next page of the file */
+{
+    Four e;			/* error */
+    Four i;			/* index */
+
+
+    for (i = 0; i < PSCAN_WAVE_PAGES && *nextPage != NIL; i++) {
+        MAKE_PAGEID(scan->pids[wave][i], scan->volNo, *nextPage);
+        e = BfM_GetTrain((TrainID *)&scan->pids[wave][i], (char **)&scan->apages[wave][i], PAGE_BUF);
+        if (e < 0) {
+            scan->nPages[wave] = i;
+            ERR(e);
+        }
+        *nextPage = scan->apages[wave][i]->header.nextPage;
+    }
+    scan->nPages[wave] = i;
+
+    return(eNOERROR);
+
+} /* eduom_FixWave() */
+
+
+
+/*@================================
+ * eduom_UnfixWave()
+ *================================*/
+/*
+ * Function: static Four eduom_UnfixWave(ParallelScan*, Four)
+ *
+ * Description:
+ *  Unfix the pages of the wave, which becomes empty.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_UnfixWave(
+    ParallelScan *scan,		/* INOUT the scan */
+    Four      wave)		/* IN wave to be unfixed */
+{
+    Four e;			/* error */
+    Four i;			/* index */
+    Four error = eNOERROR;	/* first error */
+
+
+    for (i = 0; i < scan->nPages[wave]; i++) {
+        e = BfM_FreeTrain((TrainID *)&scan->pids[wave][i], PAGE_BUF);
+        if (e < 0 && error == eNOERROR) error = e;
+    }
+    scan->nPages[wave] = 0;
+
+    return(error);
+
+} /* eduom_UnfixWave() */
@@ -0,0 +1,179 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_PinObject.c
+ *
+ * Description:
+ *  Give read-only access to an object in place. Unlike EduOM_ReadObject(),
+ *  which copies the data into a user buffer, a view points to the data in
+ *  the buffer page, which stays fixed until the view is released; a reader
+ *  looking at a few bytes of the object does not copy the whole object.
+ *
+ * Export:
+ *  Four EduOM_PinObject(ObjectID*, ObjectView*)
+ *  Four EduOM_UnpinObject(ObjectView*)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+
+
+
+/*@================================
+ * EduOM_PinObject()
+ *================================*/
+/*
+ * Function: Four EduOM_PinObject(ObjectID*, ObjectView*)
+ *
+ * Description:
+ *  Make a view of the data of the object 'oid': a pointer to the data in
+ *  the buffer page and its length from the object header. The page stays
+ *  fixed until EduOM_UnpinObject() is called on the view. For a moved
+ *  object the view is of the moved data.
+ *  Fixing the page keeps it in the buffer but does not keep it from being
+ *  changed; the object must not be updated, nor other objects created in
+ *  its page, while the view is held.
+ *  The data of a large object or of a record of the PAX layout is not kept
+ *  contiguous in a page, and has to be read by EduOM_ReadObject().
+ *
+ * Returns:
+ *  error code
+ *    eBADOBJECTID_OM
+ *    eBADPARAMETER_OM
+ *    eNOTSUPPORTED_EDUOM
+ *    some errors caused by function calls
+ *
+ * Side effect:
+ *  1) parameter view
+ *     view of the object
+ */
+Four EduOM_PinObject(
+    ObjectID  *oid,		/* IN object to view */
+    ObjectView *view)		/* OUT view of the object */
+{
+    Four e;			/* error */
+    SlottedPage *apage;		/* pointer to the buffer of the page */
+    Object *obj;		/* pointer to the object in the slotted page */
+    ObjectID movedOid;		/* where the data of a moved object is */
+
+
+    /*@ parameter checking */
+    if (oid == NULL) ERR(eBADOBJECTID_OM);
+
+    if (view == NULL) ERR(eBADPARAMETER_OM);
+
+    MAKE_PAGEID(view->pid, oid->volNo, oid->pageNo);
+
+    e = BfM_GetTrain((TrainID *)&view->pid, (char **)&apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    if (oid->slotNo < 0 || oid->slotNo >= apage->header.nSlots || !IS_VALID_OBJECTID(oid, apage))
+        ERRB1(eBADOBJECTID_OM, &view->pid, PAGE_BUF);
+
+    /* the record of the PAX layout is scattered over the minipages */
+    if (IS_PAX_PAGE(apage)) ERRB1(eNOTSUPPORTED_EDUOM, &view->pid, PAGE_BUF);
+
+    obj = (Object *)&(apage->data[apage->slot[-(oid->slotNo)].offset]);
+
+    if (obj->header.properties & P_MOVED) {
+        memcpy(&movedOid, obj->data, sizeof(ObjectID));
+
+        e = BfM_FreeTrain((TrainID *)&view->pid, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        return(EduOM_PinObject(&movedOid, view));
+    }
+
+    /* the data of a large object is in the leaves of its tree */
+    if (obj->header.properties & P_LRGOBJ) ERRB1(eNOTSUPPORTED_EDUOM, &view->pid, PAGE_BUF);
+
+    view->data = obj->data;
+    view->length = obj->header.length;
+
+    return(eNOERROR);
+
+} /* EduOM_PinObject() */
+
+
+
+/*@================================
+ * EduOM_UnpinObject()
+ *================================*/
+/*
+ * Function: Four EduOM_UnpinObject(ObjectView*)
+ *
+ * Description:
+ *  Release the view; the page holding the data is unfixed, and the data
+ *  must not be used any more.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_UnpinObject(
+    ObjectView *view)		/* INOUT view to release */
+{
+    Four e;			/* error */
+
+
+    /*@ parameter checking */
+    if (view == NULL || view->data == NULL) ERR(eBADPARAMETER_OM);
+
+    view->data = NULL;
+
+    e = BfM_FreeTrain((TrainID *)&view->pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduOM_UnpinObject() */
@@ -75,9 +75,12 @@
  *  the same page which has the current object and  if there  is no previous
  *  object in the same page, find it from the previous page.
  *  If the current object is NULL, return the last object of the file.
+ *  Empty slots are skipped, and so is the data of a moved object, which is
+ *  returned through its stub only.
  *
  * Returns:
- *  error code
+ *  1) eNOERROR, or EOS at the beginning of the file
+ *  2) error code
  *    eBADCATALOGOBJECT_OM
  *    eBADOBJECTID_OM
  *    some errors caused by function calls
@@ -102,11 +105,11 @@ Four EduOM_PrevObject(
     PageNo pageNo;		/* a temporary var for previous page's PageNo */
     SlottedPage *apage,*prevpage;		/* a pointer to the data page */
     Object *obj;		/* a pointer to the Object */
-    SlottedPage *catPage;	/* buffer page containing the catalog object */
     sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
     VolNo volNo;
     SlotNo slotno;
     Unique unique;
+    Boolean fromEnd;		/* start from the last slot of the page */
 
 
     /*@ parameter checking */
@@ -114,53 +117,58 @@ Four EduOM_PrevObject(
     
     if (prevOID == NULL) ERR(eBADOBJECTID_OM);
 
+    e=eduom_GetCatalogEntry(catObjForFile,&catEntry);
+    if(e<0) ERR(e);
+    volNo=catEntry->fid.volNo;
+
     if(curOID==NULL){
-        BfM_GetTrain((TrainID *)catObjForFile,(char**)&catPage,PAGE_BUF);
-        GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile,catPage,catEntry);
-        if(catEntry->firstPage==-1)
-            return(EOS);
+        pageNo=catEntry->lastPage;
+        fromEnd=TRUE;
+    }
+    else{
+        pageNo=curOID->pageNo;
+        i=curOID->slotNo-1;
+        fromEnd=FALSE;
+    }
 
-        pageNo= catEntry->lastPage;
-        volNo=prevOID->volNo;
+    /*@ find the previous slot holding an object, skipping empty slots and moved data */
+    while(pageNo!=NIL){
         MAKE_PAGEID(pid,volNo,pageNo);
-        BfM_GetTrain(&pid,(char**)&apage,PAGE_BUF);
-        i=apage->header.nSlots-1; 
-        unique=apage->slot[-(i)].unique;
+        e=BfM_GetTrain(&pid,(char**)&apage,PAGE_BUF);
+        if(e<0) ERR(e);
 
-        BfM_FreeTrain(catObjForFile,PAGE_BUF);
-        BfM_FreeTrain(&pid,PAGE_BUF);
-    }
-    else{
-        BfM_GetTrain((TrainID *)curOID,(char**)&apage,PAGE_BUF);
-        slotno=curOID->slotNo;
-        if(slotno==0){
-            if(apage->header.prevPage==-1)
-                return(EOS);
-            pageNo= apage->header.prevPage;
-            volNo=curOID->volNo;
-            MAKE_PAGEID(pid,volNo,pageNo);
-            BfM_GetTrain(&pid,(char**)&prevpage,PAGE_BUF);
-            i=prevpage->header.nSlots-1;
-            if(i==-1)
-                return(EOS);
-            unique=prevpage->slot[-(i)].unique;
-            
-            BfM_FreeTrain(curOID,PAGE_BUF);
-            BfM_FreeTrain(&pid,PAGE_BUF);
+        if(fromEnd) i=apage->header.nSlots-1;
+        for(;i>=0;i--){
+            offset=apage->slot[-i].offset;
+            if(offset==EMPTYSLOT) continue;
+            if(IS_PAX_PAGE(apage)) break;
+            obj=(Object *)&(apage->data[offset]);
+            /* the data of a moved object is returned through its stub only */
+            if(!(obj->header.properties&P_FORWARDED)) break;
         }
-        else{
-            pageNo=apage->header.pid.pageNo;
-            volNo=apage->header.pid.volNo;
-            i=slotno-1;
-            BfM_FreeTrain(curOID,PAGE_BUF);
-            unique=apage->slot[-(i)].unique;
+
+        if(i>=0){
+            MAKE_OBJECTID(*prevOID,volNo,pageNo,i,apage->slot[-i].unique);
+            if(objHdr!=NULL){
+                if(IS_PAX_PAGE(apage)){
+                    objHdr->properties=0;
+                    objHdr->tag=0;
+                    objHdr->length=PAX_HDR(apage)->recordLength;
+                }
+                else
+                    *objHdr=obj->header;
+            }
+            e=BfM_FreeTrain(&pid,PAGE_BUF);
+            if(e<0) ERR(e);
+            return(eNOERROR);
         }
+
+        pageNo=apage->header.prevPage;
+        e=BfM_FreeTrain(&pid,PAGE_BUF);
+        if(e<0) ERR(e);
+        fromEnd=TRUE;
     }
-    prevOID->pageNo=pageNo;
-    prevOID->volNo=volNo;
-    prevOID->slotNo=i;
-    prevOID->unique=unique;
 
-    return(EOS);
+    return(EOS);		/* end of scan */
     
 } /* EduOM_PrevObject() */
@@ -0,0 +1,153 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_ProjectScan.c
+ * 
+ * Description :
+ *  EduOM_ProjectScan() scans some columns of the objects of a data file of
+ *  the PAX layout.
+ *
+ * Exports:
+ *  Four EduOM_ProjectScan(ObjectID*, Four, Four*, ProjectScanFn, void*)
+ */
+
+
+#include "EduOM_common.h"
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+
+
+
+/*@================================
+ * EduOM_ProjectScan()
+ *================================*/
+/*
+ * Function: Four EduOM_ProjectScan(ObjectID*, Four, Four*, ProjectScanFn, void*)
+ * 
+ * Description :
+ *  (1) What to do?
+ *  EduOM_ProjectScan() scans the columns 'columns[0..nColumns-1]' of the
+ *  objects of the file of the PAX layout page by page in the order of the
+ *  pages of the file. For each page holding objects, 'fn' is called with
+ *  the # of objects of the page and, for each column asked for, the values
+ *  of the column of those objects in the minipage of the page: the values
+ *  are dense arrays of the width of the column, aligned to
+ *  PAX_MINIPAGE_ALIGN, so 'fn' can process them with simple loops the
+ *  compiler vectorizes. The minipages of the other columns are not read.
+ *  The values of a page are in the order of its records, which is not the
+ *  order of the slots of the objects.
+ *
+ *  (2) How to do?
+ *  a. FOR each page of the file DO
+ *	   IF the page is not of the PAX layout THEN
+ *	       return eNOTSUPPORTED_EDUOM
+ *	   ENDIF
+ *	   call 'fn' with the minipages of the columns
+ *     ENDFOR
+ *  b. Return
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    eNOTSUPPORTED_EDUOM
+ *    a negative value returned by 'fn'
+ *    some errors caused by function calls
+ */
+Four EduOM_ProjectScan(
+    ObjectID  *catObjForFile,	/* IN file to scan */
+    Four      nColumns,		/* IN # of columns to scan */
+    Four      *columns,		/* IN columns to scan */
+    ProjectScanFn fn,		/* IN function processing the columns of a page */
+    void      *arg)		/* IN argument passed to 'fn' */
+{
+    Four        e;		/* error number */
+    Four        i;		/* index variable */
+    char        *values[PAX_MAX_COLUMNS]; /* the minipages of the columns */
+    PageNo      pageNo;		/* page being scanned */
+    PageID      pid;		/* page being scanned */
+    SlottedPage *apage;		/* pointer to the buffer holding the page */
+    PaxPageHdr  *paxHdr;	/* header of the data area of the page */
+    sm_CatOverlayForData *catEntry; /* cached catalog entry of the file */
+
+
+    /*@ parameter checking */
+
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (nColumns < 1 || nColumns > PAX_MAX_COLUMNS || columns == NULL || fn == NULL) ERR(eBADPARAMETER_OM);
+
+    e = eduom_GetCatalogEntry(catObjForFile, &catEntry);
+    if (e < 0) ERR(e);
+
+    for (pageNo = catEntry->firstPage; pageNo != NIL; ) {
+        MAKE_PAGEID(pid, catEntry->fid.volNo, pageNo);
+
+        e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        if (!IS_PAX_PAGE(apage)) ERRB1(eNOTSUPPORTED_EDUOM, &pid, PAGE_BUF);
+
+        paxHdr = PAX_HDR(apage);
+        for (i = 0; i < nColumns; i++) {
+            if (columns[i] < 0 || columns[i] >= paxHdr->nColumns)
+                ERRB1(eBADPARAMETER_OM, &pid, PAGE_BUF);
+            values[i] = &apage->data[paxHdr->offset[columns[i]]];
+        }
+
+        e = (paxHdr->nRecords > 0) ? fn(paxHdr->nRecords, values, arg) : eNOERROR;
+        pageNo = apage->header.nextPage;
+
+        BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+        if (e < 0) ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* EduOM_ProjectScan() */
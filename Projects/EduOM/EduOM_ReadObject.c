@@ -89,7 +89,9 @@
  *  (2) How to do?
  *  a. Read in the slotted page
  *  b. See the object header
- *  c. IF moved object THEN
+ *  c. IF page of the PAX layout THEN
+ *	   gather the data from the minipages of the page
+ *     ELSE IF moved object THEN
  *	   call this routine recursively with the forwarded object's identifier
  *     ELSE 
  *	   IF large object THEN 
@@ -122,6 +124,7 @@ Four EduOM_ReadObject(
     SlottedPage	*apage;		/* pointer to the buffer of the page  */
     Object	*obj;		/* pointer to the object in the slotted page */
     Four	offset;		/* offset of the object in the page */
+    ObjectID	movedOid;	/* where the data of a moved object is */
 
     
     
@@ -137,10 +140,40 @@ Four EduOM_ReadObject(
     pid.pageNo = oid->pageNo;
     pid.volNo = oid->volNo;
     offset = apage->slot[-(oid->slotNo)].offset;
+
+    /* the record of the PAX layout is gathered from the minipages */
+    if(IS_PAX_PAGE(apage)){
+        e=eduom_PaxReadObject(apage, oid->slotNo, start, length, buf);
+        if(e < 0) ERRB1(e, &pid, PAGE_BUF);
+        BfM_FreeTrain(oid,PAGE_BUF);
+        return(e);
+    }
+
     obj = (Object *)&(apage->data[offset]);
-    if(length==REMAINDER){
-        length=strlen(obj->data)-start;
+
+    if(obj->header.properties & P_MOVED){
+        memcpy(&movedOid, obj->data, sizeof(ObjectID));
+        BfM_FreeTrain(oid,PAGE_BUF);
+        return(EduOM_ReadObject(&movedOid, start, length, buf));
     }
+
+    /* the data of a large object is read leaf by leaf; it is never gathered in the page */
+    if(obj->header.properties & P_LRGOBJ){
+        if(start < 0 || start > obj->header.length) ERRB1(eBADSTART_OM, &pid, PAGE_BUF);
+        if(length==REMAINDER || start+length > obj->header.length)
+            length=obj->header.length-start;
+        if(length > 0){
+            e=LOT_ReadObject(&pid, oid->slotNo, start, length, buf);
+            if(e < 0) ERRB1(e, &pid, PAGE_BUF);
+        }
+        BfM_FreeTrain(oid,PAGE_BUF);
+        return(length);
+    }
+
+    /* the length comes from the header; the data is not a string */
+    if(start < 0 || start > obj->header.length) ERRB1(eBADSTART_OM, &pid, PAGE_BUF);
+    if(length==REMAINDER || start+length > obj->header.length)
+        length=obj->header.length-start;
     memcpy(buf,obj->data+start,length);
     BfM_FreeTrain(oid,PAGE_BUF);
 
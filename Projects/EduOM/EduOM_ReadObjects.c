@@ -0,0 +1,251 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_ReadObjects.c
+ * 
+ * Description : 
+ *  EduOM_ReadObjects() reads many objects at once, visiting each page once.
+ *
+ * Exports:
+ *  Four EduOM_ReadObjects(ObjectID*, Four, char**, Four*)
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "EduOM_common.h"
+#include "BfM.h"		/* for the buffer manager call */
+#include "LOT.h"		/* for the large object manager call */
+#include "EduOM_Internal.h"
+#include "EduOM.h"
+
+
+
+/*@ Internal Function Prototypes */
+static int eduom_ComparePages(const void*, const void*);
+
+
+
+/*@================================
+ * EduOM_ReadObjects()
+ *================================*/
+/*
+ * Function: Four EduOM_ReadObjects(ObjectID*, Four, char**, Four*)
+ * 
+ * Description : 
+ *  Read the objects oids[0..nObjects-1] into the user buffers bufs[i]; the
+ *  first lengths[i] bytes of the i-th object are read, or the whole object
+ *  if lengths[i] is REMAINDER (in this case we assume bufs[i] can
+ *  accomadate the object).
+ *  The objects are sorted by the page holding them, so every page is fixed
+ *  once however many of the objects it holds, and the pages are visited in
+ *  ascending order so that the reads reaching the disk are as sequential
+ *  as possible; the results are returned in the original order.
+ *
+ * Returns:
+ *  error code
+ *    eBADOBJECTID_OM
+ *    eBADLENGTH_OM
+ *    eBADUSERBUF_OM
+ *    eMEMORYALLOCERR_EDUOM
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  1) parameter bufs
+ *     bufs[i] holds the data read from the i-th object
+ *  2) parameter lengths
+ *     lengths[i] is set to the number of bytes actually read
+ */
+Four EduOM_ReadObjects(
+    ObjectID 	*oids,		/* IN objects to read */
+    Four     	nObjects,	/* IN # of objects to read */
+    char     	**bufs,		/* OUT user buffers to return the read data */
+    Four     	*lengths)	/* INOUT amount of data to read / amount read */
+{
+    Four     	e;              /* error code */
+    Four     	i;              /* index variable */
+    Four     	k;              /* index of an object in 'oids' */
+    ObjectID    **sorted;	/* the objects sorted by page */
+    PageID 	pid;		/* page currently fixed */
+    SlottedPage	*apage;		/* pointer to the buffer of the page  */
+    Object	*obj;		/* pointer to the object in the slotted page */
+    ObjectID	movedOid;	/* where the data of a moved object is */
+
+
+    /*@ check parameters */
+
+    if (nObjects < 0) ERR(eBADLENGTH_OM);
+
+    if (nObjects == 0) return(eNOERROR);
+
+    if (oids == NULL) ERR(eBADOBJECTID_OM);
+
+    if (bufs == NULL || lengths == NULL) ERR(eBADUSERBUF_OM);
+
+    for (i = 0; i < nObjects; i++) {
+        if (lengths[i] < 0 && lengths[i] != REMAINDER) ERR(eBADLENGTH_OM);
+
+        if (bufs[i] == NULL) ERR(eBADUSERBUF_OM);
+    }
+
+    /*@ group the objects by page */
+    sorted = (ObjectID **)malloc(sizeof(ObjectID *) * nObjects);
+    if (sorted == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+
+    for (i = 0; i < nObjects; i++) sorted[i] = &oids[i];
+    qsort(sorted, nObjects, sizeof(ObjectID *), eduom_ComparePages);
+
+    /*@ copy the objects out, fixing each page once */
+    for (i = 0; i < nObjects; i++) {
+        k = sorted[i] - oids;
+
+        if (i == 0 || sorted[i]->volNo != pid.volNo || sorted[i]->pageNo != pid.pageNo) {
+            if (i > 0) {
+                e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+                if (e < 0) {
+                    free(sorted);
+                    ERR(e);
+                }
+            }
+
+            MAKE_PAGEID(pid, sorted[i]->volNo, sorted[i]->pageNo);
+            e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+            if (e < 0) {
+                free(sorted);
+                ERR(e);
+            }
+        }
+
+        if (sorted[i]->slotNo < 0 || sorted[i]->slotNo >= apage->header.nSlots ||
+            !IS_VALID_OBJECTID(sorted[i], apage)) {
+            free(sorted);
+            ERRB1(eBADOBJECTID_OM, &pid, PAGE_BUF);
+        }
+
+        if (IS_PAX_PAGE(apage)) {
+            e = eduom_PaxReadObject(apage, sorted[i]->slotNo, 0, lengths[k], bufs[k]);
+            if (e < 0) {
+                free(sorted);
+                ERRB1(e, &pid, PAGE_BUF);
+            }
+            lengths[k] = e;
+            continue;
+        }
+
+        obj = (Object *)&(apage->data[apage->slot[-(sorted[i]->slotNo)].offset]);
+
+        /* a moved object costs a fix of the page its data is on */
+        if (obj->header.properties & P_MOVED) {
+            memcpy(&movedOid, obj->data, sizeof(ObjectID));
+            e = EduOM_ReadObject(&movedOid, 0, lengths[k], bufs[k]);
+            if (e < 0) {
+                free(sorted);
+                ERRB1(e, &pid, PAGE_BUF);
+            }
+            lengths[k] = e;
+            continue;
+        }
+
+        if (lengths[k] == REMAINDER || lengths[k] > obj->header.length)
+            lengths[k] = obj->header.length;
+
+        if (obj->header.properties & P_LRGOBJ) {
+            if (lengths[k] > 0) {
+                e = LOT_ReadObject(&pid, sorted[i]->slotNo, 0, lengths[k], bufs[k]);
+                if (e < 0) {
+                    free(sorted);
+                    ERRB1(e, &pid, PAGE_BUF);
+                }
+            }
+        }
+        else
+            memcpy(bufs[k], obj->data, lengths[k]);
+    }
+
+    free(sorted);
+
+    e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+    
+} /* EduOM_ReadObjects() */
+
+
+
+/*@================================
+ * eduom_ComparePages()
+ *================================*/
+/*
+ * Function: static int eduom_ComparePages(const void*, const void*)
+ * 
+ * Description : 
+ *  qsort() comparison of two pointers into the array of objects to read:
+ *  by volume, by page, and then by the position in the array so that the
+ *  objects on a page are read in their original order.
+ *
+ * Returns:
+ *  negative, zero, or positive as the first comes before, is, or comes
+ *  after the second
+ */
+static int eduom_ComparePages(
+    const void	*a,		/* IN pointer to a pointer to an object */
+    const void	*b)		/* IN pointer to a pointer to an object */
+{
+    ObjectID    *x = *(ObjectID **)a;
+    ObjectID    *y = *(ObjectID **)b;
+
+
+    if (x->volNo != y->volNo) return((x->volNo < y->volNo) ? -1 : 1);
+    if (x->pageNo != y->pageNo) return((x->pageNo < y->pageNo) ? -1 : 1);
+    if (x != y) return((x < y) ? -1 : 1);
+
+    return(0);
+
+} /* eduom_ComparePages() */
@@ -0,0 +1,633 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_Scan.c
+ *
+ * Description:
+ *  Scan the objects of a data file a page at a time. Unlike a loop of
+ *  EduOM_NextObject() calls, which fixes the catalog and the current page
+ *  again for every object, a scan cursor keeps the page being scanned
+ *  fixed and returns all the objects of the page at once.
+ *  A filter can be pushed down into the scan: the objects are tested in
+ *  the fixed page, the terms of the filter over all the objects of the page
+ *  at once, and only the objects passing it are returned.
+ *
+ * Export:
+ *  Four EduOM_OpenScan(ObjectID*, ObjectScanCursor*)
+ *  Four EduOM_NextObjects(ObjectScanCursor*, Four, ObjectID*, Object**)
+ *  Four EduOM_NextMatchingObjects(ObjectScanCursor*, ObjectFilter*, Four, ObjectID*, Object**)
+ *  Four EduOM_CloseScan(ObjectScanCursor*)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "BfM.h"
+#include "LOT.h"
+#include "EduOM_Internal.h"
+#include "EduOM.h"
+
+
+/* maximum # of slots of a page */
+#define SCAN_MAX_SLOTS (PAGESIZE / sizeof(SlottedPageSlot))
+
+
+
+/*@ Internal Function Prototypes */
+static Four eduom_ScanNextPage(ObjectScanCursor*);
+static Four eduom_FilterFetch(ObjectScanCursor*, Two, FilterTerm*, Four*);
+static Four eduom_FilterValues(ObjectScanCursor*, FilterTerm*, Four, Two*, Four*, char*);
+static void eduom_FilterCompare(FilterTerm*, Four, Four*, char*);
+
+
+
+/*@================================
+ * EduOM_OpenScan()
+ *================================*/
+/*
+ * Function: Four EduOM_OpenScan(ObjectID*, ObjectScanCursor*)
+ *
+ * Description:
+ *  Open a scan cursor positioned before the first object of the file.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ *
+ * Side effect:
+ *  1) parameter cursor
+ *     cursor is initialized
+ */
+Four EduOM_OpenScan(
+    ObjectID  *catObjForFile,	/* IN informations about a data file */
+    ObjectScanCursor *cursor)	/* OUT cursor to open */
+{
+    Four e;			/* error */
+    sm_CatOverlayForData *catEntry; /* cached catalog entry of the file */
+
+
+    /*@ parameter checking */
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (cursor == NULL) ERR(eBADPARAMETER_OM);
+
+    e = eduom_GetCatalogEntry(catObjForFile, &catEntry);
+    if (e < 0) ERR(e);
+
+    cursor->volNo = catEntry->fid.volNo;
+    cursor->nextPage = catEntry->firstPage;
+    cursor->apage = NULL;
+    cursor->slotNo = 0;
+
+    return(eNOERROR);
+
+} /* EduOM_OpenScan() */
+
+
+
+/*@================================
+ * EduOM_NextObjects()
+ *================================*/
+/*
+ * Function: Four EduOM_NextObjects(ObjectScanCursor*, Four, ObjectID*, Object**)
+ *
+ * Description:
+ *  Return the next objects of the scan, at most 'maxObjects' and all from
+ *  the same page: their identifiers in 'oids' and, if 'objs' is not NULL,
+ *  pointers to the objects (header and data) in the buffer page. The page
+ *  stays fixed until the next call or EduOM_CloseScan(), so the objects can
+ *  be used in place until then; pages holding no object are skipped.
+ *  A moved object is returned as its stub (P_MOVED), whose data is the
+ *  ObjectID of the moved data; the moved data itself is not returned.
+ *  The objects of a page of the PAX layout are returned only by their
+ *  identifiers.
+ *
+ * Returns:
+ *  1) # of objects returned; 0 at the end of the scan
+ *  2) Error codes: Negative value means error code.
+ *     eBADPARAMETER_OM
+ *     eBADUSERBUF_OM
+ *     eNOTSUPPORTED_EDUOM
+ *     some errors caused by function calls
+ *
+ * Side effect:
+ *  1) parameter oids
+ *     oids[0..n-1] are filled with the identifiers of the objects
+ *  2) parameter objs
+ *     objs[0..n-1] point to the objects in the buffer page
+ */
+Four EduOM_NextObjects(
+    ObjectScanCursor *cursor,	/* INOUT scan cursor */
+    Four      maxObjects,	/* IN size of 'oids' and 'objs' */
+    ObjectID  *oids,		/* OUT identifiers of the objects */
+    Object    **objs)		/* OUT the objects in the buffer page; may be NULL */
+{
+    Four e;			/* error */
+    Four n;			/* # of objects returned */
+    SlottedPage *apage;		/* page being scanned */
+
+
+    /*@ parameter checking */
+    if (cursor == NULL || maxObjects < 1) ERR(eBADPARAMETER_OM);
+
+    if (oids == NULL) ERR(eBADUSERBUF_OM);
+
+    for (n = 0; n == 0; ) {
+
+        /*@ move to the next page when the current one is used up */
+        if (cursor->apage == NULL || cursor->slotNo >= cursor->apage->header.nSlots) {
+            e = eduom_ScanNextPage(cursor);
+            if (e < 0) ERR(e);
+
+            if (e == FALSE) return(0);	/* end of scan */
+        }
+
+        apage = cursor->apage;
+
+        /* the records of the PAX layout are not objects in the page */
+        if (IS_PAX_PAGE(apage) && objs != NULL) ERR(eNOTSUPPORTED_EDUOM);
+
+        for ( ; cursor->slotNo < apage->header.nSlots && n < maxObjects; cursor->slotNo++) {
+            if (apage->slot[-(cursor->slotNo)].offset == EMPTYSLOT) continue;
+            if (!IS_PAX_PAGE(apage) &&
+                ((Object *)&(apage->data[apage->slot[-(cursor->slotNo)].offset]))->header.properties & P_FORWARDED)
+                continue;
+
+            MAKE_OBJECTID(oids[n], cursor->volNo, cursor->pid.pageNo, cursor->slotNo,
+                          apage->slot[-(cursor->slotNo)].unique);
+            if (objs != NULL)
+                objs[n] = (Object *)&(apage->data[apage->slot[-(cursor->slotNo)].offset]);
+            n++;
+        }
+    }
+
+    return(n);
+
+} /* EduOM_NextObjects() */
+
+
+
+/*@================================
+ * EduOM_NextMatchingObjects()
+ *================================*/
+/*
+ * Function: Four EduOM_NextMatchingObjects(ObjectScanCursor*, ObjectFilter*, Four, ObjectID*, Object**)
+ *
+ * Description:
+ *  (1) What to do?
+ *  Return the next objects of the scan passing 'filter', as
+ *  EduOM_NextObjects() does for all the objects: at most 'maxObjects', all
+ *  from the same page, which stays fixed until the next call. The objects
+ *  are tested in the buffer page without being copied. A term is evaluated
+ *  over all the objects of the page left by the terms before it, first
+ *  gathering their values into an array and then comparing the array with
+ *  the constant in one loop the compiler vectorizes; 'fn' is called only on
+ *  the objects satisfying all the terms.
+ *  A moved object is tested on its moved data and returned as its stub; a
+ *  large object is tested on its data in the leaves of its tree. The
+ *  objects of a page of the PAX layout are returned only by their
+ *  identifiers, and 'fn' is called with NULL for them.
+ *
+ *  (2) How to do?
+ *  a. DO
+ *	   IF the current page is used up THEN
+ *	       fix the next page of the file
+ *	   ENDIF
+ *	   Collect the slots of the objects left in the page as candidates
+ *	   FOR each term of the filter DO
+ *	       gather the values of the candidates and compare them
+ *	       drop the candidates failing the term
+ *	   ENDFOR
+ *	   Return the candidates for which 'fn' returns TRUE
+ *     WHILE no object is returned and the scan is not at the end
+ *  b. Return
+ *  When 'maxObjects' objects are returned before the candidates of the page
+ *  are used up, the rest of the page is tested again by the next call, so
+ *  'maxObjects' is better not less than the # of objects of a page.
+ *
+ * Returns:
+ *  1) # of objects returned; 0 at the end of the scan
+ *  2) Error codes: Negative value means error code.
+ *     eBADPARAMETER_OM
+ *     eBADUSERBUF_OM
+ *     eNOTSUPPORTED_EDUOM
+ *     some errors caused by function calls
+ *
+ * Side effect:
+ *  1) parameter oids
+ *     oids[0..n-1] are filled with the identifiers of the objects
+ *  2) parameter objs
+ *     objs[0..n-1] point to the objects in the buffer page
+ */
+Four EduOM_NextMatchingObjects(
+    ObjectScanCursor *cursor,	/* INOUT scan cursor */
+    ObjectFilter *filter,	/* IN filter of the objects */
+    Four      maxObjects,	/* IN size of 'oids' and 'objs' */
+    ObjectID  *oids,		/* OUT identifiers of the objects */
+    Object    **objs)		/* OUT the objects in the buffer page; may be NULL */
+{
+    Four e;			/* error */
+    Four n;			/* # of objects returned */
+    Four i, j, k;		/* index variables */
+    Four nCand;			/* # of candidates */
+    Two cand[SCAN_MAX_SLOTS];	/* slots of the candidates */
+    Four values[SCAN_MAX_SLOTS]; /* values of the candidates for a term */
+    char keep[SCAN_MAX_SLOTS];	/* whether each candidate satisfies the term */
+    FilterTerm *term;		/* term being evaluated */
+    SlottedPage *apage;		/* page being scanned */
+    Object *obj;		/* candidate in the page */
+    ObjectID oid;		/* identifier of the candidate */
+
+
+    /*@ parameter checking */
+    if (cursor == NULL || maxObjects < 1) ERR(eBADPARAMETER_OM);
+
+    if (oids == NULL) ERR(eBADUSERBUF_OM);
+
+    if (filter == NULL || filter->nTerms < 0 || filter->nTerms > FILTER_MAX_TERMS) ERR(eBADPARAMETER_OM);
+
+    for (i = 0; i < filter->nTerms; i++) {
+        term = &filter->terms[i];
+        if (term->offset < 0 || term->type < SM_SHORT || term->type > SM_LONG ||
+            term->op < SM_EQ || term->op > SM_NE)
+            ERR(eBADPARAMETER_OM);
+    }
+
+    for (n = 0; n == 0; ) {
+
+        /*@ move to the next page when the current one is used up */
+        if (cursor->apage == NULL || cursor->slotNo >= cursor->apage->header.nSlots) {
+            e = eduom_ScanNextPage(cursor);
+            if (e < 0) ERR(e);
+
+            if (e == FALSE) return(0);	/* end of scan */
+        }
+
+        apage = cursor->apage;
+
+        /* the records of the PAX layout are not objects in the page */
+        if (IS_PAX_PAGE(apage) && objs != NULL) ERR(eNOTSUPPORTED_EDUOM);
+
+        /*@ collect the candidates */
+        for (nCand = 0, i = cursor->slotNo; i < apage->header.nSlots; i++) {
+            if (apage->slot[-i].offset == EMPTYSLOT) continue;
+            if (!IS_PAX_PAGE(apage) &&
+                ((Object *)&(apage->data[apage->slot[-i].offset]))->header.properties & P_FORWARDED)
+                continue;
+
+            cand[nCand++] = i;
+        }
+
+        /*@ evaluate the terms over all the candidates at once */
+        for (i = 0; i < filter->nTerms && nCand > 0; i++) {
+            term = &filter->terms[i];
+
+            e = eduom_FilterValues(cursor, term, nCand, cand, values, keep);
+            if (e < 0) ERR(e);
+
+            eduom_FilterCompare(term, nCand, values, keep);
+
+            for (j = k = 0; k < nCand; k++)
+                if (keep[k]) cand[j++] = cand[k];
+            nCand = j;
+        }
+
+        /*@ return the candidates passing 'fn' */
+        for (i = 0; i < nCand && n < maxObjects; i++) {
+            MAKE_OBJECTID(oid, cursor->volNo, cursor->pid.pageNo, cand[i],
+                          apage->slot[-cand[i]].unique);
+            obj = IS_PAX_PAGE(apage) ? NULL : (Object *)&(apage->data[apage->slot[-cand[i]].offset]);
+
+            if (filter->fn != NULL && !filter->fn(&oid, obj, filter->arg)) continue;
+
+            oids[n] = oid;
+            if (objs != NULL) objs[n] = obj;
+            n++;
+        }
+
+        cursor->slotNo = (i < nCand) ? cand[i] : apage->header.nSlots;
+    }
+
+    return(n);
+
+} /* EduOM_NextMatchingObjects() */
+
+
+
+/*@================================
+ * EduOM_CloseScan()
+ *================================*/
+/*
+ * Function: Four EduOM_CloseScan(ObjectScanCursor*)
+ *
+ * Description:
+ *  Close the scan cursor, unfixing the page being scanned.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_CloseScan(
+    ObjectScanCursor *cursor)	/* INOUT cursor to close */
+{
+    Four e;			/* error */
+
+
+    /*@ parameter checking */
+    if (cursor == NULL) ERR(eBADPARAMETER_OM);
+
+    if (cursor->apage != NULL) {
+        e = BfM_FreeTrain((TrainID *)&cursor->pid, PAGE_BUF);
+        cursor->apage = NULL;
+        if (e < 0) ERR(e);
+    }
+
+    cursor->nextPage = NIL;
+
+    return(eNOERROR);
+
+} /* EduOM_CloseScan() */
+
+
+
+/*@================================
+ * eduom_ScanNextPage()
+ *================================*/
+/*
+ * Function: static Four eduom_ScanNextPage(ObjectScanCursor*)
+ *
+ * Description:
+ *  Unfix the page being scanned, if any, and fix the next page of the file.
+ *
+ * Returns:
+ *  1) TRUE if the next page is fixed; FALSE at the end of the file
+ *  2) Error codes: Negative value means error code.
+ *     some errors caused by function calls
+ */
+static Four eduom_ScanNextPage(
+    ObjectScanCursor *cursor)	/* INOUT scan cursor */
+{
+    Four e;			/* error */
+
+
+    if (cursor->apage != NULL) {
+        e = BfM_FreeTrain((TrainID *)&cursor->pid, PAGE_BUF);
+        cursor->apage = NULL;
+        if (e < 0) ERR(e);
+    }
+
+    if (cursor->nextPage == NIL) return(FALSE);
+
+    MAKE_PAGEID(cursor->pid, cursor->volNo, cursor->nextPage);
+    e = BfM_GetTrain((TrainID *)&cursor->pid, (char **)&cursor->apage, PAGE_BUF);
+    if (e < 0) {
+        cursor->apage = NULL;
+        ERR(e);
+    }
+
+    cursor->nextPage = cursor->apage->header.nextPage;
+    cursor->slotNo = 0;
+
+    return(TRUE);
+
+} /* eduom_ScanNextPage() */
+
+
+
+/*@================================
+ * eduom_FilterValues()
+ *================================*/
+/*
+ * Function: static Four eduom_FilterValues(ObjectScanCursor*, FilterTerm*, Four, Two*, Four*, char*)
+ *
+ * Description:
+ *  Gather the values of the term 'term' of the candidates 'cand' of the
+ *  page being scanned into 'values'; 'keep' tells whether each candidate
+ *  is long enough to hold the value. The values of the objects in the page
+ *  are taken in place; those of the others are fetched one by one.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_FilterValues(
+    ObjectScanCursor *cursor,	/* IN scan cursor */
+    FilterTerm *term,		/* IN term to evaluate */
+    Four      nCand,		/* IN # of candidates */
+    Two       *cand,		/* IN slots of the candidates */
+    Four      *values,		/* OUT values of the candidates */
+    char      *keep)		/* OUT whether each candidate holds the value */
+{
+    Four e;			/* error */
+    Four i;			/* index variable */
+    Four end;			/* end of the value in the data */
+    Two shortValue;		/* value of SM_SHORT */
+    SlottedPage *apage = cursor->apage; /* page being scanned */
+    Object *obj;		/* candidate in the page */
+
+
+    end = term->offset + (term->type == SM_SHORT ? SM_SHORT_SIZE : SM_INT_SIZE);
+
+    for (i = 0; i < nCand; i++) {
+        if (!IS_PAX_PAGE(apage)) {
+            obj = (Object *)&(apage->data[apage->slot[-cand[i]].offset]);
+
+            if (!(obj->header.properties & (P_MOVED | P_LRGOBJ))) {
+                values[i] = 0;
+                keep[i] = (end <= obj->header.length);
+                if (keep[i] && term->type == SM_SHORT) {
+                    memcpy(&shortValue, &obj->data[term->offset], SM_SHORT_SIZE);
+                    values[i] = shortValue;
+                }
+                else if (keep[i])
+                    memcpy(&values[i], &obj->data[term->offset], SM_INT_SIZE);
+                continue;
+            }
+        }
+
+        e = eduom_FilterFetch(cursor, cand[i], term, &values[i]);
+        if (e < 0) ERR(e);
+
+        keep[i] = (char)e;
+    }
+
+    return(eNOERROR);
+
+} /* eduom_FilterValues() */
+
+
+
+/*@================================
+ * eduom_FilterFetch()
+ *================================*/
+/*
+ * Function: static Four eduom_FilterFetch(ObjectScanCursor*, Two, FilterTerm*, Four*)
+ *
+ * Description:
+ *  Fetch the value of the term 'term' of the object of the slot 'slotNo' of
+ *  the page being scanned whose data is not in place: a moved object, a
+ *  large object, or a record of the PAX layout.
+ *
+ * Returns:
+ *  1) TRUE if the value is fetched; FALSE if the object is too short
+ *  2) Error codes: Negative value means error code.
+ *     some errors caused by function calls
+ */
+static Four eduom_FilterFetch(
+    ObjectScanCursor *cursor,	/* IN scan cursor */
+    Two       slotNo,		/* IN slot of the object */
+    FilterTerm *term,		/* IN term to evaluate */
+    Four      *value)		/* OUT value of the object */
+{
+    Four e;			/* error */
+    Four size;			/* size of the value */
+    char buf[SM_INT_SIZE];	/* bytes of the value */
+    Two shortValue;		/* value of SM_SHORT */
+    SlottedPage *apage = cursor->apage; /* page being scanned */
+    Object *obj;		/* the object in the page */
+    ObjectID movedOid;		/* where the data of a moved object is */
+    ObjectView view;		/* view of the moved data */
+
+
+    size = (term->type == SM_SHORT) ? SM_SHORT_SIZE : SM_INT_SIZE;
+
+    if (IS_PAX_PAGE(apage)) {
+        if (term->offset + size > PAX_HDR(apage)->recordLength) return(FALSE);
+
+        e = eduom_PaxReadObject(apage, slotNo, term->offset, size, buf);
+        if (e < 0) ERR(e);
+    }
+    else {
+        obj = (Object *)&(apage->data[apage->slot[-slotNo].offset]);
+
+        if (obj->header.properties & P_MOVED) {
+            /* the moved data is a small object; it never becomes large */
+            memcpy(&movedOid, obj->data, sizeof(ObjectID));
+
+            e = EduOM_PinObject(&movedOid, &view);
+            if (e < 0) ERR(e);
+
+            if (term->offset + size <= view.length) memcpy(buf, &view.data[term->offset], size);
+            else size = 0;
+
+            e = EduOM_UnpinObject(&view);
+            if (e < 0) ERR(e);
+
+            if (size == 0) return(FALSE);
+        }
+        else {
+            if (term->offset + size > obj->header.length) return(FALSE);
+
+            e = LOT_ReadObject(&cursor->pid, slotNo, term->offset, size, buf);
+            if (e < 0) ERR(e);
+        }
+    }
+
+    if (term->type == SM_SHORT) {
+        memcpy(&shortValue, buf, SM_SHORT_SIZE);
+        *value = shortValue;
+    }
+    else
+        memcpy(value, buf, SM_INT_SIZE);
+
+    return(TRUE);
+
+} /* eduom_FilterFetch() */
+
+
+
+/*@================================
+ * eduom_FilterCompare()
+ *================================*/
+/*
+ * Function: static void eduom_FilterCompare(FilterTerm*, Four, Four*, char*)
+ *
+ * Description:
+ *  Compare the values of the candidates with the constant of the term, and
+ *  clear 'keep' of those failing it. Each operator is a loop of its own
+ *  over the arrays, which the compiler vectorizes.
+ *
+ * Returns:
+ *  None
+ */
+static void eduom_FilterCompare(
+    FilterTerm *term,		/* IN term to evaluate */
+    Four      nCand,		/* IN # of candidates */
+    Four      *values,		/* IN values of the candidates */
+    char      *keep)		/* INOUT whether each candidate satisfies the term */
+{
+    Four i;			/* index variable */
+    Four c = term->constant;	/* constant of the term */
+
+
+    switch (term->op) {
+      case SM_EQ:
+        for (i = 0; i < nCand; i++) keep[i] &= (values[i] == c);
+        break;
+      case SM_LT:
+        for (i = 0; i < nCand; i++) keep[i] &= (values[i] < c);
+        break;
+      case SM_LE:
+        for (i = 0; i < nCand; i++) keep[i] &= (values[i] <= c);
+        break;
+      case SM_GT:
+        for (i = 0; i < nCand; i++) keep[i] &= (values[i] > c);
+        break;
+      case SM_GE:
+        for (i = 0; i < nCand; i++) keep[i] &= (values[i] >= c);
+        break;
+      case SM_NE:
+        for (i = 0; i < nCand; i++) keep[i] &= (values[i] != c);
+        break;
+    }
+
+} /* eduom_FilterCompare() */
@@ -0,0 +1,154 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_SetPaxLayout.c
+ * 
+ * Description :
+ *  EduOM_SetPaxLayout() makes an empty data file keep its objects in the
+ *  PAX layout.
+ *
+ * Exports:
+ *  Four EduOM_SetPaxLayout(ObjectID*, Four, Four*)
+ */
+
+
+#include "EduOM_common.h"
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+
+
+
+/*@================================
+ * EduOM_SetPaxLayout()
+ *================================*/
+/*
+ * Function: Four EduOM_SetPaxLayout(ObjectID*, Four, Four*)
+ * 
+ * Description :
+ *  (1) What to do?
+ *  EduOM_SetPaxLayout() makes the empty data file keep its objects in the
+ *  PAX layout: every object of the file is a record of 'nColumns' columns
+ *  of the given fixed widths, whose length is the sum of the widths, and a
+ *  page keeps the values of each column together in a minipage of its own.
+ *  The objects are created, read, written, and destroyed through the same
+ *  ObjectIDs and interface functions as the objects of slotted pages;
+ *  EduOM_ProjectScan() reads only the minipages of the columns asked for.
+ *  The objects have no tag, cannot change their length, and are never
+ *  large; EduOM_AppendToObject() and EduOM_TruncateObject() are not
+ *  supported, and EduOM_NextObjects() and EduOM_ParallelScan() cannot
+ *  return them in place.
+ *
+ *  (2) How to do?
+ *  a. Check the file has no object
+ *  b. Format the first page of the file as a page of the PAX layout; the
+ *     pages allocated later copy the layout from their neighbors
+ *  c. Return
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    eBADLENGTH_OM
+ *    eFILENOTEMPTY_EDUOM
+ *    some errors caused by function calls
+ */
+Four EduOM_SetPaxLayout(
+    ObjectID  *catObjForFile,	/* IN file to lay out */
+    Four      nColumns,		/* IN # of columns of a record */
+    Four      *widths)		/* IN width of each column */
+{
+    Four        e;		/* error number */
+    Four        i;		/* index variable */
+    Two         paxWidths[PAX_MAX_COLUMNS]; /* width of each column */
+    PageID      pid;		/* first page of the file */
+    SlottedPage *apage;		/* pointer to the buffer holding the page */
+    sm_CatOverlayForData *catEntry; /* cached catalog entry of the file */
+
+
+    /*@ parameter checking */
+
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (nColumns < 1 || nColumns > PAX_MAX_COLUMNS || widths == NULL) ERR(eBADPARAMETER_OM);
+
+    for (i = 0; i < nColumns; i++) {
+        if (widths[i] < 1 || widths[i] > LRGOBJ_THRESHOLD) ERR(eBADLENGTH_OM);
+        paxWidths[i] = widths[i];
+    }
+
+    /* pages may have been added behind the cache, so the entry is read again */
+    eduom_InvalidateCatalogEntry(catObjForFile);
+
+    e = eduom_GetCatalogEntry(catObjForFile, &catEntry);
+    if (e < 0) ERR(e);
+
+    /*@ the file must have no object */
+    if (catEntry->firstPage != catEntry->lastPage) ERR(eFILENOTEMPTY_EDUOM);
+
+    MAKE_PAGEID(pid, catEntry->fid.volNo, catEntry->firstPage);
+
+    e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    for (i = 0; i < apage->header.nSlots; i++)
+        if (apage->slot[-i].offset != EMPTYSLOT) ERRB1(eFILENOTEMPTY_EDUOM, &pid, PAGE_BUF);
+
+    /*@ format the first page */
+    e = om_RemoveFromAvailSpaceList(catObjForFile, &pid, apage);
+    if (e >= 0) e = eduom_PaxFormatPage(apage, nColumns, paxWidths);
+    if (e >= 0) e = BfM_SetDirty((TrainID *)&pid, PAGE_BUF);
+    if (e >= 0) e = eduom_FsmUpdate(catObjForFile, catEntry, &pid, SP_FREE(apage));
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduOM_SetPaxLayout() */
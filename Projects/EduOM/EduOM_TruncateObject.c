@@ -0,0 +1,197 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_TruncateObject.c
+ * 
+ * Description :
+ *  EduOM_TruncateObject() cuts off the tail of an object.
+ *
+ * Exports:
+ *  Four EduOM_TruncateObject(ObjectID*, ObjectID*, Four, Pool*, DeallocListElem*)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "BfM.h"		/* for the buffer manager call */
+#include "LOT.h"		/* for the large object manager call */
+#include "EduOM_Internal.h"
+
+
+
+/*@================================
+ * EduOM_TruncateObject()
+ *================================*/
+/*
+ * Function: Four EduOM_TruncateObject(ObjectID*, ObjectID*, Four, Pool*, DeallocListElem*)
+ * 
+ * Description :
+ *  (1) What to do?
+ *  EduOM_TruncateObject() shortens the object 'oid' to its first
+ *  'newLength' bytes. The space freed from a small object is given back to
+ *  its page; the trains of a large object which are no longer needed are
+ *  put into the dealloc list.
+ *
+ *  (2) How to do?
+ *  a. Read in the slotted page
+ *  b. IF moved object THEN
+ *	   call this routine recursively with the moved data's identifier
+ *     ENDIF
+ *     Remove this page from the 'availSpaceList'
+ *  c. IF large object THEN
+ *	   call the large object manager's LOT_DeleteFromObject() for the tail
+ *     ELSE
+ *	   give back the tail to the page: to 'freeStart' if the object is at
+ *	   the end of the data area, to 'unused' otherwise
+ *     ENDIF
+ *  d. Update the length of the object
+ *  e. Put this page into the proper 'availSpaceList' and record its free
+ *     space in the free-space map of the file
+ *  f. Return
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADOBJECTID_OM
+ *    eBADLENGTH_OM
+ *    eNOTSUPPORTED_EDUOM
+ *    some errors caused by function calls
+ */
+Four EduOM_TruncateObject(
+    ObjectID  *catObjForFile,	/* IN file containing the object */
+    ObjectID  *oid,		/* IN object to truncate */
+    Four      newLength,	/* IN length of the object after truncation */
+    Pool      *dlPool,		/* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead)	/* INOUT head of dealloc list */
+{
+    Four        e;		/* error number */
+    PageID      pid;		/* page on which the object resides */
+    SlottedPage *apage;		/* pointer to the buffer holding the page */
+    Object      *obj;		/* points to the object in data area */
+    Four        offset;		/* start offset of object in data area */
+    Four        alignedLen;	/* aligned length of the object data */
+    Four        newAlignedLen;	/* aligned length of the object data after truncation */
+    ObjectID    movedOid;	/* where the data of a moved object is */
+    sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
+
+
+    /*@ parameter checking */
+
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (oid == NULL) ERR(eBADOBJECTID_OM);
+
+    if (newLength < 0) ERR(eBADLENGTH_OM);
+
+    e = eduom_GetCatalogEntry(catObjForFile, &catEntry);
+    if (e < 0) ERR(e);
+
+    MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
+
+    e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    if (oid->slotNo < 0 || oid->slotNo >= apage->header.nSlots || !IS_VALID_OBJECTID(oid, apage))
+        ERRB1(eBADOBJECTID_OM, &pid, PAGE_BUF);
+
+    /* a record of the PAX layout keeps its length */
+    if (IS_PAX_PAGE(apage)) ERRB1(eNOTSUPPORTED_EDUOM, &pid, PAGE_BUF);
+
+    offset = apage->slot[-(oid->slotNo)].offset;
+    obj = (Object *)&(apage->data[offset]);
+
+    /* moved data shrinks where it is; the stub is not changed */
+    if (obj->header.properties & P_MOVED) {
+        memcpy(&movedOid, obj->data, sizeof(ObjectID));
+        BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+
+        return(EduOM_TruncateObject(catObjForFile, &movedOid, newLength, dlPool, dlHead));
+    }
+
+    if (newLength > obj->header.length) ERRB1(eBADLENGTH_OM, &pid, PAGE_BUF);
+
+    if (newLength == obj->header.length) {
+        BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+        return(eNOERROR);
+    }
+
+    e = om_RemoveFromAvailSpaceList(catObjForFile, &pid, apage);
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    if (obj->header.properties & P_LRGOBJ) {
+        e = LOT_DeleteFromObject(catObjForFile, &pid, oid->slotNo, newLength,
+                                 obj->header.length - newLength, dlPool, dlHead);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+        /* the root may have been moved within the page */
+        obj = (Object *)&(apage->data[apage->slot[-(oid->slotNo)].offset]);
+    }
+    else {
+        alignedLen = DATA_LENGTH_IN_PAGE(obj->header.length);
+        newAlignedLen = DATA_LENGTH_IN_PAGE(newLength);
+
+        if (offset + sizeof(ObjectHdr) + alignedLen == apage->header.free)
+            apage->header.free -= alignedLen - newAlignedLen;
+        else
+            apage->header.unused += alignedLen - newAlignedLen;
+    }
+
+    obj->header.length = newLength;
+
+    e = om_PutInAvailSpaceList(catObjForFile, &pid, apage);
+    if (e >= 0) e = eduom_FsmUpdate(catObjForFile, catEntry, &pid, SP_FREE(apage));
+    if (e >= 0) e = BfM_SetDirty((TrainID *)&pid, PAGE_BUF);
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+    
+} /* EduOM_TruncateObject() */
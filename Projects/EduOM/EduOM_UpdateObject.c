@@ -0,0 +1,255 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_UpdateObject.c
+ * 
+ * Description :
+ *  EduOM_UpdateObject() replaces the data of an object keeping its
+ *  ObjectID.
+ *
+ * Exports:
+ *  Four EduOM_UpdateObject(ObjectID*, ObjectID*, Four, char*, Pool*, DeallocListElem*)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+#include "EduOM.h"
+
+
+
+/*@================================
+ * EduOM_UpdateObject()
+ *================================*/
+/*
+ * Function: Four EduOM_UpdateObject(ObjectID*, ObjectID*, Four, char*, Pool*, DeallocListElem*)
+ * 
+ * Description :
+ *  (1) What to do?
+ *  EduOM_UpdateObject() replaces the whole data of the object 'oid' with
+ *  the 'length' bytes of 'data'. Unlike destroying the object and creating
+ *  it again, the object keeps its ObjectID, so the index entries pointing
+ *  to it stay valid.
+ *  The new data is written in place if it is not longer, and grows into the
+ *  free space of the page if the page has room. Otherwise the object is
+ *  moved: the data goes to a new object marked P_FORWARDED in another page,
+ *  and the object in the home page becomes a forwarding stub marked
+ *  P_MOVED whose data is the ObjectID of the moved data. A stub always
+ *  points to the data directly: when moved data has to move again, the
+ *  stub is updated and the old copy destroyed, and the data comes back home
+ *  as soon as the home page has room for it. The moved data is reached only
+ *  through the ObjectID of its stub.
+ *  Data too large for a page makes the object a large object in its home
+ *  page.
+ *
+ *  (2) How to do?
+ *  a. Read the header of the object
+ *  b. IF record of the PAX layout THEN
+ *	   overwrite the record if the length is the length of a record
+ *     ELSE IF moved data THEN
+ *	   return eBADOBJECTID_OM
+ *     ELSE IF large object THEN
+ *	   overwrite the data and truncate it or append the rest
+ *     ELSE IF the new data is too large for a page THEN
+ *	   make the object empty in its home page, destroying the moved data
+ *	   append the new data
+ *     ELSE IF moved object THEN
+ *	   replace the moved data in its page, ELSE
+ *	   replace the stub with the data in the home page, ELSE
+ *	   move the data again and point the stub to it
+ *     ELSE
+ *	   replace the object in its page, ELSE
+ *	   move the data and make the object a stub pointing to it
+ *     ENDIF
+ *  c. Return
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADOBJECTID_OM
+ *    eBADLENGTH_OM
+ *    eBADUSERBUF_OM
+ *    eNOSPACEFORSTUB_EDUOM
+ *    some errors caused by function calls
+ */
+Four EduOM_UpdateObject(
+    ObjectID  *catObjForFile,	/* IN file containing the object */
+    ObjectID  *oid,		/* IN object to update */
+    Four      length,		/* IN amount of new data */
+    char      *data,		/* IN new data */
+    Pool      *dlPool,		/* INOUT pool of dealloc list elements */
+    DeallocListElem *dlHead)	/* INOUT head of dealloc list */
+{
+    Four        e;		/* error number */
+    PageID      pid;		/* page on which the object resides */
+    SlottedPage *apage;		/* pointer to the buffer holding the page */
+    Object      *obj;		/* points to the object in data area */
+    ObjectHdr   objHdr;		/* header of the object */
+    ObjectHdr   movedHdr;	/* header of the moved data */
+    ObjectID    movedOid;	/* where the data of a moved object is */
+    ObjectID    newMovedOid;	/* where the data of the object is moved */
+    sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
+
+
+    /*@ parameter checking */
+
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (oid == NULL) ERR(eBADOBJECTID_OM);
+
+    if (length < 0) ERR(eBADLENGTH_OM);
+
+    if (length > 0 && data == NULL) ERR(eBADUSERBUF_OM);
+
+    /*@ read the header of the object */
+    MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
+
+    e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    if (oid->slotNo < 0 || oid->slotNo >= apage->header.nSlots || !IS_VALID_OBJECTID(oid, apage))
+        ERRB1(eBADOBJECTID_OM, &pid, PAGE_BUF);
+
+    /* a record of the PAX layout keeps its length */
+    if (IS_PAX_PAGE(apage)) {
+        if (length != PAX_HDR(apage)->recordLength) ERRB1(eBADLENGTH_OM, &pid, PAGE_BUF);
+
+        e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        e = EduOM_WriteObject(oid, 0, length, data);
+        if (e < 0) ERR(e);
+
+        return(eNOERROR);
+    }
+
+    obj = (Object *)&(apage->data[apage->slot[-(oid->slotNo)].offset]);
+    objHdr = obj->header;
+    if (objHdr.properties & P_MOVED)
+        memcpy(&movedOid, obj->data, sizeof(ObjectID));
+
+    e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    /* moved data is reached only through its stub, so no chain of stubs is made */
+    if (objHdr.properties & P_FORWARDED) ERR(eBADOBJECTID_OM);
+
+    /*@ a large object stays large */
+    if (objHdr.properties & P_LRGOBJ) {
+        e = eNOERROR;
+        if (length <= objHdr.length) {
+            if (length > 0) e = EduOM_WriteObject(oid, 0, length, data);
+            if (e >= 0) e = EduOM_TruncateObject(catObjForFile, oid, length, dlPool, dlHead);
+        }
+        else {
+            if (objHdr.length > 0) e = EduOM_WriteObject(oid, 0, objHdr.length, data);
+            if (e >= 0) e = EduOM_AppendToObject(catObjForFile, oid, length - objHdr.length,
+                                                 &data[objHdr.length], dlPool, dlHead);
+        }
+        if (e < 0) ERR(e);
+
+        return(eNOERROR);
+    }
+
+    e = eduom_GetCatalogEntry(catObjForFile, &catEntry);
+    if (e < 0) ERR(e);
+
+    /*@ too large for a page: empty the object at home and let it grow into a large object */
+    if (ALIGNED_LENGTH(length) > LRGOBJ_THRESHOLD) {
+        e = eduom_ReplaceObject(catObjForFile, catEntry, oid, 0, 0, NULL);
+        if (e >= 0 && (objHdr.properties & P_MOVED))
+            e = EduOM_DestroyObject(catObjForFile, &movedOid, dlPool, dlHead);
+        if (e < 0) ERR(e);
+
+        e = EduOM_AppendToObject(catObjForFile, oid, length, data, dlPool, dlHead);
+        if (e < 0) ERR(e);
+
+        return(eNOERROR);
+    }
+
+    if (objHdr.properties & P_MOVED) {
+        /*@ update the moved data where it is, or bring it home, or move it again */
+        e = eduom_ReplaceObject(catObjForFile, catEntry, &movedOid, P_FORWARDED, length, data);
+        if (e == FALSE) {
+            e = eduom_ReplaceObject(catObjForFile, catEntry, oid, 0, length, data);
+            if (e == FALSE) {
+                movedHdr.properties = P_FORWARDED;
+                movedHdr.tag = objHdr.tag;
+                e = eduom_CreateObject(catObjForFile, NULL, &movedHdr, length, data, &newMovedOid);
+                if (e >= 0)
+                    e = eduom_ReplaceObject(catObjForFile, catEntry, oid, P_MOVED,
+                                            sizeof(ObjectID), (char *)&newMovedOid);
+            }
+            if (e >= 0) e = EduOM_DestroyObject(catObjForFile, &movedOid, dlPool, dlHead);
+        }
+    }
+    else {
+        /*@ update the object in its page, or move it leaving a stub */
+        e = eduom_ReplaceObject(catObjForFile, catEntry, oid, 0, length, data);
+        if (e == FALSE) {
+            movedHdr.properties = P_FORWARDED;
+            movedHdr.tag = objHdr.tag;
+            e = eduom_CreateObject(catObjForFile, NULL, &movedHdr, length, data, &newMovedOid);
+            if (e >= 0)
+                e = eduom_ReplaceObject(catObjForFile, catEntry, oid, P_MOVED,
+                                        sizeof(ObjectID), (char *)&newMovedOid);
+            if (e == FALSE) {
+                /* no room even for the stub; the object is left as it was */
+                e = EduOM_DestroyObject(catObjForFile, &newMovedOid, dlPool, dlHead);
+                if (e >= 0) e = eNOSPACEFORSTUB_EDUOM;
+            }
+        }
+    }
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+    
+} /* EduOM_UpdateObject() */
@@ -0,0 +1,183 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_WriteObject.c
+ * 
+ * Description :
+ *  EduOM_WriteObject() overwrites a byte range of an object.
+ *
+ * Exports:
+ *  Four EduOM_WriteObject(ObjectID*, Four, Four, char*)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "BfM.h"		/* for the buffer manager call */
+#include "LOT.h"		/* for the large object manager call */
+#include "EduOM_Internal.h"
+
+
+
+/*@================================
+ * EduOM_WriteObject()
+ *================================*/
+/*
+ * Function: Four EduOM_WriteObject(ObjectID*, Four, Four, char*)
+ * 
+ * Description :
+ *  (1) What to do?
+ *  EduOM_WriteObject() overwrites the 'length' bytes from 'start' of the
+ *  object 'oid' with 'data'. If 'length' is REMAINDER, the data from
+ *  'start' to the end of the object is overwritten. The object does not
+ *  grow; a range running past the end of the object is cut at the end.
+ *  Only the leaves of a large object which hold the range are read in.
+ *
+ *  (2) How to do?
+ *  a. Read in the slotted page
+ *  b. See the object header
+ *  c. IF page of the PAX layout THEN
+ *	   scatter the data over the minipages of the page
+ *     ELSE IF moved object THEN
+ *	   call this routine recursively with the moved data's identifier
+ *     ELSE IF large object THEN
+ *	   call the large object manager's LOT_WriteObject()
+ *     ELSE
+ *	   copy the data into the object
+ *     ENDIF
+ *  d. Free the buffer page
+ *  e. Return
+ *
+ * Returns:
+ *  1) number of bytes actually written (values greater than or equal to 0)
+ *  2) Error Code (negative values)
+ *    eBADOBJECTID_OM
+ *    eBADLENGTH_OM
+ *    eBADUSERBUF_OM
+ *    eBADSTART_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_WriteObject(
+    ObjectID 	*oid,		/* IN object to write */
+    Four     	start,		/* IN starting offset of write */
+    Four     	length,		/* IN amount of data to write */
+    char     	*data)		/* IN data to write */
+{
+    Four     	e;              /* error code */
+    PageID 	pid;		/* page containing object specified by 'oid' */
+    SlottedPage	*apage;		/* pointer to the buffer of the page  */
+    Object	*obj;		/* pointer to the object in the slotted page */
+    ObjectID	movedOid;	/* where the data of a moved object is */
+
+
+    /*@ check parameters */
+
+    if (oid == NULL) ERR(eBADOBJECTID_OM);
+
+    if (length < 0 && length != REMAINDER) ERR(eBADLENGTH_OM);
+
+    if (data == NULL) ERR(eBADUSERBUF_OM);
+
+    MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
+
+    e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    if (oid->slotNo < 0 || oid->slotNo >= apage->header.nSlots || !IS_VALID_OBJECTID(oid, apage))
+        ERRB1(eBADOBJECTID_OM, &pid, PAGE_BUF);
+
+    /* the record of the PAX layout is scattered over the minipages */
+    if (IS_PAX_PAGE(apage)) {
+        length = eduom_PaxWriteObject(apage, oid->slotNo, start, length, data);
+        if (length < 0) ERRB1(length, &pid, PAGE_BUF);
+
+        e = BfM_SetDirty((TrainID *)&pid, PAGE_BUF);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+        e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        return(length);
+    }
+
+    obj = (Object *)&(apage->data[apage->slot[-(oid->slotNo)].offset]);
+
+    if (obj->header.properties & P_MOVED) {
+        memcpy(&movedOid, obj->data, sizeof(ObjectID));
+
+        e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        return(EduOM_WriteObject(&movedOid, start, length, data));
+    }
+
+    if (start < 0 || start > obj->header.length) ERRB1(eBADSTART_OM, &pid, PAGE_BUF);
+
+    if (length == REMAINDER || start + length > obj->header.length)
+        length = obj->header.length - start;
+
+    if (obj->header.properties & P_LRGOBJ) {
+        if (length > 0) {
+            e = LOT_WriteObject(&pid, oid->slotNo, start, length, data);
+            if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+        }
+    }
+    else {
+        memcpy(&(obj->data[start]), data, length);
+
+        e = BfM_SetDirty((TrainID *)&pid, PAGE_BUF);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+    }
+
+    e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(length);
+    
+} /* EduOM_WriteObject() */
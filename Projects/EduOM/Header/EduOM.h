@@ -59,12 +59,31 @@
  * Function Prototypes
  */
 /* Interface Function Prototypes */
+Four EduOM_AppendToObject(ObjectID*, ObjectID*, Four, char*, Pool*, DeallocListElem*);
+Four EduOM_CollapseForwards(ObjectID*, Pool*, DeallocListElem*);
 Four EduOM_CompactPage(SlottedPage*, Two);
 Four EduOM_CreateObject(ObjectID*, ObjectID*, ObjectHdr*, Four, void*, ObjectID*);
+Four EduOM_CreateObjects(ObjectID*, Four, ObjectHdr*, Four*, char**, ObjectID*);
 Four EduOM_DestroyObject(ObjectID*, ObjectID*, Pool*, DeallocListElem*);
 Four EduOM_NextObject(ObjectID*, ObjectID*, ObjectID*, ObjectHdr*);
 Four EduOM_PrevObject(ObjectID*, ObjectID*, ObjectID*, ObjectHdr*);
 Four EduOM_ReadObject(ObjectID*, Four, Four, void*);
+Four EduOM_ReadObjects(ObjectID*, Four, char**, Four*);
+Four EduOM_TruncateObject(ObjectID*, ObjectID*, Four, Pool*, DeallocListElem*);
+Four EduOM_UpdateObject(ObjectID*, ObjectID*, Four, char*, Pool*, DeallocListElem*);
+Four EduOM_WriteObject(ObjectID*, Four, Four, char*);
+Four EduOM_OpenScan(ObjectID*, ObjectScanCursor*);
+Four EduOM_NextObjects(ObjectScanCursor*, Four, ObjectID*, Object**);
+Four EduOM_NextMatchingObjects(ObjectScanCursor*, ObjectFilter*, Four, ObjectID*, Object**);
+Four EduOM_CloseScan(ObjectScanCursor*);
+Four EduOM_OpenAppend(ObjectID*, ObjectAppendCursor*);
+Four EduOM_AppendObject(ObjectAppendCursor*, ObjectHdr*, Four, char*, ObjectID*);
+Four EduOM_CloseAppend(ObjectAppendCursor*);
+Four EduOM_PinObject(ObjectID*, ObjectView*);
+Four EduOM_UnpinObject(ObjectView*);
+Four EduOM_ParallelScan(ObjectID*, Four, Four, ParallelScanFn, void*);
+Four EduOM_SetPaxLayout(ObjectID*, Four, Four*);
+Four EduOM_ProjectScan(ObjectID*, Four, Four*, ProjectScanFn, void*);
 
 Four OM_DumpObject(ObjectID *);
 
@@ -49,6 +49,8 @@
 #ifndef _EDUOM_INTERNAL_H_
 #define _EDUOM_INTERNAL_H_
 
+#include <pthread.h>
+#include "Util_pool.h"		/* to get Pool */
 
 /*@
  * Type Definitions
@@ -99,6 +101,278 @@ typedef struct {
 } SlottedPage;
 
 
+/*
+ *----------------- Definitions for the Free-Slot List --------------------
+ */
+
+/*
+ * The empty slots of a slotted page are linked into a free-slot list
+ * through their 'unique' fields, which are not used while a slot is empty;
+ * the head of the list is kept in the lower half of the 'reserved' field
+ * of the page header, and SP_FREESLOT_MAGIC in the upper half tells that
+ * the list has been set up. Pages changed by other routines may hold a
+ * list which is not up to date, so every slot taken from the list is
+ * checked and the list is rebuilt when it is found wrong.
+ */
+#define SP_FREESLOT_MAGIC       0x46530000
+#define SP_FREESLOT_MAGIC_MASK  0xffff0000
+
+
+/*
+ *----------------- Typedefs for the Free-Space Map --------------------
+ */
+
+/* granularity of the free space recorded in the free-space map (in bytes) */
+#define FSM_CATEGORY_UNIT       16
+
+/* # of pages a new free-space map can hold before it grows */
+#define FSM_INITIAL_CAPACITY    64
+
+/*
+ * Typedef for the free-space map of a data file
+ * The free space of every page is recorded as a category, i.e. the free
+ * space in units of FSM_CATEGORY_UNIT bytes rounded down, in the leaves of
+ * a complete binary tree whose inner nodes hold the maximum category of
+ * their subtrees; a page with at least N bytes free is found in
+ * O(log # of pages) by descending from the root.
+ */
+typedef struct FreeSpaceMap_tag {
+	ObjectID catObj;            /* catalog object of the file, the key of the map */
+	FileID fid;                 /* file the map was built for */
+	Four nPages;                /* # of leaves in use */
+	Four capacity;              /* # of leaves of the tree, a power of 2 */
+	UOne *tree;                 /* node i has the children 2i and 2i+1; leaf k is node capacity+k */
+	ShortPageID *pageNo;        /* page recorded in each leaf */
+	Four *hash;                 /* leaf of each page; open addressing over 2*capacity entries */
+	struct FreeSpaceMap_tag *next;  /* next map in the directory of maps */
+} FreeSpaceMap;
+
+
+/*
+ *----------------- Typedefs for the Catalog Cache --------------------
+ */
+
+/*
+ * Typedef for a cached catalog entry of a data file
+ * The entry is a copy of the catalog object decoded from its page. 'fid',
+ * 'eff' and 'firstPage' never change during the life of the file; 'lastPage'
+ * is read again from the catalog page once the entry is marked stale.
+ * The available space lists are not kept up to date in the copy.
+ */
+typedef struct CatalogCacheEntry_tag {
+	ObjectID catObj;            /* catalog object of the file, the key of the entry */
+	Boolean valid;              /* TRUE if 'entry' agrees with the catalog page */
+	sm_CatOverlayForData entry; /* copy of the catalog entry */
+	struct CatalogCacheEntry_tag *next;  /* next entry in the catalog cache */
+} CatalogCacheEntry;
+
+
+/*
+ *----------------- Typedefs for the Scan Cursor --------------------
+ */
+
+/*
+ * Typedef for a page-at-a-time scan of a data file
+ * The page being scanned stays fixed between calls, so the objects returned
+ * can be used in place until the next call on the cursor.
+ */
+typedef struct {
+	VolNo volNo;                /* volume of the file */
+	ShortPageID nextPage;       /* page to scan after the current one; NIL at the end of the file */
+	PageID pid;                 /* page being scanned */
+	SlottedPage *apage;         /* buffer of the page being scanned; NULL if none is fixed */
+	Two slotNo;                 /* next slot of the page to return */
+} ObjectScanCursor;
+
+
+/*
+ *----------------- Typedefs for the Filter --------------------
+ */
+
+/* maximum # of terms of a filter */
+#define FILTER_MAX_TERMS        8
+
+/*
+ * Typedef for a term of a filter: the integer at 'offset' in the data of
+ * an object compared with 'constant'
+ */
+typedef struct {
+	Two offset;                 /* offset of the value in the data of the object */
+	Two type;                   /* SM_SHORT, SM_INT or SM_LONG */
+	CompOp op;                  /* SM_EQ, SM_LT, SM_LE, SM_GT, SM_GE or SM_NE */
+	Four constant;              /* value the value of the object is compared with */
+} FilterTerm;
+
+/*
+ * Typedef for the function testing an object which satisfies the terms of
+ * a filter
+ * It is called with the identifier of the object and the object in the
+ * buffer page, valid only during the call; it returns TRUE to take the
+ * object and FALSE to drop it.
+ */
+typedef Boolean (*FilterFn)(ObjectID*, Object*, void*);
+
+/*
+ * Typedef for a filter of the objects of a scan
+ * An object passes the filter if it satisfies all the terms and 'fn', if
+ * any, returns TRUE for it. An object too short to hold the value of a
+ * term does not satisfy the term.
+ */
+typedef struct {
+	Four nTerms;                /* # of terms, 0 to FILTER_MAX_TERMS */
+	FilterTerm terms[FILTER_MAX_TERMS]; /* the terms, all of which must hold */
+	FilterFn fn;                /* function testing the objects; NULL if none */
+	void *arg;                  /* argument passed to 'fn' */
+} ObjectFilter;
+
+
+/*
+ *----------------- Typedefs for the Append Cursor --------------------
+ */
+
+/* # of pages allocated at a time for an append cursor */
+#define APPEND_PREALLOC_PAGES   16
+
+/*
+ * Typedef for appending objects at the tail of a data file
+ * The tail page stays fixed between calls and is put back into the
+ * available space lists and the free-space map only when it is left.
+ * The pages to follow it are allocated in advance, APPEND_PREALLOC_PAGES
+ * at a time, and join the file one by one as the tail fills.
+ */
+typedef struct {
+	ObjectID catObj;            /* catalog object of the file */
+	PageID pid;                 /* tail page of the file */
+	SlottedPage *apage;         /* buffer of the tail page; NULL if none is fixed */
+	Four nPrealloc;             /* # of pages allocated in advance */
+	Four nextPrealloc;          /* next page of 'prealloc' to use */
+	PageID prealloc[APPEND_PREALLOC_PAGES]; /* pages allocated in advance, not yet in the file */
+} ObjectAppendCursor;
+
+
+/*
+ *----------------- Typedefs for the Object View --------------------
+ */
+
+/*
+ * Typedef for a read-only view of an object in the buffer
+ * The page holding the data stays fixed until the view is released, so
+ * the data can be used in place without being copied; it must not be
+ * written through the view.
+ */
+typedef struct {
+	PageID pid;                 /* page holding the data; fixed while the view is held */
+	const char *data;           /* the data of the object in the buffer page */
+	Four length;                /* length of the data */
+} ObjectView;
+
+
+/*
+ *----------------- Typedefs for the Parallel Scan --------------------
+ */
+
+/* default # of pages of a morsel */
+#define PSCAN_MORSEL_PAGES      16
+
+/* maximum # of pages of a wave; two waves are fixed at a time */
+#define PSCAN_WAVE_PAGES        1024
+
+/* maximum # of worker threads of a parallel scan */
+#define PSCAN_MAX_THREADS       64
+
+/* # of objects a worker collects before it emits them */
+#define PSCAN_OUTPUT_BUFFER     256
+
+/*
+ * Typedef for the function processing the objects emitted by a parallel scan
+ * It is called on a worker thread with the # of the thread and the objects
+ * collected in its output buffer; the objects are valid only during the call.
+ * A negative return value stops the scan and is returned by the scan.
+ */
+typedef Four (*ParallelScanFn)(Four, Four, ObjectID*, Object**, void*);
+
+/*
+ * Typedef for the state shared by the coordinator and the workers of a
+ * parallel scan
+ * The coordinator alone calls the buffer manager: it fixes the pages of the
+ * file a wave of up to PSCAN_WAVE_PAGES pages at a time, publishes the wave,
+ * and fixes the next wave in the other half of the arrays while the workers
+ * take the morsels of the published one. The fields below 'mutex' are
+ * protected by it.
+ */
+typedef struct {
+	VolNo volNo;                /* volume of the file */
+	Four morselPages;           /* maximum # of pages of a morsel */
+	PageID *pids[2];            /* pages of the two waves */
+	SlottedPage **apages[2];    /* buffers of those pages */
+	Four nPages[2];             /* # of pages of each wave */
+	ParallelScanFn fn;          /* function processing the objects */
+	void *arg;                  /* argument passed to 'fn' */
+	pthread_mutex_t mutex;      /* protects the fields below */
+	pthread_cond_t startCond;   /* signaled when a wave is published or the scan is finished */
+	pthread_cond_t doneCond;    /* signaled when the last morsel of the wave is done */
+	Four wave;                  /* wave published, 0 or 1 */
+	Four nMorsels;              /* # of morsels of the wave */
+	Four nextMorsel;            /* next morsel to be taken */
+	Four nPending;              /* # of morsels of the wave not yet done */
+	Boolean finished;           /* no more waves will be published */
+	Four error;                 /* first error of a worker */
+} ParallelScan;
+
+/*
+ * Typedef for a worker thread of a parallel scan, with its output buffer
+ */
+typedef struct {
+	ParallelScan *scan;         /* the scan */
+	Four thread;                /* # of the thread, 0 to nThreads-1 */
+	Four nObjects;              /* # of objects in the output buffer */
+	ObjectID oids[PSCAN_OUTPUT_BUFFER];     /* output buffer */
+	Object *objs[PSCAN_OUTPUT_BUFFER];      /*   and the objects in the buffer pages */
+} ParallelScanWorker;
+
+
+/*
+ *----------------- Typedefs for the PAX Layout --------------------
+ */
+
+/* the flag of a page whose objects are kept in the PAX layout; above the page type vector */
+#define SP_PAX_LAYOUT           0x10
+
+/* maximum # of columns of a record of the PAX layout */
+#define PAX_MAX_COLUMNS         16
+
+/* alignment of the minipages of a page of the PAX layout within the page */
+#define PAX_MINIPAGE_ALIGN      16
+
+/*
+ * Typedef for the header of the data area of a page of the PAX layout
+ * Every object of a file of the PAX layout is a record of the same fixed
+ * length, split into columns of fixed widths. The values of a column are
+ * kept densely in a minipage of the page: column i of record r is at
+ * offset[i] + r*width[i] in the data area. The slot of an object holds the
+ * # of its record in the page instead of an offset, so the ObjectIDs work
+ * as in a slotted page; the records are kept dense, so destroying one moves
+ * the last record of the page into its place.
+ */
+typedef struct {
+	Two nColumns;               /* # of columns of a record */
+	Two recordLength;           /* length of a record, the sum of the widths */
+	Two capacity;               /* # of records the page can hold */
+	Two nRecords;               /* # of records in the page, 0 to capacity */
+	Two width[PAX_MAX_COLUMNS];     /* width of each column */
+	Two offset[PAX_MAX_COLUMNS];    /* start of the minipage of each column in the data area */
+} PaxPageHdr;
+
+/*
+ * Typedef for the function processing the pages of a projection scan
+ * It is called with the # of records of a page and, for each projected
+ * column, the values of the column in the page, contiguous and aligned to
+ * PAX_MINIPAGE_ALIGN; the values are valid only during the call.
+ * A negative return value stops the scan and is returned by the scan.
+ */
+typedef Four (*ProjectScanFn)(Four, char**, void*);
+
+
 /*@
  * Macro Function Definitions
  */
@@ -132,6 +406,32 @@ typedef struct {
 /* The empty slots have EMPTYSLOT with the 'offset' */
 #define EMPTYSLOT       -1
 
+/* Macro: SP_HAS_FREESLOT_LIST(p)
+ * Description: check whether the free-slot list of the page has been set up
+ * Parameter:
+ *  SlottedPage *p      : pointer to the page
+ * Returns: TRUE(1) if the page has a free-slot list, otherwise FALSE(0)
+ */
+#define SP_HAS_FREESLOT_LIST(p) \
+	((((p)->header.reserved & SP_FREESLOT_MAGIC_MASK) == SP_FREESLOT_MAGIC) ? TRUE : FALSE)
+
+/* Macro: SP_FREESLOT_HEAD(p)
+ * Description: return the first slot of the free-slot list of the page
+ * Parameter:
+ *  SlottedPage *p      : pointer to the page
+ * Returns: (Two) first empty slot; NIL if the list is empty
+ */
+#define SP_FREESLOT_HEAD(p) ((Two)((p)->header.reserved & 0xffff))
+
+/* Macro: SP_SET_FREESLOT_HEAD(p, slotNo)
+ * Description: make the slot the first of the free-slot list of the page; NIL empties the list
+ * Parameters:
+ *  SlottedPage *p      : pointer to the page
+ *  Two slotNo          : first empty slot
+ */
+#define SP_SET_FREESLOT_HEAD(p, slotNo) \
+	((p)->header.reserved = SP_FREESLOT_MAGIC | ((slotNo) & 0xffff))
+
 /* Macro: IS_VALID_OBJECTID(oid, s_page)
  * Description: check whether the object ID given as a parameter is valid or not
  * Parameters:
@@ -145,6 +445,69 @@ typedef struct {
 
 #define LRGOBJ_THRESHOLD (PAGESIZE - SP_FIXED - sizeof(ObjectHdr))
 
+/* Macro: DATA_LENGTH_IN_PAGE(length)
+ * Description: return the bytes the data of a small object of 'length' bytes occupies in the page;
+ *              an object has room for at least a ShortPageID, the least the large object manager
+ *              turns it into when it is converted to a large object
+ * Parameter:
+ *  Four length         : length of the object data
+ * Returns: (Four) aligned length of the data in the page
+ */
+#define DATA_LENGTH_IN_PAGE(length) MAX(ALIGNED_LENGTH(length), (Four)sizeof(ShortPageID))
+
+/* Macro: OBJECT_SIZE_IN_PAGE(obj)
+ * Description: return the bytes the object occupies in the data area of its page including the header;
+ *              only the root of a large object is in the page (needs LOT.h)
+ * Parameter:
+ *  Object *obj         : pointer to the object in the page
+ * Returns: (Four) size of the object in the page
+ */
+#define OBJECT_SIZE_IN_PAGE(obj) \
+	(((obj)->header.properties & P_LRGOBJ) ? LOT_GetLengthWithHdr(obj) : \
+	 (Four)(sizeof(ObjectHdr) + DATA_LENGTH_IN_PAGE((obj)->header.length)))
+
+/* Macro: IS_PAX_PAGE(p)
+ * Description: check whether the page keeps its objects in the PAX layout
+ * Parameter:
+ *  SlottedPage *p      : pointer to the page
+ * Returns: nonzero if the page is of the PAX layout, otherwise 0
+ */
+#define IS_PAX_PAGE(p) ((p)->header.flags & SP_PAX_LAYOUT)
+
+/* Macro: PAX_HDR(p)
+ * Description: return the header of the data area of a page of the PAX layout
+ * Parameter:
+ *  SlottedPage *p      : pointer to the page
+ * Returns: (PaxPageHdr *) header of the data area
+ */
+#define PAX_HDR(p) ((PaxPageHdr *)(p)->data)
+
+/* Macro: PAX_SET_FULL(p)
+ * Description: make the page of the PAX layout look full to the routines of the slotted page, so that
+ *              SP_FREE() is 0 and the page is never in an available space list or found in the free-space map
+ * Parameter:
+ *  SlottedPage *p      : pointer to the page
+ */
+#define PAX_SET_FULL(p) \
+	((p)->header.unused = 0, \
+	 (p)->header.free = PAGESIZE - SP_FIXED - ((p)->header.nSlots-1)*((CONSTANT_CASTING_TYPE)sizeof(SlottedPageSlot)))
+
+/* Macro: FSM_CATEGORY(freeSpace)
+ * Description: return the category of a page having the given free space; the free space is rounded down
+ * Parameter:
+ *  Four freeSpace      : free space of the page
+ * Returns: (UOne) category
+ */
+#define FSM_CATEGORY(freeSpace) ((UOne)((freeSpace) / FSM_CATEGORY_UNIT))
+
+/* Macro: FSM_NEEDED_CATEGORY(neededSpace)
+ * Description: return the least category of a page having the given free space; the space is rounded up
+ * Parameter:
+ *  Four neededSpace    : free space needed
+ * Returns: (Four) category
+ */
+#define FSM_NEEDED_CATEGORY(neededSpace) (((neededSpace) + FSM_CATEGORY_UNIT - 1) / FSM_CATEGORY_UNIT)
+
 /* Macro: GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry)
  * Description: get the information about the data file(sm_CatOverlayForData) residing in the catalog object for data file
  * Parameters:
@@ -165,6 +528,20 @@ typedef struct {
  */
 /* internal function prototypes */
 Four eduom_CreateObject(ObjectID*, ObjectID*, ObjectHdr*, Four, char*, ObjectID*);
+Four eduom_FsmSearch(ObjectID*, sm_CatOverlayForData*, Four, PageID*);
+Four eduom_FsmUpdate(ObjectID*, sm_CatOverlayForData*, PageID*, Four);
+Four eduom_GetCatalogEntry(ObjectID*, sm_CatOverlayForData**);
+void eduom_InvalidateCatalogEntry(ObjectID*);
+Four eduom_GetLastPage(ObjectID*, sm_CatOverlayForData**, PageID*, SlottedPage**);
+Four eduom_IsPageOfFile(sm_CatOverlayForData*, PageID*, SlottedPage*);
+Four eduom_ReplaceObject(ObjectID*, sm_CatOverlayForData*, ObjectID*, Two, Four, char*);
+Two eduom_AllocSlot(SlottedPage*);
+void eduom_FreeSlot(SlottedPage*, Two);
+Four eduom_PaxFormatPage(SlottedPage*, Four, Two*);
+Four eduom_PaxCreateObject(ObjectID*, sm_CatOverlayForData*, PageID*, Four, char*, ObjectID*);
+Four eduom_PaxReadObject(SlottedPage*, Two, Four, Four, char*);
+Four eduom_PaxWriteObject(SlottedPage*, Two, Four, Four, char*);
+void eduom_PaxRemoveRecord(SlottedPage*, Two);
 
 Four om_FileMapAddPage(ObjectID*, PageID*, PageID*);
 Four om_FileMapDeletePage(ObjectID*, PageID*);
@@ -173,5 +550,7 @@ Four om_IsTemporary(FileID*, Boolean*);
 Four om_PutInAvailSpaceList(ObjectID*, PageID*, SlottedPage*);
 Four om_RemoveFromAvailSpaceList(ObjectID*, PageID*, SlottedPage*);
 
+Four LOT_ConvertToLarge(ObjectID*, SlottedPage*, Two, Pool*, DeallocListElem*);
+
     
 #endif /* _EDUOM_INTERNAL_H_ */
@@ -80,6 +80,17 @@
 #define REMAINDER -1
 
 
+/*
+ * Data Type of a value compared by a filter; the same numbers as the B+ tree
+ */
+#define SM_SHORT                0
+#define SM_INT                  1
+#define SM_LONG                 2
+#define SM_SHORT_SIZE           sizeof(Two_Invariable)
+#define SM_INT_SIZE             sizeof(Four_Invariable)
+#define SM_LONG_SIZE            sizeof(Four_Invariable)
+
+
 /*
 ** Type Definition of PageID
 */
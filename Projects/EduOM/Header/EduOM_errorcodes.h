@@ -71,3 +71,6 @@
 #define eCANTALLOCEXTENT_BL_OM                   ERR_ENCODE_ERROR_CODE(OM_ERR_BASE,9)
 #define NUM_ERRORS_OM_ERR_BASE                   10
 #define eNOTSUPPORTED_EDUOM			             ERR_ENCODE_ERROR_CODE(OM_ERR_BASE,11)
+#define eMEMORYALLOCERR_EDUOM		             ERR_ENCODE_ERROR_CODE(OM_ERR_BASE,12)
+#define eNOSPACEFORSTUB_EDUOM		             ERR_ENCODE_ERROR_CODE(OM_ERR_BASE,13)
+#define eFILENOTEMPTY_EDUOM			             ERR_ENCODE_ERROR_CODE(OM_ERR_BASE,14)
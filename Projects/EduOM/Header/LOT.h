@@ -52,9 +52,12 @@
 #include "Util_pool.h"
 
 
+Four LOT_AppendToObject(ObjectID*, PageID*, Two, Four, char*);
+Four LOT_DeleteFromObject(ObjectID*, PageID*, Two, Four, Four, Pool*, DeallocListElem*);
 Four LOT_DestroyObject(PageID*, Two, Pool*, DeallocListElem*);
 Four LOT_GetLengthWithHdr(Object*);
 Four LOT_ReadObject(PageID*, Two, Four, Four, char*);
+Four LOT_WriteObject(PageID*, Two, Four, Four, char*);
 
 
 #endif /* _LOT_H_ */
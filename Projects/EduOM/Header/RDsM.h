@@ -51,6 +51,7 @@
 
 
 Four    RDsM_AllocTrains(Four, Four, PageID *, Two, Four, Two, PageID *);
+Four    RDsM_FreeTrain(PageID *, Two);
 Four    RDsM_GetUnique(PageID*, Unique*, Four*);
 Four	RDsM_PageIdToExtNo(PageID *, Four *);
 
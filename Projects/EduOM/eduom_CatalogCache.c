@@ -0,0 +1,335 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : eduom_CatalogCache.c
+ * 
+ * Description :
+ *  Cache the catalog entries of the data files, so that an object operation
+ *  does not fix the page of the catalog object only to decode the entry of
+ *  its file. The entries are kept in memory in a directory keyed by the
+ *  catalog object of the file; a catalog object destroyed and created again
+ *  gets a new unique number, so an entry never answers for another file.
+ *  The cache is written through: the catalog page is still changed by the
+ *  routines which change the file map, and the entry is marked stale then.
+ *  Callers outside EduOM change the file map without marking the entry, so
+ *  the last page is checked against the page list before it is used.
+ *
+ * Exports:
+ *  Four eduom_GetCatalogEntry(ObjectID*, sm_CatOverlayForData**)
+ *  void eduom_InvalidateCatalogEntry(ObjectID*)
+ *  Four eduom_GetLastPage(ObjectID*, sm_CatOverlayForData**, PageID*, SlottedPage**)
+ *  Four eduom_IsPageOfFile(sm_CatOverlayForData*, PageID*, SlottedPage*)
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "EduOM_common.h"
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+
+
+
+/*@
+ * Global Variables
+ */
+/* the directory of the cached catalog entries */
+static CatalogCacheEntry *eduom_catalogCache = NULL;
+
+
+
+/*@ Internal Function Prototypes */
+static CatalogCacheEntry *eduom_LookUpCatalogEntry(ObjectID*);
+
+
+
+/*@================================
+ * eduom_GetCatalogEntry()
+ *================================*/
+/*
+ * Function: Four eduom_GetCatalogEntry(ObjectID*, sm_CatOverlayForData**)
+ * 
+ * Description :
+ *  Get the catalog entry of the file. The page of the catalog object is
+ *  read only when the file is first used or its entry was marked stale.
+ *  The entry returned stays at the same place in memory, so it can be
+ *  used until the operation on the file is over; only the fields 'fid',
+ *  'eff', 'firstPage' and 'lastPage' are kept up to date.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR_EDUOM
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  1) parameter catEntry
+ *     cached catalog entry of the file
+ */
+Four eduom_GetCatalogEntry(
+    ObjectID	*catObjForFile,	/* IN file whose catalog entry is wanted */
+    sm_CatOverlayForData **catEntry) /* OUT cached catalog entry of the file */
+{
+    Four        e;		/* error number */
+    SlottedPage *catPage;	/* buffer page containing the catalog object */
+    sm_CatOverlayForData *pageEntry; /* catalog entry in the buffer page */
+    CatalogCacheEntry *cached;	/* entry in the directory */
+
+
+    cached = eduom_LookUpCatalogEntry(catObjForFile);
+
+    if (cached == NULL) {
+        cached = (CatalogCacheEntry *)calloc(1, sizeof(CatalogCacheEntry));
+        if (cached == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+
+        cached->catObj = *catObjForFile;
+        cached->valid = FALSE;
+        cached->next = eduom_catalogCache;
+        eduom_catalogCache = cached;
+    }
+
+    if (!cached->valid) {
+        e = BfM_GetTrain((TrainID *)catObjForFile, (char **)&catPage, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, pageEntry);
+        memcpy(&cached->entry, pageEntry, sizeof(sm_CatOverlayForData));
+
+        e = BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        cached->valid = TRUE;
+    }
+
+    *catEntry = &cached->entry;
+
+    return(eNOERROR);
+
+} /* eduom_GetCatalogEntry() */
+
+
+
+/*@================================
+ * eduom_InvalidateCatalogEntry()
+ *================================*/
+/*
+ * Function: void eduom_InvalidateCatalogEntry(ObjectID*)
+ * 
+ * Description :
+ *  Mark the cached catalog entry of the file stale after its catalog page
+ *  was changed, e.g. by adding a page to or deleting a page from the file.
+ *  The fields which never change may still be used until the entry is got
+ *  again.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_InvalidateCatalogEntry(
+    ObjectID	*catObjForFile)	/* IN file whose catalog entry changed */
+{
+    CatalogCacheEntry *cached;	/* entry in the directory */
+
+
+    cached = eduom_LookUpCatalogEntry(catObjForFile);
+    if (cached != NULL) cached->valid = FALSE;
+
+} /* eduom_InvalidateCatalogEntry() */
+
+
+
+/*@================================
+ * eduom_GetLastPage()
+ *================================*/
+/*
+ * Function: Four eduom_GetLastPage(ObjectID*, sm_CatOverlayForData**, PageID*, SlottedPage**)
+ * 
+ * Description :
+ *  Get the catalog entry of the file and fix its last page. Pages can be
+ *  added to or deleted from the file behind the cache, so the cached last
+ *  page is taken only if it is still the last page of the file: a page of
+ *  the file (see eduom_IsPageOfFile()) with no next page. Otherwise the
+ *  entry is read again from the catalog, which has the last page.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  1) parameter catEntry
+ *     cached catalog entry of the file
+ *  2) parameter pid
+ *     the last page of the file
+ *  3) parameter apage
+ *     pointer to the buffer holding the last page, fixed
+ */
+Four eduom_GetLastPage(
+    ObjectID	*catObjForFile,	/* IN file whose last page is wanted */
+    sm_CatOverlayForData **catEntry, /* OUT cached catalog entry of the file */
+    PageID	*pid,		/* OUT last page of the file */
+    SlottedPage	**apage)	/* OUT pointer to the buffer holding the last page */
+{
+    Four        e;		/* error number */
+
+
+    e = eduom_GetCatalogEntry(catObjForFile, catEntry);
+    if (e < 0) ERR(e);
+
+    MAKE_PAGEID(*pid, (*catEntry)->fid.volNo, (*catEntry)->lastPage);
+
+    e = BfM_GetTrain((TrainID *)pid, (char **)apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    e = ((*apage)->header.nextPage == NIL) ? eduom_IsPageOfFile(*catEntry, pid, *apage) : FALSE;
+    if (e < 0) ERRB1(e, pid, PAGE_BUF);
+    if (e == TRUE) return(eNOERROR);
+
+    /*@ the cached last page is stale */
+    e = BfM_FreeTrain((TrainID *)pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    eduom_InvalidateCatalogEntry(catObjForFile);
+
+    e = eduom_GetCatalogEntry(catObjForFile, catEntry);
+    if (e < 0) ERR(e);
+
+    MAKE_PAGEID(*pid, (*catEntry)->fid.volNo, (*catEntry)->lastPage);
+
+    e = BfM_GetTrain((TrainID *)pid, (char **)apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* eduom_GetLastPage() */
+
+
+
+/*@================================
+ * eduom_IsPageOfFile()
+ *================================*/
+/*
+ * Function: Four eduom_IsPageOfFile(sm_CatOverlayForData*, PageID*, SlottedPage*)
+ * 
+ * Description :
+ *  Check that the page 'pid', fixed by the caller in 'apage', still belongs
+ *  to the file: it is a slotted page of the file, and it is linked into the
+ *  page list of the file, i.e. it is the first page of the file or the page
+ *  before it still points to it. Deallocating a page unlinks it from its
+ *  neighbours but leaves its own header as it was, so a page gone from the
+ *  file fails the second test even if it still carries the file ID.
+ *
+ * Returns:
+ *  1) TRUE if the page belongs to the file, FALSE otherwise
+ *  2) Error codes: Negative value means error code.
+ *     some errors caused by function calls
+ */
+Four eduom_IsPageOfFile(
+    sm_CatOverlayForData *catEntry, /* IN catalog entry of the file */
+    PageID	*pid,		/* IN page to be checked */
+    SlottedPage	*apage)		/* IN pointer to the buffer holding the page */
+{
+    Four        e;		/* error number */
+    Boolean     linked;		/* TRUE if the previous page points to the page */
+    PageID      prevPid;	/* previous page of the page */
+    SlottedPage *prevPage;	/* pointer to the buffer holding the previous page */
+
+
+    if (!EQUAL_FILEID(apage->header.fid, catEntry->fid)) return(FALSE);
+    if ((apage->header.flags & PAGE_TYPE_VECTOR_MASK) != SLOTTED_PAGE_TYPE) return(FALSE);
+
+    if (apage->header.prevPage == NIL) return(pid->pageNo == catEntry->firstPage);
+
+    MAKE_PAGEID(prevPid, pid->volNo, apage->header.prevPage);
+
+    e = BfM_GetTrain((TrainID *)&prevPid, (char **)&prevPage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    linked = EQUAL_FILEID(prevPage->header.fid, catEntry->fid) && prevPage->header.nextPage == pid->pageNo;
+
+    e = BfM_FreeTrain((TrainID *)&prevPid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(linked);
+
+} /* eduom_IsPageOfFile() */
+
+
+
+/*@================================
+ * eduom_LookUpCatalogEntry()
+ *================================*/
+/*
+ * Function: static CatalogCacheEntry *eduom_LookUpCatalogEntry(ObjectID*)
+ * 
+ * Description :
+ *  Find the entry of the catalog object in the directory. An entry found
+ *  is moved to the front, as a few files are used over and over.
+ *
+ * Returns:
+ *  the entry of the catalog object, NULL if there is none
+ */
+static CatalogCacheEntry *eduom_LookUpCatalogEntry(
+    ObjectID	*catObjForFile)	/* IN catalog object of the file */
+{
+    CatalogCacheEntry *cached;	/* entry in the directory */
+    CatalogCacheEntry *prev;	/* entry before 'cached' */
+
+
+    for (prev = NULL, cached = eduom_catalogCache; cached != NULL; prev = cached, cached = cached->next)
+        if (cached->catObj.pageNo == catObjForFile->pageNo && cached->catObj.volNo == catObjForFile->volNo &&
+            cached->catObj.slotNo == catObjForFile->slotNo && cached->catObj.unique == catObjForFile->unique)
+            break;
+
+    if (cached != NULL && prev != NULL) {
+        prev->next = cached->next;
+        cached->next = eduom_catalogCache;
+        eduom_catalogCache = cached;
+    }
+
+    return(cached);
+
+} /* eduom_LookUpCatalogEntry() */
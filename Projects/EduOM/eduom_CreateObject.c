@@ -62,6 +62,7 @@
 #include "RDsM.h"		/* for the raw disk manager call */
 #include "BfM.h"		/* for the buffer manager call */
 #include "EduOM_Internal.h"
+#include "EduOM.h"
 
 
 
@@ -82,10 +83,17 @@
  *  allocated page is inserted after the near page in the list of pages
  *  consiting in the file).
  *  If there is no room in the near page and the near object 'nearObj' is NULL,
- *  it trys to create a new object in the page in the available space list. If
- *  fail, then the new object will be put into the newly allocated page(In this
- *  case, the newly allocated page is appended at the tail of the list of pages
- *  cosisting in the file).
+ *  it trys to create a new object in the last page of the file and then in a
+ *  page with enough room found by the free-space map of the file. If fail, then the new object will be put into
+ *  the newly allocated page(In this case, the newly allocated page is appended
+ *  at the tail of the list of pages cosisting in the file).
+ *  The available space lists are still maintained for the other users of
+ *  the catalog entry.
+ *  In a file of the PAX layout the object is created as a record of the
+ *  last page or the near page by eduom_PaxCreateObject().
+ *  The catalog entry of the file is taken from the catalog cache; the last
+ *  page it names is checked when the page is read, and the entry is marked
+ *  stale whenever a page is added to the file.
  *
  * Returns:
  *  error Code
@@ -112,14 +120,12 @@ Four eduom_CreateObject(
     Four        firstExt;	/* first Extent No of the file */
     Object      *obj;		/* point to the newly created object */
     Two         i;		/* index variable */
+    Two         j;		/* empty slot to reuse */
     sm_CatOverlayForData *catEntry; /* pointer to data file catalog information */
-    SlottedPage *catPage;	/* pointer to buffer containing the catalog */
     FileID      fid;		/* ID of file where the new object is placed */
     Two         eff;		/* extent fill factor of file */
     Boolean     isTmp;
     PhysicalFileID pFid;
-    Four wholeDatasize;
-    ShortPageID selectedAvaillist;
     Object      object;
     Four        numSlot;
     PageID      lastpid;
@@ -134,85 +140,122 @@ Four eduom_CreateObject(
     /* Error check whether using not supported functionality by EduOM */
     if(ALIGNED_LENGTH(length) > LRGOBJ_THRESHOLD) ERR(eNOTSUPPORTED_EDUOM);
 
-    alignedLen=ALIGNED_LENGTH(length);
+    alignedLen=DATA_LENGTH_IN_PAGE(length);
     neededSpace=sizeof(ObjectHdr)+alignedLen+sizeof(SlottedPageSlot);
-    BfM_GetTrain((TrainID *)catObjForFile,(char**)&catPage,PAGE_BUF);
-    GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile,catPage,catEntry);
-    wholeDatasize=PAGESIZE-SP_FIXED;
-    selectedAvaillist=-1;
+    e=eduom_GetCatalogEntry(catObjForFile,&catEntry);
+    if(e<0) ERR(e);
 
     if(nearObj==NULL){
-        //for case 1 re
-        if(neededSpace<0.2*wholeDatasize&&catEntry->availSpaceList10!=-1)
-            selectedAvaillist=catEntry->availSpaceList10;
-        else if(neededSpace<0.3*wholeDatasize&&catEntry->availSpaceList20!=-1)
-            selectedAvaillist=catEntry->availSpaceList20;
-        else if(neededSpace<0.4*wholeDatasize&&catEntry->availSpaceList30!=-1)
-            selectedAvaillist=catEntry->availSpaceList30;
-        else if(neededSpace<0.5*wholeDatasize&&catEntry->availSpaceList40!=-1)
-            selectedAvaillist=catEntry->availSpaceList40;
-        else if(neededSpace<0.5*wholeDatasize&&catEntry->availSpaceList50!=-1)
-            selectedAvaillist=catEntry->availSpaceList50;
-
-        //for case 2
+        //for case 1: the last page of the file
         if(catEntry->lastPage!=-1){
-            MAKE_PAGEID(lastpid,catEntry->fid.volNo,catEntry->lastPage);
-            BfM_GetTrain(&pid,(char**)&lastpage,PAGE_BUF);
+            /* the cached last page is checked against the page list of the file */
+            e=eduom_GetLastPage(catObjForFile,&catEntry,&lastpid,&lastpage);
+            if(e<0) ERR(e);
+            /* a file of the PAX layout keeps its objects as records of its pages */
+            if(IS_PAX_PAGE(lastpage)){
+                e=BfM_FreeTrain(&lastpid,PAGE_BUF);
+                if(e<0) ERR(e);
+                e=eduom_PaxCreateObject(catObjForFile,catEntry,&lastpid,length,data,oid);
+                if(e<0) ERR(e);
+                return(eNOERROR);
+            }
+            needToAllocPage=(neededSpace>SP_FREE(lastpage));
+            e=BfM_FreeTrain(&lastpid,PAGE_BUF);
+            if(e<0) ERR(e);
+            e=(needToAllocPage ? FALSE : TRUE);
         }
+        else e=FALSE;
 
-        if(neededSpace<=0.5*wholeDatasize&&selectedAvaillist!=-1){
-            MAKE_PAGEID(pid,catEntry->fid.volNo,selectedAvaillist);
-
-            BfM_GetTrain(&pid,(char**)&apage,PAGE_BUF);
-            om_RemoveFromAvailSpaceList(catObjForFile,&pid,apage);
-            EduOM_CompactPage(apage,NIL);
-            BfM_FreeTrain(&pid,PAGE_BUF);
+        //for case 2: a page with enough room from the free-space map
+        if(e==TRUE)
+            pid=lastpid;
+        else{
+            e=eduom_FsmSearch(catObjForFile,catEntry,neededSpace,&pid);
+            if(e<0) ERR(e);
         }
-        else if(neededSpace<=SP_FREE(lastpage)){
-            EduOM_CompactPage(lastpage,NIL);
-            BfM_FreeTrain(&lastpid,PAGE_BUF);
+
+        /* the page stays fixed until the object is in it */
+        if(e==TRUE){
+            e=BfM_GetTrain(&pid,(char**)&apage,PAGE_BUF);
+            if(e<0) ERR(e);
+            e=om_RemoveFromAvailSpaceList(catObjForFile,&pid,apage);
+            if(e<0) ERRB1(e,&pid,PAGE_BUF);
+            /* compact only when the contiguous free area is too small */
+            if(neededSpace>SP_CFREE(apage))
+                EduOM_CompactPage(apage,NIL);
         }
         else{
             MAKE_PHYSICALFILEID(pFid, catEntry->fid.volNo, catEntry->firstPage);
-            RDsM_PageIdToExtNo((PageID *)&pFid, &firstExt);
-            //null allowed?
-            RDsM_AllocTrains(catEntry->fid.volNo, firstExt,NULL, catEntry->eff, 1,PAGESIZE2, &pid);
-            BfM_GetNewTrain(&pid,(char **)&apage,PAGE_BUF);
+            e=RDsM_PageIdToExtNo((PageID *)&pFid, &firstExt);
+            if(e<0) ERR(e);
+            /* the new page is appended after the last page of the file */
+            MAKE_PAGEID(nearPid,catEntry->fid.volNo,catEntry->lastPage);
+            e=RDsM_AllocTrains(catEntry->fid.volNo, firstExt, &nearPid, catEntry->eff, 1,PAGESIZE2, &pid);
+            if(e<0) ERR(e);
+            e=BfM_GetNewTrain(&pid,(char **)&apage,PAGE_BUF);
+            if(e<0) ERR(e);
+            apage->header.pid=pid;
+            apage->header.nSlots=1;
+            apage->header.free=0;
+            apage->header.unused=0;
+            apage->header.flags=SLOTTED_PAGE_TYPE;
+            SP_SET_FREESLOT_HEAD(apage,NIL);
+            apage->header.fid=catEntry->fid;
+            e=om_FileMapAddPage(catObjForFile,&nearPid,&pid);
+            if(e<0) ERRB1(e,&pid,PAGE_BUF);
+            eduom_InvalidateCatalogEntry(catObjForFile);
         }
     }
     else{
-        BfM_GetTrain((TrainID *)nearObj,(char**)&apage,PAGE_BUF);
+        e=BfM_GetTrain((TrainID *)nearObj,(char**)&apage,PAGE_BUF);
+        if(e<0) ERR(e);
+        if(IS_PAX_PAGE(apage)){
+            e=BfM_FreeTrain(nearObj,PAGE_BUF);
+            if(e<0) ERR(e);
+            MAKE_PAGEID(nearPid,nearObj->volNo,nearObj->pageNo);
+            e=eduom_PaxCreateObject(catObjForFile,catEntry,&nearPid,length,data,oid);
+            if(e<0) ERR(e);
+            return(eNOERROR);
+        }
         //condition right?(cfree vs free)
+        MAKE_PAGEID(nearPid,nearObj->volNo,nearObj->pageNo);
         if(neededSpace<=SP_FREE(apage)){
-            MAKE_PAGEID(pid,nearObj->volNo,nearObj->pageNo);
-            om_RemoveFromAvailSpaceList(catObjForFile,&pid,apage);
-            //param NIL right?
-            EduOM_CompactPage(apage,NIL);
+            /* the near page itself stays fixed until the object is in it */
+            pid=nearPid;
+            e=om_RemoveFromAvailSpaceList(catObjForFile,&pid,apage);
+            if(e<0) ERRB1(e,&pid,PAGE_BUF);
+            if(neededSpace>SP_CFREE(apage))
+                EduOM_CompactPage(apage,NIL);
         }
         else{
+            e=BfM_FreeTrain(&nearPid,PAGE_BUF);
+            if(e<0) ERR(e);
             MAKE_PHYSICALFILEID(pFid, catEntry->fid.volNo, catEntry->firstPage);
-            RDsM_PageIdToExtNo((PageID *)&pFid, &firstExt);
-            MAKE_PAGEID(nearPid,nearObj->volNo,nearObj->pageNo);
-            RDsM_AllocTrains(catEntry->fid.volNo, firstExt, &nearPid, catEntry->eff, 1,PAGESIZE2, &pid);
-            BfM_GetNewTrain(&pid,(char **)&apage,PAGE_BUF);
+            e=RDsM_PageIdToExtNo((PageID *)&pFid, &firstExt);
+            if(e<0) ERR(e);
+            e=RDsM_AllocTrains(catEntry->fid.volNo, firstExt, &nearPid, catEntry->eff, 1,PAGESIZE2, &pid);
+            if(e<0) ERR(e);
+            e=BfM_GetNewTrain(&pid,(char **)&apage,PAGE_BUF);
+            if(e<0) ERR(e);
             apage->header.pid=pid;
             apage->header.nSlots=1;
             apage->header.free=0;
             apage->header.unused=0;
             apage->header.flags=SLOTTED_PAGE_TYPE;
+            SP_SET_FREESLOT_HEAD(apage,NIL);
             apage->header.fid=catEntry->fid;
-            om_FileMapAddPage(catObjForFile,&nearPid,&pid);
-            BfM_FreeTrain(&pid,PAGE_BUF);
+            e=om_FileMapAddPage(catObjForFile,&nearPid,&pid);
+            if(e<0) ERRB1(e,&pid,PAGE_BUF);
+            eduom_InvalidateCatalogEntry(catObjForFile);
         }
-        BfM_FreeTrain(nearObj,PAGE_BUF);
     }
 
     objHdr->length=length;
 
     memcpy(apage->data+(apage->header.free),objHdr,sizeof(ObjectHdr));
-    memcpy(apage->data+(apage->header.free)+sizeof(ObjectHdr),data,alignedLen);
+    memcpy(apage->data+(apage->header.free)+sizeof(ObjectHdr),data,length);
 
-    if(apage->header.free==0)
+    if(apage->header.free==0&&apage->header.nSlots>0)
         i=apage->header.nSlots-1;
     else{
         i=apage->header.nSlots;
@@ -220,29 +263,33 @@ Four eduom_CreateObject(
 
     numSlot=i+1;
 
-    //avilable space due to destroyed slot
-    for(int j=0; j<apage->header.nSlots;j++){
-        if(apage->slot[-j].offset==EMPTYSLOT){
-            i=j;
-            numSlot=apage->header.nSlots;
-            break;
-        }        
+    //avilable space due to destroyed slot, taken from the free-slot list
+    j=eduom_AllocSlot(apage);
+    if(j<apage->header.nSlots){
+        i=j;
+        numSlot=apage->header.nSlots;
     }
 
     apage->slot[-i].offset=apage->header.free;
-    om_GetUnique(&pid, &(apage->slot[-i].unique));
+    e=om_GetUnique(&pid, &(apage->slot[-i].unique));
+    if(e<0) ERRB1(e,&pid,PAGE_BUF);
 
     apage->header.free+=alignedLen+sizeof(ObjectHdr);
     apage->header.nSlots=numSlot;
 
-    om_PutInAvailSpaceList(catObjForFile,&pid,apage);
+    e=om_PutInAvailSpaceList(catObjForFile,&pid,apage);
+    if(e>=0) e=eduom_FsmUpdate(catObjForFile,catEntry,&pid,SP_FREE(apage));
+    if(e>=0) e=BfM_SetDirty(&pid,PAGE_BUF);
+    if(e<0) ERRB1(e,&pid,PAGE_BUF);
 
     oid->pageNo=apage->header.pid.pageNo;
     oid->volNo=apage->header.pid.volNo;
     oid->slotNo=i;
     oid->unique=apage->slot[-i].unique;
 
-    BfM_FreeTrain(catObjForFile,PAGE_BUF);
+    e=BfM_FreeTrain(&pid,PAGE_BUF);
+    if(e<0) ERR(e);
+
     return(eNOERROR);
     
 } /* eduom_CreateObject() */
@@ -0,0 +1,229 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : eduom_FreeSlotList.c
+ * 
+ * Description :
+ *  The free-slot list of a slotted page, which finds an empty slot to reuse
+ *  in O(1) instead of searching the slot directory. The list is kept in
+ *  the order of the slots, so the lowest empty slot is reused first.
+ *
+ * Exports:
+ *  Two eduom_AllocSlot(SlottedPage*)
+ *  void eduom_FreeSlot(SlottedPage*, Two)
+ */
+
+
+#include "EduOM_common.h"
+#include "EduOM_Internal.h"
+
+
+
+/*@ Internal Function Prototypes */
+static void eduom_RebuildFreeSlotList(SlottedPage*);
+static Boolean eduom_IsFreeSlot(SlottedPage*, Two);
+
+
+
+/*@================================
+ * eduom_AllocSlot()
+ *================================*/
+/*
+ * Function: Two eduom_AllocSlot(SlottedPage*)
+ * 
+ * Description :
+ *  Return a slot of the page for a new object: the first slot of the
+ *  free-slot list, which is taken off the list, or 'nSlots' if no slot is
+ *  empty. The caller fills in the slot, and increments 'nSlots' when it
+ *  uses a new slot at the end of the slot directory.
+ *  The slot taken from the list is checked to be empty; if it is not, the
+ *  page has been changed by a routine not keeping the list, and the list is
+ *  rebuilt from the slot directory.
+ *
+ * Returns:
+ *  an empty slot, or the # of slots if none
+ */
+Two eduom_AllocSlot(
+    SlottedPage	*apage)		/* INOUT page to take a slot from */
+{
+    Two         slotNo;		/* first slot of the list */
+
+
+    if (!SP_HAS_FREESLOT_LIST(apage) || !eduom_IsFreeSlot(apage, SP_FREESLOT_HEAD(apage)))
+        eduom_RebuildFreeSlotList(apage);
+
+    slotNo = SP_FREESLOT_HEAD(apage);
+    if (slotNo == NIL) return(apage->header.nSlots);
+
+    SP_SET_FREESLOT_HEAD(apage, (Two)apage->slot[-slotNo].unique);
+
+    return(slotNo);
+
+} /* eduom_AllocSlot() */
+
+
+
+/*@================================
+ * eduom_FreeSlot()
+ *================================*/
+/*
+ * Function: void eduom_FreeSlot(SlottedPage*, Two)
+ * 
+ * Description :
+ *  Put the slot emptied by the caller on the free-slot list of the page in
+ *  its place in the order of the slots; only the empty slots below it are
+ *  visited. The slot must be below 'nSlots'; a slot cut off the end of the
+ *  slot directory is not put on the list.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_FreeSlot(
+    SlottedPage	*apage,		/* INOUT page of the slot */
+    Two		slotNo)		/* IN slot emptied */
+{
+    Two         prev;		/* empty slot after which the slot is linked */
+    Two         next;		/* empty slot following 'prev' */
+
+
+    if (!SP_HAS_FREESLOT_LIST(apage) || !eduom_IsFreeSlot(apage, SP_FREESLOT_HEAD(apage))) {
+        eduom_RebuildFreeSlotList(apage);
+        return;
+    }
+
+    /* a slot on the list already is left there */
+    prev = SP_FREESLOT_HEAD(apage);
+    if (prev == slotNo) return;
+
+    if (prev == NIL || slotNo < prev) {
+        apage->slot[-slotNo].unique = (Unique)prev;
+        SP_SET_FREESLOT_HEAD(apage, slotNo);
+        return;
+    }
+
+    for (next = (Two)apage->slot[-prev].unique; next != NIL && next < slotNo;
+         prev = next, next = (Two)apage->slot[-prev].unique) {
+        /* a list out of order or through a slot in use is not up to date */
+        if (next <= prev || !eduom_IsFreeSlot(apage, next)) {
+            eduom_RebuildFreeSlotList(apage);
+            return;
+        }
+    }
+
+    if (next == slotNo) return;
+
+    apage->slot[-slotNo].unique = (Unique)next;
+    apage->slot[-prev].unique = (Unique)slotNo;
+
+} /* eduom_FreeSlot() */
+
+
+
+/*@================================
+ * eduom_RebuildFreeSlotList()
+ *================================*/
+/*
+ * Function: static void eduom_RebuildFreeSlotList(SlottedPage*)
+ * 
+ * Description :
+ *  Link all the empty slots of the page into a new free-slot list, the
+ *  lowest slot first.
+ *
+ * Returns:
+ *  None
+ */
+static void eduom_RebuildFreeSlotList(
+    SlottedPage	*apage)		/* INOUT page whose list is rebuilt */
+{
+    Two         slotNo;		/* slot of the page */
+
+
+    SP_SET_FREESLOT_HEAD(apage, NIL);
+
+    for (slotNo = apage->header.nSlots - 1; slotNo >= 0; slotNo--)
+        if (apage->slot[-slotNo].offset == EMPTYSLOT) {
+            apage->slot[-slotNo].unique = (Unique)SP_FREESLOT_HEAD(apage);
+            SP_SET_FREESLOT_HEAD(apage, slotNo);
+        }
+
+} /* eduom_RebuildFreeSlotList() */
+
+
+
+/*@================================
+ * eduom_IsFreeSlot()
+ *================================*/
+/*
+ * Function: static Boolean eduom_IsFreeSlot(SlottedPage*, Two)
+ * 
+ * Description :
+ *  Check whether a slot taken from the free-slot list can be trusted: NIL
+ *  or an empty slot of the slot directory whose link is NIL or a slot of
+ *  the slot directory.
+ *
+ * Returns:
+ *  TRUE if the slot can be trusted, otherwise FALSE
+ */
+static Boolean eduom_IsFreeSlot(
+    SlottedPage	*apage,		/* IN page of the slot */
+    Two		slotNo)		/* IN slot taken from the list */
+{
+    Two         next;		/* link of the slot */
+
+
+    if (slotNo == NIL) return(TRUE);
+
+    if (slotNo < 0 || slotNo >= apage->header.nSlots || apage->slot[-slotNo].offset != EMPTYSLOT)
+        return(FALSE);
+
+    next = (Two)apage->slot[-slotNo].unique;
+
+    return((next == NIL || (next >= 0 && next < apage->header.nSlots)) ? TRUE : FALSE);
+
+} /* eduom_IsFreeSlot() */
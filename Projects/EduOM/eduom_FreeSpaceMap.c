@@ -0,0 +1,432 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : eduom_FreeSpaceMap.c
+ * 
+ * Description :
+ *  Maintain the free-space maps of the data files. A free-space map records
+ *  the free space of every page of a file (see FreeSpaceMap) and finds a
+ *  page having a given free space in O(log # of pages), the first such page
+ *  in the order the pages became known to the map.
+ *  The layout of the catalog entry is fixed, so the maps are kept in memory
+ *  in a directory keyed by the catalog object of the file; the map of a file
+ *  is built from the list of its pages when the file is first used. The map
+ *  is a hint: a page it returns is checked, and corrected if someone else
+ *  changed the page behind its back. In particular a page deallocated by a
+ *  caller not going through the map still carries the file ID of the file,
+ *  so a page is taken only while it is still linked into the page list of
+ *  the file.
+ *
+ * Exports:
+ *  Four eduom_FsmSearch(ObjectID*, sm_CatOverlayForData*, Four, PageID*)
+ *  Four eduom_FsmUpdate(ObjectID*, sm_CatOverlayForData*, PageID*, Four)
+ */
+
+
+#include <stdlib.h>
+#include "EduOM_common.h"
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+
+
+
+/*@
+ * Global Variables
+ */
+/* the directory of the free-space maps */
+static FreeSpaceMap *eduom_fsmDirectory = NULL;
+
+
+
+/*@ Internal Function Prototypes */
+static Four eduom_FsmLookUp(ObjectID*, sm_CatOverlayForData*, FreeSpaceMap**);
+static Four eduom_FsmGrow(FreeSpaceMap*);
+static Four eduom_FsmLeaf(FreeSpaceMap*, ShortPageID);
+static void eduom_FsmSet(FreeSpaceMap*, Four, Four);
+
+
+
+/*@================================
+ * eduom_FsmSearch()
+ *================================*/
+/*
+ * Function: Four eduom_FsmSearch(ObjectID*, sm_CatOverlayForData*, Four, PageID*)
+ * 
+ * Description :
+ *  Find a page of the file having at least 'neededSpace' bytes free.
+ *  The page found is read to check it; if it turns out to have less space
+ *  or not to belong to the file any more (see eduom_IsPageOfFile()), the map
+ *  is corrected and the search is repeated.
+ *
+ * Returns:
+ *  1) TRUE if a page is found, FALSE otherwise
+ *  2) Error codes: Negative value means error code.
+ *     some errors caused by function calls
+ *
+ * Side effects:
+ *  1) parameter pid
+ *     the page found
+ */
+Four eduom_FsmSearch(
+    ObjectID	*catObjForFile,	/* IN file to be searched */
+    sm_CatOverlayForData *catEntry, /* IN catalog entry of the file */
+    Four	neededSpace,	/* IN free space needed */
+    PageID	*pid)		/* OUT page found */
+{
+    Four        e;		/* error number */
+    Four        i;		/* node of the tree */
+    Four        need;		/* category needed */
+    Four        freeSpace;	/* free space of the page found */
+    FreeSpaceMap *fsm;		/* free-space map of the file */
+    SlottedPage *apage;		/* pointer to the buffer holding the page found */
+
+
+    e = eduom_FsmLookUp(catObjForFile, catEntry, &fsm);
+    if (e < 0) ERR(e);
+
+    need = FSM_NEEDED_CATEGORY(neededSpace);
+
+    while (fsm->tree[1] >= need) {
+
+        /*@ descend to the leftmost leaf with the needed category */
+        for (i = 1; i < fsm->capacity; )
+            i = (fsm->tree[2*i] >= need) ? 2*i : 2*i+1;
+        i -= fsm->capacity;
+
+        MAKE_PAGEID(*pid, catEntry->fid.volNo, fsm->pageNo[i]);
+
+        e = BfM_GetTrain((TrainID *)pid, (char **)&apage, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        e = eduom_IsPageOfFile(catEntry, pid, apage);
+        if (e < 0) ERRB1(e, pid, PAGE_BUF);
+        freeSpace = (e == TRUE) ? SP_FREE(apage) : 0;
+
+        e = BfM_FreeTrain((TrainID *)pid, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        if (freeSpace >= neededSpace) return( TRUE );
+
+        eduom_FsmSet(fsm, i, freeSpace);
+    }
+
+    return( FALSE );
+
+} /* eduom_FsmSearch() */
+
+
+
+/*@================================
+ * eduom_FsmUpdate()
+ *================================*/
+/*
+ * Function: Four eduom_FsmUpdate(ObjectID*, sm_CatOverlayForData*, PageID*, Four)
+ * 
+ * Description :
+ *  Record that the page 'pid' of the file has 'freeSpace' bytes free.
+ *  A page deallocated from the file is recorded with no free space.
+ *  The caller takes 'freeSpace' from the page while it keeps the page
+ *  fixed, and marks the page dirty before unfixing it, so the map agrees
+ *  with the page when it is read again after eviction; the check of
+ *  eduom_FsmSearch() is for changes made by others, not for these.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_FsmUpdate(
+    ObjectID	*catObjForFile,	/* IN file containing the page */
+    sm_CatOverlayForData *catEntry, /* IN catalog entry of the file */
+    PageID	*pid,		/* IN page whose free space changed */
+    Four	freeSpace)	/* IN free space of the page */
+{
+    Four        e;		/* error number */
+    Four        leaf;		/* leaf of the page */
+    FreeSpaceMap *fsm;		/* free-space map of the file */
+
+
+    e = eduom_FsmLookUp(catObjForFile, catEntry, &fsm);
+    if (e < 0) ERR(e);
+
+    leaf = eduom_FsmLeaf(fsm, pid->pageNo);
+    if (leaf < 0) ERR(leaf);
+
+    eduom_FsmSet(fsm, leaf, freeSpace);
+
+    return(eNOERROR);
+
+} /* eduom_FsmUpdate() */
+
+
+
+/*@================================
+ * eduom_FsmLookUp()
+ *================================*/
+/*
+ * Function: Four eduom_FsmLookUp(ObjectID*, sm_CatOverlayForData*, FreeSpaceMap**)
+ * 
+ * Description :
+ *  Find the free-space map of the file in the directory. If the file has
+ *  none yet, or the map was built for another file which had the same
+ *  catalog object before, build it by reading every page of the file.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR_EDUOM
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  1) parameter fsm
+ *     free-space map of the file
+ */
+static Four eduom_FsmLookUp(
+    ObjectID	*catObjForFile,	/* IN file whose map is wanted */
+    sm_CatOverlayForData *catEntry, /* IN catalog entry of the file */
+    FreeSpaceMap **fsm)		/* OUT free-space map of the file */
+{
+    Four        e;		/* error number */
+    Four        leaf;		/* leaf of a page */
+    PageID      pid;		/* page of the file */
+    ShortPageID nextPage;	/* next page of the file */
+    SlottedPage *apage;		/* pointer to the buffer holding a page */
+    FreeSpaceMap *map;		/* free-space map */
+
+
+    for (map = eduom_fsmDirectory; map != NULL; map = map->next)
+        if (map->catObj.pageNo == catObjForFile->pageNo && map->catObj.volNo == catObjForFile->volNo &&
+            map->catObj.slotNo == catObjForFile->slotNo && map->catObj.unique == catObjForFile->unique)
+            break;
+
+    if (map != NULL && EQUAL_FILEID(map->fid, catEntry->fid)) {
+        *fsm = map;
+        return(eNOERROR);
+    }
+
+    if (map == NULL) {
+        map = (FreeSpaceMap *)calloc(1, sizeof(FreeSpaceMap));
+        if (map == NULL) ERR(eMEMORYALLOCERR_EDUOM);
+
+        map->catObj = *catObjForFile;
+        map->next = eduom_fsmDirectory;
+        eduom_fsmDirectory = map;
+    }
+    else {
+        /* the map is stale; start over */
+        free(map->tree);
+        free(map->pageNo);
+        free(map->hash);
+        map->nPages = map->capacity = 0;
+        map->tree = NULL;
+        map->pageNo = NULL;
+        map->hash = NULL;
+    }
+
+    e = eduom_FsmGrow(map);
+    if (e < 0) ERR(e);
+
+    /*@ record the free space of every page of the file */
+    for (nextPage = catEntry->firstPage; nextPage != NIL; nextPage = apage->header.nextPage) {
+        MAKE_PAGEID(pid, catEntry->fid.volNo, nextPage);
+
+        e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        leaf = eduom_FsmLeaf(map, pid.pageNo);
+        if (leaf < 0) ERRB1(leaf, &pid, PAGE_BUF);
+        eduom_FsmSet(map, leaf, SP_FREE(apage));
+
+        e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+        if (e < 0) ERR(e);
+    }
+
+    /* the map is valid only when it is complete */
+    map->fid = catEntry->fid;
+
+    *fsm = map;
+
+    return(eNOERROR);
+
+} /* eduom_FsmLookUp() */
+
+
+
+/*@================================
+ * eduom_FsmGrow()
+ *================================*/
+/*
+ * Function: Four eduom_FsmGrow(FreeSpaceMap*)
+ * 
+ * Description :
+ *  Double the capacity of the free-space map (or give an empty map its
+ *  initial capacity), rebuilding the tree and the hash table of the pages.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR_EDUOM
+ */
+static Four eduom_FsmGrow(
+    FreeSpaceMap *fsm)		/* INOUT free-space map */
+{
+    Four        i;		/* node of the tree */
+    Four        h;		/* entry of the hash table */
+    Four        capacity;	/* new capacity */
+    UOne        *tree;		/* new tree */
+    ShortPageID *pageNo;	/* new pages of the leaves */
+    Four        *hash;		/* new hash table */
+
+
+    capacity = (fsm->capacity == 0) ? FSM_INITIAL_CAPACITY : 2 * fsm->capacity;
+
+    tree = (UOne *)calloc(2 * capacity, sizeof(UOne));
+    pageNo = (ShortPageID *)malloc(capacity * sizeof(ShortPageID));
+    hash = (Four *)malloc(2 * capacity * sizeof(Four));
+    if (tree == NULL || pageNo == NULL || hash == NULL) {
+        free(tree);
+        free(pageNo);
+        free(hash);
+        ERR(eMEMORYALLOCERR_EDUOM);
+    }
+
+    for (h = 0; h < 2 * capacity; h++) hash[h] = NIL;
+
+    for (i = 0; i < fsm->nPages; i++) {
+        tree[capacity + i] = fsm->tree[fsm->capacity + i];
+        pageNo[i] = fsm->pageNo[i];
+
+        for (h = (UFour)pageNo[i] % (2 * capacity); hash[h] != NIL; h = (h + 1) % (2 * capacity));
+        hash[h] = i;
+    }
+    for (i = capacity - 1; i >= 1; i--) tree[i] = MAX(tree[2*i], tree[2*i+1]);
+
+    free(fsm->tree);
+    free(fsm->pageNo);
+    free(fsm->hash);
+
+    fsm->capacity = capacity;
+    fsm->tree = tree;
+    fsm->pageNo = pageNo;
+    fsm->hash = hash;
+
+    return(eNOERROR);
+
+} /* eduom_FsmGrow() */
+
+
+
+/*@================================
+ * eduom_FsmLeaf()
+ *================================*/
+/*
+ * Function: Four eduom_FsmLeaf(FreeSpaceMap*, ShortPageID)
+ * 
+ * Description :
+ *  Return the leaf of the page 'pageNo', adding a leaf with no free space
+ *  if the page is not in the map yet. Leaves are never removed; a page
+ *  leaving the file keeps its leaf with no free space.
+ *
+ * Returns:
+ *  1) leaf of the page
+ *  2) Error codes: Negative value means error code.
+ *     eMEMORYALLOCERR_EDUOM
+ */
+static Four eduom_FsmLeaf(
+    FreeSpaceMap *fsm,		/* INOUT free-space map */
+    ShortPageID	pageNo)		/* IN page */
+{
+    Four        e;		/* error number */
+    Four        h;		/* entry of the hash table */
+
+
+    for (h = (UFour)pageNo % (2 * fsm->capacity); fsm->hash[h] != NIL; h = (h + 1) % (2 * fsm->capacity))
+        if (fsm->pageNo[fsm->hash[h]] == pageNo) return(fsm->hash[h]);
+
+    if (fsm->nPages == fsm->capacity) {
+        e = eduom_FsmGrow(fsm);
+        if (e < 0) ERR(e);
+
+        for (h = (UFour)pageNo % (2 * fsm->capacity); fsm->hash[h] != NIL; h = (h + 1) % (2 * fsm->capacity));
+    }
+
+    fsm->hash[h] = fsm->nPages;
+    fsm->pageNo[fsm->nPages] = pageNo;
+
+    return(fsm->nPages++);
+
+} /* eduom_FsmLeaf() */
+
+
+
+/*@================================
+ * eduom_FsmSet()
+ *================================*/
+/*
+ * Function: void eduom_FsmSet(FreeSpaceMap*, Four, Four)
+ * 
+ * Description :
+ *  Record the free space 'freeSpace' in the leaf 'leaf' and update the
+ *  maxima on the path to the root.
+ *
+ * Returns:
+ *  None
+ */
+static void eduom_FsmSet(
+    FreeSpaceMap *fsm,		/* INOUT free-space map */
+    Four	leaf,		/* IN leaf to be set */
+    Four	freeSpace)	/* IN free space of the page of the leaf */
+{
+    Four        i;		/* node of the tree */
+
+
+    i = fsm->capacity + leaf;
+    fsm->tree[i] = FSM_CATEGORY(freeSpace);
+
+    for (i /= 2; i >= 1; i /= 2)
+        fsm->tree[i] = MAX(fsm->tree[2*i], fsm->tree[2*i+1]);
+
+} /* eduom_FsmSet() */
@@ -0,0 +1,460 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : eduom_Pax.c
+ * 
+ * Description :
+ *  The routines handling the pages of the PAX layout, in which the objects
+ *  of a file are records of fixed-length columns kept in column minipages.
+ *
+ * Exports:
+ *  Four eduom_PaxFormatPage(SlottedPage*, Four, Two*)
+ *  Four eduom_PaxCreateObject(ObjectID*, sm_CatOverlayForData*, PageID*, Four, char*, ObjectID*)
+ *  Four eduom_PaxReadObject(SlottedPage*, Two, Four, Four, char*)
+ *  Four eduom_PaxWriteObject(SlottedPage*, Two, Four, Four, char*)
+ *  void eduom_PaxRemoveRecord(SlottedPage*, Two)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "RDsM.h"		/* for the raw disk manager call */
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+
+
+
+/*@ Internal Function Prototypes */
+static Four eduom_PaxLayOutMinipages(SlottedPage*, Four);
+static Four eduom_PaxCopy(SlottedPage*, Two, Four, Four, char*, Boolean);
+
+
+
+/*@================================
+ * eduom_PaxFormatPage()
+ *================================*/
+/*
+ * Function: Four eduom_PaxFormatPage(SlottedPage*, Four, Two*)
+ * 
+ * Description :
+ *  Format the page as an empty page of the PAX layout whose records have
+ *  'nColumns' columns of the given widths. The page holds as many records
+ *  as fit with their slots; the minipage of a column starts on a multiple
+ *  of PAX_MINIPAGE_ALIGN bytes from the start of the page.
+ *  The header of the slotted page other than 'flags', 'reserved', 'nSlots',
+ *  'free', and 'unused' is not changed.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    eBADLENGTH_OM
+ */
+Four eduom_PaxFormatPage(
+    SlottedPage	*apage,		/* INOUT page to format */
+    Four	nColumns,	/* IN # of columns of a record */
+    Two		*widths)	/* IN width of each column */
+{
+    PaxPageHdr  *paxHdr;	/* header of the data area */
+    Four        recordLength;	/* length of a record */
+    Four        capacity;	/* # of records the page can hold */
+    Four        i;		/* index variable */
+
+
+    if (nColumns < 1 || nColumns > PAX_MAX_COLUMNS || widths == NULL) ERR(eBADPARAMETER_OM);
+
+    paxHdr = PAX_HDR(apage);
+
+    recordLength = 0;
+    for (i = 0; i < nColumns; i++) {
+        if (widths[i] < 1) ERR(eBADLENGTH_OM);
+        recordLength += widths[i];
+        paxHdr->width[i] = widths[i];
+    }
+    if (recordLength > LRGOBJ_THRESHOLD) ERR(eBADLENGTH_OM);
+
+    paxHdr->nColumns = nColumns;
+    paxHdr->recordLength = recordLength;
+    paxHdr->nRecords = 0;
+
+    /*@ find the largest # of records whose minipages and slots fit */
+    capacity = (PAGESIZE - SP_FIXED - sizeof(PaxPageHdr)) / (recordLength + sizeof(SlottedPageSlot)) + 1;
+    while (capacity > 0 &&
+           eduom_PaxLayOutMinipages(apage, capacity) + (capacity-1)*(Four)sizeof(SlottedPageSlot) > PAGESIZE - SP_FIXED)
+        capacity--;
+    if (capacity == 0) ERR(eBADLENGTH_OM);
+
+    eduom_PaxLayOutMinipages(apage, capacity);
+    paxHdr->capacity = capacity;
+
+    apage->header.flags |= SP_PAX_LAYOUT;
+    apage->header.nSlots = 0;
+    SP_SET_FREESLOT_HEAD(apage, NIL);
+    PAX_SET_FULL(apage);
+
+    return(eNOERROR);
+
+} /* eduom_PaxFormatPage() */
+
+
+
+/*@================================
+ * eduom_PaxCreateObject()
+ *================================*/
+/*
+ * Function: Four eduom_PaxCreateObject(ObjectID*, sm_CatOverlayForData*, PageID*, Four, char*, ObjectID*)
+ * 
+ * Description :
+ *  Create a new object of the file of the PAX layout as a record of the
+ *  page 'nearPid'. If the page is full, a new page of the same layout is
+ *  allocated and inserted after it in the list of pages of the file.
+ *  The catalog object of the file is fixed by the caller.
+ *
+ * Returns:
+ *  error code
+ *    eBADLENGTH_OM
+ *    some errors caused by function calls
+ *
+ * Side Effects :
+ *  1) parameter oid
+ *     oid is set to the ObjectID of the new object
+ */
+Four eduom_PaxCreateObject(
+    ObjectID	*catObjForFile,	/* IN file in which object is to be placed */
+    sm_CatOverlayForData *catEntry, /* IN catalog entry of the file */
+    PageID	*nearPid,	/* IN page of the file to place the object in */
+    Four	length,		/* IN amount of data; the length of a record */
+    char	*data,		/* IN the initial data for the object */
+    ObjectID	*oid)		/* OUT the object's ObjectID */
+{
+    Four        e;		/* error number */
+    PageID      pid;		/* page in which the new object is placed */
+    SlottedPage *apage;		/* pointer to the buffer holding the page */
+    SlottedPage *nearPage;	/* pointer to the buffer holding the near page */
+    PaxPageHdr  *paxHdr;	/* header of the data area */
+    Four        firstExt;	/* first Extent No of the file */
+    PhysicalFileID pFid;	/* physical ID of file */
+    Two         slotNo;		/* slot of the new object */
+
+
+    e = BfM_GetTrain((TrainID *)nearPid, (char **)&nearPage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    paxHdr = PAX_HDR(nearPage);
+    if (length != paxHdr->recordLength) ERRB1(eBADLENGTH_OM, nearPid, PAGE_BUF);
+
+    if (paxHdr->nRecords < paxHdr->capacity) {
+        pid = *nearPid;
+        apage = nearPage;
+    }
+    else {
+        /*@ a new page of the same layout follows the full page */
+        MAKE_PHYSICALFILEID(pFid, catEntry->fid.volNo, catEntry->firstPage);
+        e = RDsM_PageIdToExtNo((PageID *)&pFid, &firstExt);
+        if (e < 0) ERRB1(e, nearPid, PAGE_BUF);
+
+        e = RDsM_AllocTrains(catEntry->fid.volNo, firstExt, nearPid, catEntry->eff, 1, PAGESIZE2, &pid);
+        if (e < 0) ERRB1(e, nearPid, PAGE_BUF);
+
+        e = BfM_GetNewTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+        if (e < 0) ERRB1(e, nearPid, PAGE_BUF);
+
+        apage->header.pid = pid;
+        apage->header.flags = SLOTTED_PAGE_TYPE;
+        apage->header.fid = catEntry->fid;
+        e = eduom_PaxFormatPage(apage, paxHdr->nColumns, paxHdr->width);
+        if (e >= 0) e = om_FileMapAddPage(catObjForFile, nearPid, &pid);
+        if (e < 0) {
+            BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+            ERRB1(e, nearPid, PAGE_BUF);
+        }
+        eduom_InvalidateCatalogEntry(catObjForFile);
+
+        e = BfM_FreeTrain((TrainID *)nearPid, PAGE_BUF);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+        paxHdr = PAX_HDR(apage);
+    }
+
+    /*@ reuse an empty slot, or add one */
+    slotNo = eduom_AllocSlot(apage);
+    if (slotNo == apage->header.nSlots)
+        apage->header.nSlots++;
+
+    apage->slot[-slotNo].offset = paxHdr->nRecords++;
+    e = om_GetUnique(&pid, &(apage->slot[-slotNo].unique));
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    eduom_PaxCopy(apage, slotNo, 0, length, data, TRUE);
+    PAX_SET_FULL(apage);
+
+    e = BfM_SetDirty((TrainID *)&pid, PAGE_BUF);
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    /* the page is recorded in the free-space map as having no free space */
+    e = eduom_FsmUpdate(catObjForFile, catEntry, &pid, SP_FREE(apage));
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    MAKE_OBJECTID(*oid, pid.volNo, pid.pageNo, slotNo, apage->slot[-slotNo].unique);
+
+    e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* eduom_PaxCreateObject() */
+
+
+
+/*@================================
+ * eduom_PaxReadObject()
+ *================================*/
+/*
+ * Function: Four eduom_PaxReadObject(SlottedPage*, Two, Four, Four, char*)
+ * 
+ * Description :
+ *  Gather the 'length' bytes from 'start' of the record of the slot
+ *  'slotNo' from the minipages of the page into 'buf'. If 'length' is
+ *  REMAINDER, the bytes from 'start' to the end of the record are read.
+ *
+ * Returns:
+ *  1) number of bytes actually read (values greater than or equal to 0)
+ *  2) Error Code (negative values)
+ *    eBADSTART_OM
+ */
+Four eduom_PaxReadObject(
+    SlottedPage	*apage,		/* IN page of the PAX layout */
+    Two		slotNo,		/* IN slot of the object */
+    Four	start,		/* IN starting offset of read */
+    Four	length,		/* IN amount of data to read */
+    char	*buf)		/* OUT user buffer to return the read data */
+{
+    Four        recordLength = PAX_HDR(apage)->recordLength;
+
+
+    if (start < 0 || start > recordLength) ERR(eBADSTART_OM);
+
+    if (length == REMAINDER || start + length > recordLength)
+        length = recordLength - start;
+
+    return(eduom_PaxCopy(apage, slotNo, start, length, buf, FALSE));
+
+} /* eduom_PaxReadObject() */
+
+
+
+/*@================================
+ * eduom_PaxWriteObject()
+ *================================*/
+/*
+ * Function: Four eduom_PaxWriteObject(SlottedPage*, Two, Four, Four, char*)
+ * 
+ * Description :
+ *  Scatter 'data' over the 'length' bytes from 'start' of the record of
+ *  the slot 'slotNo' in the minipages of the page. If 'length' is
+ *  REMAINDER, the bytes from 'start' to the end of the record are written;
+ *  a record does not grow. The page is not set dirty.
+ *
+ * Returns:
+ *  1) number of bytes actually written (values greater than or equal to 0)
+ *  2) Error Code (negative values)
+ *    eBADSTART_OM
+ */
+Four eduom_PaxWriteObject(
+    SlottedPage	*apage,		/* INOUT page of the PAX layout */
+    Two		slotNo,		/* IN slot of the object */
+    Four	start,		/* IN starting offset of write */
+    Four	length,		/* IN amount of data to write */
+    char	*data)		/* IN data to write */
+{
+    Four        recordLength = PAX_HDR(apage)->recordLength;
+
+
+    if (start < 0 || start > recordLength) ERR(eBADSTART_OM);
+
+    if (length == REMAINDER || start + length > recordLength)
+        length = recordLength - start;
+
+    return(eduom_PaxCopy(apage, slotNo, start, length, data, TRUE));
+
+} /* eduom_PaxWriteObject() */
+
+
+
+/*@================================
+ * eduom_PaxRemoveRecord()
+ *================================*/
+/*
+ * Function: void eduom_PaxRemoveRecord(SlottedPage*, Two)
+ * 
+ * Description :
+ *  Remove the record of the slot 'slotNo' from the page, moving the last
+ *  record of the page into its place so that the minipages stay dense; the
+ *  slot of the moved record is pointed to its new place. The slot
+ *  'slotNo' itself is left to the caller.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_PaxRemoveRecord(
+    SlottedPage	*apage,		/* INOUT page of the PAX layout */
+    Two		slotNo)		/* IN slot of the record to remove */
+{
+    PaxPageHdr  *paxHdr = PAX_HDR(apage);
+    Two         record;		/* record to remove */
+    Two         last;		/* last record of the page */
+    Four        i;		/* index variable */
+
+
+    record = apage->slot[-slotNo].offset;
+    last = --paxHdr->nRecords;
+
+    if (record == last) return;
+
+    for (i = 0; i < paxHdr->nColumns; i++)
+        memcpy(&apage->data[paxHdr->offset[i] + record*paxHdr->width[i]],
+               &apage->data[paxHdr->offset[i] + last*paxHdr->width[i]], paxHdr->width[i]);
+
+    for (i = 0; i < apage->header.nSlots; i++)
+        if (apage->slot[-i].offset == last) {
+            apage->slot[-i].offset = record;
+            break;
+        }
+
+} /* eduom_PaxRemoveRecord() */
+
+
+
+/*@================================
+ * eduom_PaxLayOutMinipages()
+ *================================*/
+/*
+ * Function: static Four eduom_PaxLayOutMinipages(SlottedPage*, Four)
+ * 
+ * Description :
+ *  Set the offsets of the minipages of the columns in the header of the
+ *  data area for a page holding 'capacity' records.
+ *
+ * Returns:
+ *  the end of the last minipage in the data area
+ */
+static Four eduom_PaxLayOutMinipages(
+    SlottedPage	*apage,		/* INOUT page of the PAX layout */
+    Four	capacity)	/* IN # of records the page holds */
+{
+    PaxPageHdr  *paxHdr = PAX_HDR(apage);
+    Four        base;		/* offset of the data area in the page */
+    Four        end;		/* end of the minipages laid out so far */
+    Four        i;		/* index variable */
+
+
+    base = (Four)((char *)apage->data - (char *)apage);
+
+    end = sizeof(PaxPageHdr);
+    for (i = 0; i < paxHdr->nColumns; i++) {
+        end = (base + end + PAX_MINIPAGE_ALIGN - 1) / PAX_MINIPAGE_ALIGN * PAX_MINIPAGE_ALIGN - base;
+        paxHdr->offset[i] = end;
+        end += capacity * paxHdr->width[i];
+    }
+
+    return(end);
+
+} /* eduom_PaxLayOutMinipages() */
+
+
+
+/*@================================
+ * eduom_PaxCopy()
+ *================================*/
+/*
+ * Function: static Four eduom_PaxCopy(SlottedPage*, Two, Four, Four, char*, Boolean)
+ * 
+ * Description :
+ *  Copy the 'length' bytes from 'start' of the record of the slot 'slotNo'
+ *  between the minipages of the page and 'buf': into the page if 'toPage'
+ *  is TRUE, otherwise out of the page. Only the columns overlapping the
+ *  range are touched.
+ *
+ * Returns:
+ *  the number of bytes copied
+ */
+static Four eduom_PaxCopy(
+    SlottedPage	*apage,		/* INOUT page of the PAX layout */
+    Two		slotNo,		/* IN slot of the record */
+    Four	start,		/* IN starting offset in the record */
+    Four	length,		/* IN amount of data to copy */
+    char	*buf,		/* INOUT data copied */
+    Boolean	toPage)		/* IN TRUE to copy into the page */
+{
+    PaxPageHdr  *paxHdr = PAX_HDR(apage);
+    Two         record;		/* record of the slot */
+    Four        colStart;	/* offset of the column in the record */
+    Four        from, to;	/* range of the column to copy */
+    char        *value;		/* value of the column in its minipage */
+    Four        i;		/* index variable */
+
+
+    record = apage->slot[-slotNo].offset;
+
+    colStart = 0;
+    for (i = 0; i < paxHdr->nColumns && colStart < start + length; colStart += paxHdr->width[i++]) {
+        if (colStart + paxHdr->width[i] <= start) continue;
+
+        from = MAX(start, colStart);
+        to = (colStart + paxHdr->width[i] < start + length) ? colStart + paxHdr->width[i] : start + length;
+        value = &apage->data[paxHdr->offset[i] + record*paxHdr->width[i]];
+
+        if (toPage)
+            memcpy(&value[from - colStart], &buf[from - start], to - from);
+        else
+            memcpy(&buf[from - start], &value[from - colStart], to - from);
+    }
+
+    return(length);
+
+} /* eduom_PaxCopy() */
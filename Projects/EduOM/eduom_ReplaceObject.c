@@ -0,0 +1,162 @@
+/******************************************************************************/
+/*                                                                            */
+/*    Copyright (c) 2013-2015, Kyu-Young Whang, KAIST                         */
+/*    All rights reserved.                                                    */
+/*                                                                            */
+/*    Redistribution and use in source and binary forms, with or without      */
+/*    modification, are permitted provided that the following conditions      */
+/*    are met:                                                                */
+/*                                                                            */
+/*    1. Redistributions of source code must retain the above copyright       */
+/*       notice, this list of conditions and the following disclaimer.        */
+/*                                                                            */
+/*    2. Redistributions in binary form must reproduce the above copyright    */
+/*       notice, this list of conditions and the following disclaimer in      */
+/*       the documentation and/or other materials provided with the           */
+/*       distribution.                                                        */
+/*                                                                            */
+/*    3. Neither the name of the copyright holder nor the names of its        */
+/*       contributors may be used to endorse or promote products derived      */
+/*       from this software without specific prior written permission.        */
+/*                                                                            */
+/*    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS     */
+/*    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT       */
+/*    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS       */
+/*    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE          */
+/*    COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,    */
+/*    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;        */
+/*    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER        */
+/*    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT      */
+/*    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN       */
+/*    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE         */
+/*    POSSIBILITY OF SUCH DAMAGE.                                             */
+/*                                                                            */
+/******************************************************************************/
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational Purpose Object Storage System            */
+/*    (Version 1.0)                                                           */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: odysseus.educosmos@gmail.com                                    */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : eduom_ReplaceObject.c
+ * 
+ * Description :
+ *  eduom_ReplaceObject() replaces the data of a small object within its
+ *  page.
+ *
+ * Exports:
+ *  Four eduom_ReplaceObject(ObjectID*, sm_CatOverlayForData*, ObjectID*, Two, Four, char*)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+#include "EduOM.h"
+
+
+
+/*@================================
+ * eduom_ReplaceObject()
+ *================================*/
+/*
+ * Function: Four eduom_ReplaceObject(ObjectID*, sm_CatOverlayForData*, ObjectID*, Two, Four, char*)
+ * 
+ * Description :
+ *  Replace the data of the small object 'oid' with the 'length' bytes of
+ *  'data' and its properties with 'properties', keeping the object in its
+ *  slot. The new data is written over the old one when it is not longer;
+ *  otherwise the object grows into the free space of the page, and the page
+ *  is compacted moving the object to the end if the free space following
+ *  the object is too small. Nothing is changed if the page has no room for
+ *  the new data. 'data' must not point into the page of the object.
+ *
+ * Returns:
+ *  1) TRUE if the object is replaced, FALSE if the page has no room
+ *  2) Error codes: Negative value means error code.
+ *    eBADOBJECTID_OM
+ *    some errors caused by function calls
+ */
+Four eduom_ReplaceObject(
+    ObjectID	*catObjForFile,	/* IN file containing the object */
+    sm_CatOverlayForData *catEntry, /* IN catalog entry of the file */
+    ObjectID	*oid,		/* IN object to replace */
+    Two		properties,	/* IN new properties of the object */
+    Four	length,		/* IN amount of new data */
+    char	*data)		/* IN new data */
+{
+    Four        e;		/* error number */
+    PageID      pid;		/* page on which the object resides */
+    SlottedPage *apage;		/* pointer to the buffer holding the page */
+    Object      *obj;		/* points to the object in data area */
+    Four        offset;		/* start offset of object in data area */
+    Four        alignedLen;	/* aligned length of the object data */
+    Four        newAlignedLen;	/* aligned length of the new data */
+
+
+    if (ALIGNED_LENGTH(length) > LRGOBJ_THRESHOLD) return(FALSE);
+
+    MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
+
+    e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    if (oid->slotNo < 0 || oid->slotNo >= apage->header.nSlots || !IS_VALID_OBJECTID(oid, apage))
+        ERRB1(eBADOBJECTID_OM, &pid, PAGE_BUF);
+
+    offset = apage->slot[-(oid->slotNo)].offset;
+    obj = (Object *)&(apage->data[offset]);
+    alignedLen = DATA_LENGTH_IN_PAGE(obj->header.length);
+    newAlignedLen = DATA_LENGTH_IN_PAGE(length);
+
+    if (newAlignedLen > alignedLen && newAlignedLen - alignedLen > SP_FREE(apage)) {
+        e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        return(FALSE);
+    }
+
+    e = om_RemoveFromAvailSpaceList(catObjForFile, &pid, apage);
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    if (newAlignedLen <= alignedLen) {
+        /* the space of the tail goes back as an object being destroyed */
+        if (offset + sizeof(ObjectHdr) + alignedLen == apage->header.free)
+            apage->header.free -= alignedLen - newAlignedLen;
+        else
+            apage->header.unused += alignedLen - newAlignedLen;
+    }
+    else {
+        if (offset + sizeof(ObjectHdr) + alignedLen != apage->header.free ||
+            newAlignedLen - alignedLen > SP_CFREE(apage)) {
+            EduOM_CompactPage(apage, oid->slotNo);
+            obj = (Object *)&(apage->data[apage->slot[-(oid->slotNo)].offset]);
+        }
+        apage->header.free += newAlignedLen - alignedLen;
+    }
+
+    if (length > 0) memcpy(obj->data, data, length);
+    obj->header.properties = properties;
+    obj->header.length = length;
+
+    e = om_PutInAvailSpaceList(catObjForFile, &pid, apage);
+    if (e >= 0) e = eduom_FsmUpdate(catObjForFile, catEntry, &pid, SP_FREE(apage));
+    if (e >= 0) e = BfM_SetDirty((TrainID *)&pid, PAGE_BUF);
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(TRUE);
+    
+} /* eduom_ReplaceObject() */